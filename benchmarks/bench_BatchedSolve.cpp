@@ -0,0 +1,122 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Compares solve_batched() with a loop of solve() calls, one per system,
+// for CG, BiCGSTAB and GMRES on batches of small dense systems.
+//
+//     bench_batched [count]
+//
+// count is the number of systems per batch (default 100000). The systems
+// are shifted 1D Laplacians with random perturbations, so every system
+// needs a slightly different number of iterations. Both variants run on
+// the same number of threads: the loop is parallelized with OpenMP like
+// the chunks of the batched solve.
+
+#include "BlazeIterative.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace blaze;
+using namespace blaze::iterative;
+
+namespace {
+
+// Seconds of the fastest of three runs of f
+template<typename F>
+double seconds(F f)
+{
+    double best = 1e300;
+    for(int run=0; run<3; ++run) {
+        const auto begin = std::chrono::steady_clock::now();
+        f();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+template<typename TagType>
+void benchmark(const char *name, TagType tag, std::size_t count, std::size_t n)
+{
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<double> perturbation(-0.1, 0.1);
+
+    std::vector<DynamicMatrix<double>> matrices(count, DynamicMatrix<double>(n, n, 0.0));
+    std::vector<DynamicVector<double>> rhs(count, DynamicVector<double>(n));
+    BatchedMatrix<double> A(count, n);
+    BatchedVector<double> b(count, n);
+    for(std::size_t k=0; k<count; ++k) {
+        DynamicMatrix<double> &Ak = matrices[k];
+        for(std::size_t i=0; i<n; ++i) {
+            Ak(i,i) = 2.5 + perturbation(generator);
+            if(i > 0) {
+                Ak(i,i-1) = Ak(i-1,i) = -1.0 + perturbation(generator);
+            }
+            rhs[k][i] = 1.0 + perturbation(generator);
+        }
+        A.setSystem(k, Ak);
+        b.setSystem(k, rhs[k]);
+    }
+
+    std::vector<DynamicVector<double>> looped(count);
+    const double loop = seconds([&]() {
+        #pragma omp parallel for schedule(static)
+        for(std::ptrdiff_t k=0; k<std::ptrdiff_t(count); ++k) {
+            TagType system_tag(tag);
+            looped[k] = solve(matrices[k], rhs[k], system_tag);
+        }
+    });
+
+    BatchedSolveStatus result;
+    BatchedVector<double> x(count, n);
+    const double batched = seconds([&]() {
+        x = solve_batched(A, b, tag, result);
+    });
+
+    double difference = 0.0;
+    for(std::size_t k=0; k<count; ++k) {
+        difference = std::max(difference, norm(x.system(k) - looped[k]) / norm(looped[k]));
+    }
+
+    std::cout << "  " << std::setw(9) << name << " n = " << std::setw(2) << n
+              << "  loop " << std::setw(9) << std::setprecision(4) << loop*1e3 << " ms"
+              << "  batched " << std::setw(9) << batched*1e3 << " ms"
+              << "  speedup " << std::setw(6) << loop/batched
+              << "  max difference " << std::setprecision(2) << difference << "\n";
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+
+    const std::size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    std::cout << count << " systems per batch\n";
+
+    for(std::size_t n : {4, 8, 16, 32}) {
+        ConjugateGradientTag cg;
+        cg.relativeResidualTolerance() = 1e-20;
+        cg.maximumIterations() = 100;
+        benchmark("CG", cg, count, n);
+
+        BiCGSTABTag bicgstab;
+        bicgstab.relativeResidualTolerance() = 1e-20;
+        bicgstab.maximumIterations() = 100;
+        benchmark("BiCGSTAB", bicgstab, count, n);
+
+        GMRESTag gmres;
+        gmres.relativeResidualTolerance() = 1e-10;
+        gmres.maximumIterations() = 100;
+        gmres.restart() = std::min<std::size_t>(n, 10);
+        benchmark("GMRES", gmres, count, n);
+    }
+
+    return 0;
+}
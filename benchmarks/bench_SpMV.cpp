@@ -0,0 +1,165 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Compares the sparse matrix-vector product and a CG solve with the matrix
+// in CSR (CompressedMatrix) and in SELL-C-sigma (SlicedEllpackOperator)
+// storage.
+//
+//     bench_spmv [matrix.mtx ...]
+//
+// Without arguments the matrix is the graph Laplacian of a triangulated
+// 2D mesh with randomly oriented diagonals and locally refined patches,
+// which gives the irregular row lengths of finite element meshes.
+
+#include "BlazeIterative.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace blaze;
+using namespace blaze::iterative;
+
+namespace {
+
+CompressedMatrix<double,rowMajor> mesh_matrix(std::size_t nx, std::size_t ny)
+{
+    const std::size_t n = nx*ny;
+    std::vector<std::set<std::size_t>> neighbours(n);
+    auto connect = [&neighbours](std::size_t a, std::size_t b) {
+        neighbours[a].insert(b);
+        neighbours[b].insert(a);
+    };
+
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> coin(0, 1);
+    std::uniform_int_distribution<std::size_t> node(0, n-1);
+    for(std::size_t j=0; j<ny; ++j) {
+        for(std::size_t i=0; i<nx; ++i) {
+            const std::size_t p = i + nx*j;
+            if(i+1 < nx) connect(p, p+1);
+            if(j+1 < ny) connect(p, p+nx);
+            if(i+1 < nx && j+1 < ny) {
+                coin(generator) ? connect(p, p+nx+1) : connect(p+1, p+nx);
+            }
+        }
+    }
+    // Refined patches: a few nodes coupled to many nodes around them
+    for(std::size_t k=0; k<n/200; ++k) {
+        const std::size_t p = node(generator);
+        for(std::size_t d=1; d<=24; ++d) {
+            connect(p, (p + d*nx/5 + d) % n);
+        }
+    }
+
+    std::size_t entries = n;
+    for(const auto &row : neighbours) {
+        entries += row.size();
+    }
+    CompressedMatrix<double,rowMajor> A(n, n);
+    A.reserve(entries);
+    for(std::size_t p=0; p<n; ++p) {
+        bool diagonal = false;
+        for(std::size_t q : neighbours[p]) {
+            if(!diagonal && q > p) {
+                A.append(p, p, neighbours[p].size() + 0.01);
+                diagonal = true;
+            }
+            A.append(p, q, -1.0);
+        }
+        if(!diagonal) {
+            A.append(p, p, neighbours[p].size() + 0.01);
+        }
+        A.finalize(p);
+    }
+    return A;
+}
+
+// Seconds per call of f, from the fastest of several batches
+template<typename F>
+double seconds(F f, std::size_t repetitions)
+{
+    double best = 1e300;
+    for(int batch=0; batch<5; ++batch) {
+        const auto begin = std::chrono::steady_clock::now();
+        for(std::size_t r=0; r<repetitions; ++r) {
+            f();
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+        best = std::min(best, elapsed.count() / repetitions);
+    }
+    return best;
+}
+
+template<typename Operator>
+double cg_seconds(const Operator &A, const DynamicVector<double> &b, std::size_t &iterations)
+{
+    ConjugateGradientTag tag;
+    tag.relativeResidualTolerance() = 1e-16;
+    tag.maximumIterations() = 1000;
+    tag.do_log() = true;
+    DynamicVector<double> x(b.size());
+    const double time = seconds([&]() {
+        reset(x);
+        solve_inplace(x, A, b, tag);
+    }, 1);
+    iterations = tag.convergence_history().size();
+    return time;
+}
+
+void benchmark(const std::string &name, const CompressedMatrix<double,rowMajor> &A)
+{
+    const SlicedEllpackOperator<double> S(A);
+
+    DynamicVector<double> x(A.columns());
+    for(std::size_t i=0; i<x.size(); ++i) {
+        x[i] = std::sin(0.01*i);
+    }
+    DynamicVector<double> y(A.rows());
+    const std::size_t repetitions = std::max<std::size_t>(1, 50000000 / (nonZeros(A) + 1));
+
+    const double csr = seconds([&]() { y = A * x; }, repetitions);
+    const double sell = seconds([&]() { multiply(y, S, x); }, repetitions);
+    const double gflops = 2e-9 * nonZeros(A);
+
+    std::cout << name << ": " << A.rows() << " rows, " << nonZeros(A) << " nonzeros, SELL-8-256 fill efficiency "
+              << std::setprecision(3) << double(S.nonZeros()) / S.storedEntries() << ", "
+              << 8 * S.indexBytes() << "-bit indices\n"
+              << "  SpMV CSR  " << std::setw(10) << csr*1e3 << " ms  " << gflops/csr << " GFLOP/s\n"
+              << "  SpMV SELL " << std::setw(10) << sell*1e3 << " ms  " << gflops/sell << " GFLOP/s"
+              << "  speedup " << csr/sell << "\n";
+
+    if(A.rows() == A.columns() && isSymmetric(A)) {
+        DynamicVector<double> b(A.rows(), 1.0);
+        std::size_t iterations_csr = 0;
+        std::size_t iterations_sell = 0;
+        const double cg_csr = cg_seconds(A, b, iterations_csr);
+        const double cg_sell = cg_seconds(S, b, iterations_sell);
+        std::cout << "  CG CSR    " << std::setw(10) << cg_csr*1e3 << " ms  (" << iterations_csr << " iterations)\n"
+                  << "  CG SELL   " << std::setw(10) << cg_sell*1e3 << " ms  (" << iterations_sell << " iterations)"
+                  << "  speedup " << cg_csr/cg_sell << "\n";
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+
+    if(argc < 2) {
+        benchmark("mesh 300 x 300", mesh_matrix(300, 300));
+        benchmark("mesh 1000 x 1000", mesh_matrix(1000, 1000));
+    }
+    for(int k=1; k<argc; ++k) {
+        benchmark(argv[k], read_matrix_market<double>(argv[k]));
+    }
+
+    return 0;
+}
@@ -9,7 +9,20 @@
 
 #include <BlazeIterative/IterativeCommon.hpp>
 #include <BlazeIterative/IterativeTag.hpp>
+#include <BlazeIterative/Trace.hpp>
 #include <BlazeIterative/solve.hpp>
+#include <BlazeIterative/Solver.hpp>
+#include <BlazeIterative/BatchSolve.hpp>
+#include <BlazeIterative/BatchedSolve.hpp>
+#include <BlazeIterative/InitialGuess.hpp>
+#include <BlazeIterative/io/MatrixMarket.hpp>
+#include <BlazeIterative/io/BinaryCSR.hpp>
+#include <BlazeIterative/operators/SlicedEllpackOperator.hpp>
+#include <BlazeIterative/operators/ShiftInvertOperator.hpp>
+#include <BlazeIterative/operators/StencilOperator.hpp>
+#include <BlazeIterative/operators/SymmetricOperator.hpp>
+#include <BlazeIterative/preconditioners/IncompleteFactorization.hpp>
+#include <BlazeIterative/preconditioners/TriangularSolve.hpp>
 
 #include <BlazeIterative/solvers/solvers.hpp>
 
@@ -0,0 +1,30 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_BASISPRECISION_HPP
+#define BLAZE_ITERATIVE_BASISPRECISION_HPP
+
+#include "IterativeCommon.hpp"
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+/**
+ * Storage precision of the Krylov basis of GMRES and Arnoldi.
+ * With SINGLE the basis vectors are stored as float, while all
+ * arithmetic (products, orthogonalization, least squares) stays in the
+ * precision of the system. This halves basis memory and the memory
+ * traffic of the orthogonalization.
+ */
+enum class BasisPrecision : unsigned char {
+    FULL,
+    SINGLE
+};
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_BASISPRECISION_HPP
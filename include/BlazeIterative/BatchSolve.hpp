@@ -0,0 +1,107 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_BATCHSOLVE_HPP
+#define BLAZE_ITERATIVE_BATCHSOLVE_HPP
+
+#include "IterativeCommon.hpp"
+#include "IterativeTag.hpp"
+#include "ThreadPool.hpp"
+#include "solve.hpp"
+#include <future>
+#include <string>
+#include <utility>
+#include <vector>
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+/**
+ * One system of a batch. The matrix and the right-hand side are
+ * referenced and must stay alive until the job's future is ready; the
+ * tag is copied, so every job has its own status and history.
+ */
+template<typename MatrixType, typename TagType>
+struct SolveJob
+{
+    using ElementType = typename MatrixType::ElementType;
+
+    SolveJob(const MatrixType &A, const DynamicVector<ElementType> &b, const TagType &tag,
+             std::string Preconditioner = "")
+            : A(&A), b(&b), tag(tag), preconditioner(std::move(Preconditioner)) {}
+
+    const MatrixType *A;
+    const DynamicVector<ElementType> *b;
+    TagType tag;
+    std::string preconditioner;
+};
+
+// Outcome of one job of a batch
+template<typename T>
+struct SolveResult
+{
+    DynamicVector<T> x;
+    TerminationStatus status{TerminationStatus::NOT_TERMINATED};
+    std::vector<double> convergence_history;
+};
+
+/**
+ * Queue one solve on the pool, starting from a zero initial guess.
+ */
+template<typename MatrixType, typename TagType>
+std::future<SolveResult<typename MatrixType::ElementType>>
+solve_async(ThreadPool &pool, const SolveJob<MatrixType, TagType> &job)
+{
+    using T = typename MatrixType::ElementType;
+
+    return pool.submit([job]() mutable {
+        SolveResult<T> result;
+        result.x.resize(job.b->size(), false);
+        reset(result.x);
+
+        if(job.preconditioner.empty()) {
+            solve_inplace(result.x, *job.A, *job.b, job.tag);
+        } else {
+            solve_inplace(result.x, *job.A, *job.b, job.tag, job.preconditioner);
+        }
+
+        result.status = job.tag.status();
+        result.convergence_history = job.tag.convergence_history();
+        return result;
+    });
+}
+
+/**
+ * \brief Solve a batch of independent systems on a work-stealing pool.
+ *
+ * Returns one future per job, in the order of the jobs. Jobs that
+ * finish early free their worker for the remaining ones, and exceptions
+ * thrown by a solve are rethrown by the corresponding future's get().
+ *
+ * \code
+ * ThreadPool pool(0, 2);      // hardware_concurrency()/2 workers, 2 threads each
+ * std::vector<SolveJob<DynamicMatrix<double>, GMRESTag>> jobs;
+ * for(std::size_t i = 0; i < A.size(); ++i)
+ *     jobs.emplace_back(A[i], b[i], tag);
+ * auto results = solve_batch(pool, jobs);
+ * \endcode
+ */
+template<typename MatrixType, typename TagType>
+std::vector<std::future<SolveResult<typename MatrixType::ElementType>>>
+solve_batch(ThreadPool &pool, const std::vector<SolveJob<MatrixType, TagType>> &jobs)
+{
+    std::vector<std::future<SolveResult<typename MatrixType::ElementType>>> results;
+    results.reserve(jobs.size());
+    for(const auto &job : jobs) {
+        results.push_back(solve_async(pool, job));
+    }
+    return results;
+}
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_BATCHSOLVE_HPP
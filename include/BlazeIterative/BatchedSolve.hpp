@@ -0,0 +1,68 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_BATCHEDSOLVE_HPP
+#define BLAZE_ITERATIVE_BATCHEDSOLVE_HPP
+
+#include "IterativeCommon.hpp"
+#include "batched/BatchedStorage.hpp"
+#include "batched/BatchedCG.hpp"
+#include "batched/BatchedBiCGSTAB.hpp"
+#include "batched/BatchedGMRES.hpp"
+#include <cassert>
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+/**
+ * \brief Solve many small systems of the same size at once.
+ *
+ * The systems of a BatchedMatrix are processed W at a time, one system
+ * per SIMD lane, and the chunks are distributed over the OpenMP threads.
+ * Every lane has its own convergence test, so a converged system stops
+ * changing while the others of its chunk continue. Supported tags are
+ * ConjugateGradientTag, BiCGSTABTag and GMRESTag; the tag provides the
+ * tolerances, the iteration limit and (for GMRES) the restart length,
+ * and the returned BatchedSolveStatus holds the outcome of every system.
+ * The values in "x" are used as the initial guesses.
+ */
+template<typename T, std::size_t W, typename TagType>
+BatchedSolveStatus solve_batched_inplace(BatchedVector<T, W> &x,
+                                         const BatchedMatrix<T, W> &A,
+                                         const BatchedVector<T, W> &b,
+                                         TagType &tag)
+{
+    assert(A.size() == b.size() && A.size() == x.size() && "A, b and x must hold the same number of systems");
+    assert(A.rows() == b.rows() && A.rows() == x.rows() && "A, b and x must have consistent dimensions");
+
+    BatchedSolveStatus result;
+    result.status.resize(A.chunks() * W, TerminationStatus::NOT_TERMINATED);
+    result.iterations.resize(A.chunks() * W, 0);
+
+    detail::batched_solve_impl(x, A, b, tag, result);
+
+    result.status.resize(A.size());
+    result.iterations.resize(A.size());
+    return result;
+}
+
+// As solve_batched_inplace(), starting from zero initial guesses
+template<typename T, std::size_t W, typename TagType>
+BatchedVector<T, W> solve_batched(const BatchedMatrix<T, W> &A,
+                                  const BatchedVector<T, W> &b,
+                                  TagType &tag,
+                                  BatchedSolveStatus &result)
+{
+    BatchedVector<T, W> x(b.size(), b.rows());
+    result = solve_batched_inplace(x, A, b, tag);
+
+    return x;
+}
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_BATCHEDSOLVE_HPP
@@ -0,0 +1,313 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_CHECKPOINT_HPP
+#define BLAZE_ITERATIVE_CHECKPOINT_HPP
+
+#include "IterativeCommon.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+namespace detail {
+
+/**
+ * Fixed-size header at the start of a checkpoint file. Besides the
+ * commit information it records the layout of the solver state, so that
+ * a file written by another solver or for another system is rejected.
+ */
+struct CheckpointHeader
+{
+    char magic[8];
+    std::uint64_t version;
+    char solver[32];
+    std::uint64_t rows;
+    std::uint64_t restart;
+    std::uint64_t element_size;
+    std::uint64_t basis_element_size;
+    std::uint64_t slot_size;
+
+    // Slot holding the last complete state, 2 if nothing was committed yet
+    std::uint64_t active_slot;
+    std::uint64_t sequence;
+};
+
+inline CheckpointHeader checkpoint_layout(const std::string &solver,
+                                          std::size_t rows,
+                                          std::size_t restart,
+                                          std::size_t element_size,
+                                          std::size_t basis_element_size,
+                                          std::size_t slot_size)
+{
+    CheckpointHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "BLZITCKP", 8);
+    header.version = 1;
+    std::strncpy(header.solver, solver.c_str(), sizeof(header.solver) - 1);
+    header.rows = rows;
+    header.restart = restart;
+    header.element_size = element_size;
+    header.basis_element_size = basis_element_size;
+    header.slot_size = slot_size;
+    header.active_slot = 2;
+    return header;
+}
+
+/**
+ * \brief Memory-mapped checkpoint file with two state slots.
+ *
+ * The solver writes its state into the slot that is not active and then
+ * commits it, which flips the active slot in the header. A job that is
+ * killed while writing therefore always leaves the previous state intact.
+ * The file is mapped MAP_SHARED, so committed data survives the process
+ * without an explicit flush; commit() only schedules the write-back.
+ */
+class CheckpointFile
+{
+public:
+    CheckpointFile() = default;
+
+    CheckpointFile(const CheckpointFile &) = delete;
+
+    CheckpointFile &operator=(const CheckpointFile &) = delete;
+
+    ~CheckpointFile() { close(); }
+
+    // Creates (or truncates) the file for the given layout
+    bool create(const std::string &path, const CheckpointHeader &layout)
+    {
+        close();
+        const std::size_t size = sizeof(CheckpointHeader) + 2 * layout.slot_size;
+
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if(fd_ < 0 || ::ftruncate(fd_, static_cast<off_t>(size)) != 0 || !map(size)) {
+            close();
+            return false;
+        }
+
+        *header_ = layout;
+        return true;
+    }
+
+    // Maps an existing file; fails if it holds no committed state of the given layout
+    bool open(const std::string &path, const CheckpointHeader &layout)
+    {
+        close();
+        const std::size_t size = sizeof(CheckpointHeader) + 2 * layout.slot_size;
+
+        struct stat info;
+        fd_ = ::open(path.c_str(), O_RDWR);
+        if(fd_ < 0 || ::fstat(fd_, &info) != 0 || static_cast<std::size_t>(info.st_size) != size || !map(size)) {
+            close();
+            return false;
+        }
+
+        if(!sameLayout(layout) || header_->active_slot > 1) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    bool isOpen() const { return header_ != nullptr; }
+
+    std::size_t activeSlot() const { return header_->active_slot; }
+
+    // Slot the next state has to be written to
+    std::size_t nextSlot() const { return header_->active_slot == 0 ? 1 : 0; }
+
+    unsigned char *slot(std::size_t i)
+    {
+        return reinterpret_cast<unsigned char *>(header_ + 1) + i * header_->slot_size;
+    }
+
+    // Makes the state written to slot i the current one
+    void commit(std::size_t i)
+    {
+        ::msync(page_start(slot(i)), slot_end(i) - page_start(slot(i)), MS_ASYNC);
+        header_->active_slot = i;
+        ++header_->sequence;
+        ::msync(map_, sizeof(CheckpointHeader), MS_ASYNC);
+    }
+
+    void close()
+    {
+        if(map_ != nullptr) {
+            ::munmap(map_, size_);
+        }
+        if(fd_ >= 0) {
+            ::close(fd_);
+        }
+        map_ = nullptr;
+        header_ = nullptr;
+        size_ = 0;
+        fd_ = -1;
+    }
+
+private:
+    bool map(std::size_t size)
+    {
+        void *p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if(p == MAP_FAILED) {
+            return false;
+        }
+        map_ = p;
+        size_ = size;
+        header_ = static_cast<CheckpointHeader *>(p);
+        return true;
+    }
+
+    bool sameLayout(const CheckpointHeader &layout) const
+    {
+        return std::memcmp(header_->magic, layout.magic, sizeof(layout.magic)) == 0
+               && header_->version == layout.version
+               && std::strncmp(header_->solver, layout.solver, sizeof(layout.solver)) == 0
+               && header_->rows == layout.rows
+               && header_->restart == layout.restart
+               && header_->element_size == layout.element_size
+               && header_->basis_element_size == layout.basis_element_size
+               && header_->slot_size == layout.slot_size;
+    }
+
+    // msync requires a page aligned start address
+    unsigned char *page_start(unsigned char *p) const
+    {
+        const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        unsigned char *base = static_cast<unsigned char *>(map_);
+        return base + ((p - base) / page) * page;
+    }
+
+    unsigned char *slot_end(std::size_t i) { return slot(i) + header_->slot_size; }
+
+    int fd_{-1};
+    void *map_{nullptr};
+    std::size_t size_{0};
+    CheckpointHeader *header_{nullptr};
+};
+
+/**
+ * Sequential writer of the solver state into a checkpoint slot. Every
+ * field has a fixed offset, so parts that did not change since the last
+ * checkpoint (e.g. old Krylov vectors) can be skipped instead of rewritten.
+ */
+class CheckpointWriter
+{
+public:
+    explicit CheckpointWriter(unsigned char *data) : data_(data) {}
+
+    template<typename S>
+    CheckpointWriter &scalar(const S &value)
+    {
+        std::memcpy(data_, &value, sizeof(S));
+        data_ += sizeof(S);
+        return *this;
+    }
+
+    template<typename T>
+    CheckpointWriter &vector(const DynamicVector<T> &v)
+    {
+        std::memcpy(data_, v.data(), v.size() * sizeof(T));
+        data_ += v.size() * sizeof(T);
+        return *this;
+    }
+
+    // Writes columns [first, last) of M; the region always spans all columns of M
+    template<typename T>
+    CheckpointWriter &columns(const DynamicMatrix<T, columnMajor> &M, std::size_t first, std::size_t last)
+    {
+        const std::size_t bytes = M.rows() * sizeof(T);
+        for(std::size_t j = first; j < last; ++j) {
+            std::memcpy(data_ + j * bytes, M.data(j), bytes);
+        }
+        data_ += M.columns() * bytes;
+        return *this;
+    }
+
+    // Writes the entries of h from index first on, into room for capacity entries
+    CheckpointWriter &history(const std::vector<double> &h, std::size_t first, std::size_t capacity)
+    {
+        const std::size_t count = h.size() > first ? std::min(h.size() - first, capacity) : 0;
+        scalar(static_cast<std::uint64_t>(count));
+        std::memcpy(data_, h.data() + first, count * sizeof(double));
+        data_ += capacity * sizeof(double);
+        return *this;
+    }
+
+private:
+    unsigned char *data_;
+};
+
+// Reads what CheckpointWriter wrote, in the same order
+class CheckpointReader
+{
+public:
+    explicit CheckpointReader(const unsigned char *data) : data_(data) {}
+
+    template<typename S>
+    CheckpointReader &scalar(S &value)
+    {
+        std::memcpy(&value, data_, sizeof(S));
+        data_ += sizeof(S);
+        return *this;
+    }
+
+    template<typename T>
+    CheckpointReader &vector(DynamicVector<T> &v)
+    {
+        std::memcpy(v.data(), data_, v.size() * sizeof(T));
+        data_ += v.size() * sizeof(T);
+        return *this;
+    }
+
+    template<typename T>
+    CheckpointReader &columns(DynamicMatrix<T, columnMajor> &M, std::size_t first, std::size_t last)
+    {
+        const std::size_t bytes = M.rows() * sizeof(T);
+        for(std::size_t j = first; j < last; ++j) {
+            std::memcpy(M.data(j), data_ + j * bytes, bytes);
+        }
+        data_ += M.columns() * bytes;
+        return *this;
+    }
+
+    // Appends the stored entries to h
+    CheckpointReader &history(std::vector<double> &h, std::size_t capacity)
+    {
+        std::uint64_t count;
+        scalar(count);
+        const std::size_t offset = h.size();
+        h.resize(offset + count);
+        std::memcpy(h.data() + offset, data_, count * sizeof(double));
+        data_ += capacity * sizeof(double);
+        return *this;
+    }
+
+private:
+    const unsigned char *data_;
+};
+
+// Bytes of a CheckpointWriter::history region
+inline std::size_t checkpoint_history_size(std::size_t capacity)
+{
+    return sizeof(std::uint64_t) + capacity * sizeof(double);
+}
+
+} //end namespace detail
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_CHECKPOINT_HPP
@@ -0,0 +1,237 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_INITIALGUESS_HPP
+#define BLAZE_ITERATIVE_INITIALGUESS_HPP
+
+#include "IterativeCommon.hpp"
+#include "LinearOperator.hpp"
+#include "solve.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+/**
+ * How InitialGuessProvider combines the stored solutions x_1 .. x_k:
+ *  - PROJECTION minimizes ||b - A X c|| over the span of the solutions
+ *    with the current A (k products with A per guess). The residual of
+ *    the guess is never larger than ||b||, also when A changes between
+ *    the solves.
+ *  - RIGHT_HAND_SIDES minimizes ||b - B c|| over the stored right-hand
+ *    sides and takes x = X c. It needs no product with A and is as good
+ *    as PROJECTION as long as A does not change.
+ *  - EXTRAPOLATION extrapolates the solutions as a polynomial in the
+ *    step number (2 x_k - x_{k-1} for two solutions, and so on). It
+ *    ignores b and suits sequences with equal, smooth steps.
+ */
+enum class InitialGuessMode : unsigned char {
+    PROJECTION,
+    RIGHT_HAND_SIDES,
+    EXTRAPOLATION
+};
+
+/**
+ * \class InitialGuessProvider
+ * \brief Initial guesses for a sequence of related systems.
+ *
+ * Implicit time integrators and nonlinear iterations solve a sequence of
+ * systems whose solutions change little from one to the next. The
+ * provider keeps the last history() solutions and right-hand sides, and
+ * builds the initial guess for the next system from them (see
+ * InitialGuessMode). The solvers are unchanged; the guess is simply the
+ * starting value of solve_inplace:
+ * \code
+ * InitialGuessProvider<double> history(4);
+ * for(std::size_t step = 0; step < steps; ++step) {
+ *     history.guess(x, A, b);
+ *     solve_inplace(x, A, b, tag);
+ *     history.record(x, b);
+ * }
+ * \endcode
+ * or shorter, x = solve(A, b, tag, history).
+ *
+ * CG, preconditioned CG and BiCGSTAB measure their relative residual
+ * against the residual of the initial guess; to save iterations with
+ * them, converge on absoluteResidualTolerance().
+ */
+template<typename T = double>
+class InitialGuessProvider
+{
+public:
+    using ElementType = T;
+
+    explicit InitialGuessProvider(std::size_t history = 4, InitialGuessMode mode = InitialGuessMode::PROJECTION)
+            : history_(std::max<std::size_t>(history, 1)), mode_(mode)
+    {}
+
+    std::size_t history() const { return history_; }
+
+    InitialGuessMode &mode() { return mode_; }
+
+    InitialGuessMode mode() const { return mode_; }
+
+    // Number of solutions stored
+    std::size_t size() const { return count_; }
+
+    void clear()
+    {
+        count_ = 0;
+        next_ = 0;
+    }
+
+    /**
+     * Stores the solution x of A x = b, replacing the oldest one once
+     * history() solutions are stored. A vector of a different length
+     * starts a new sequence.
+     */
+    void record(const DynamicVector<T> &x, const DynamicVector<T> &b)
+    {
+        assert(x.size() == b.size() && "x and b must be the same length");
+
+        if(X_.rows() != x.size()) {
+            X_.resize(x.size(), history_, false);
+            B_.resize(x.size(), history_, false);
+            clear();
+        }
+
+        column(X_, next_) = x;
+        column(B_, next_) = b;
+        next_ = (next_ + 1) % history_;
+        count_ = std::min(count_ + 1, history_);
+    }
+
+    /**
+     * Sets x to the initial guess for A x = b; zero while nothing is
+     * stored for vectors of this length.
+     */
+    template<typename MatrixType>
+    void guess(DynamicVector<T> &x, const MatrixType &A, const DynamicVector<T> &b)
+    {
+        using detail::multiply;
+
+        x.resize(b.size(), false);
+        reset(x);
+        if(count_ == 0 || X_.rows() != b.size()) {
+            return;
+        }
+
+        Q_.resize(b.size(), history_, false);
+        Z_.resize(b.size(), history_, false);
+        q_.resize(b.size(), false);
+        z_.resize(b.size(), false);
+        directions_ = 0;
+
+        switch(mode_) {
+            case InitialGuessMode::PROJECTION:
+                for(std::size_t j = 0; j < count_; ++j) {
+                    multiply(q_, A, column(X_, slot(j)));
+                    z_ = column(X_, slot(j));
+                    add_direction();
+                }
+                project(x, b);
+                break;
+            case InitialGuessMode::RIGHT_HAND_SIDES:
+                for(std::size_t j = 0; j < count_; ++j) {
+                    q_ = column(B_, slot(j));
+                    z_ = column(X_, slot(j));
+                    add_direction();
+                }
+                project(x, b);
+                break;
+            case InitialGuessMode::EXTRAPOLATION: {
+                // Polynomial through the last k solutions: x = sum_j (-1)^j binomial(k, j + 1) x_{k-j}
+                T coefficient = T(count_);
+                for(std::size_t j = 0; j < count_; ++j) {
+                    x += coefficient * column(X_, slot(j));
+                    coefficient = -coefficient * T(count_ - j - 1) / T(j + 2);
+                }
+                break;
+            }
+        }
+    }
+
+private:
+    // Column of the j-th most recent solution
+    std::size_t slot(std::size_t j) const
+    {
+        return (next_ + history_ - 1 - j) % history_;
+    }
+
+    /**
+     * Orthonormalizes q_ against the accepted directions (twice, as in
+     * thin_qr) and applies the same combination to z_, so that
+     * A Z = Q holds for the accepted columns. Directions that are
+     * numerically dependent on the previous ones are dropped.
+     */
+    void add_direction()
+    {
+        const T norm_in = norm(q_);
+        for(int pass = 0; pass < 2; ++pass) {
+            for(std::size_t i = 0; i < directions_; ++i) {
+                const T c = trans(column(Q_, i)) * q_;
+                q_ -= c * column(Q_, i);
+                z_ -= c * column(Z_, i);
+            }
+        }
+
+        const T norm_out = norm(q_);
+        if(!(norm_out > T(1e-12) * norm_in)) {
+            return;
+        }
+        column(Q_, directions_) = q_ / norm_out;
+        column(Z_, directions_) = z_ / norm_out;
+        ++directions_;
+    }
+
+    // x = Z Q^T b, the minimizer of ||b - Q c|| mapped back to the solutions
+    void project(DynamicVector<T> &x, const DynamicVector<T> &b)
+    {
+        for(std::size_t i = 0; i < directions_; ++i) {
+            x += (trans(column(Q_, i)) * b) * column(Z_, i);
+        }
+    }
+
+    std::size_t history_;
+    InitialGuessMode mode_;
+    std::size_t count_{0};
+    std::size_t next_{0};
+    DynamicMatrix<T, columnMajor> X_;
+    DynamicMatrix<T, columnMajor> B_;
+
+    // Workspace of guess(), kept to avoid allocations in a time loop
+    DynamicMatrix<T, columnMajor> Q_;
+    DynamicMatrix<T, columnMajor> Z_;
+    DynamicVector<T> q_;
+    DynamicVector<T> z_;
+    std::size_t directions_{0};
+};
+
+
+/**
+ * \brief Solve \f$ Ax = b \f$ starting from the guess of a provider.
+ *
+ * The solution is recorded in the provider for the next system of the
+ * sequence.
+ */
+template<typename MatrixType, typename T, typename TagType>
+DynamicVector<T> solve(const MatrixType &A, const DynamicVector<T> &b, TagType &tag,
+                       InitialGuessProvider<T> &provider)
+{
+    DynamicVector<T> x(b.size(), 0.0);
+    provider.guess(x, A, b);
+    solve_inplace(x, A, b, tag);
+    provider.record(x, b);
+
+    return x;
+};
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_INITIALGUESS_HPP
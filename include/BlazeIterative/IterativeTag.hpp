@@ -6,12 +6,16 @@
 #ifndef BLAZE_ITERATIVE_ITERATIVE_TAG_HPP
 #define BLAZE_ITERATIVE_ITERATIVE_TAG_HPP
 
+#include "ReductionMode.hpp"
 #include "TerminationStatus.hpp"
+#include <algorithm>
 
 
 BLAZE_NAMESPACE_OPEN
 ITERATIVE_NAMESPACE_OPEN
 
+class Tracer;
+
 class IterativeTag
 {
 
@@ -33,6 +37,15 @@ public:
     template<typename T, typename=typename std::enable_if<std::is_convertible<T, double>::value>::type>
     inline void log_residual(T residual) { convergence_history_container.push_back(residual); }
 
+    // Makes room for the residuals of one solve, so that log_residual does not allocate in the iteration
+    inline void reserve_log(std::size_t entries)
+    {
+        if(record_convergence_history) {
+            const std::size_t limit = maximum_log_reservation;
+            convergence_history_container.reserve(convergence_history_container.size() + std::min(entries, limit));
+        }
+    }
+
     bool &do_log() { return record_convergence_history; }
 
     bool do_log() const { return record_convergence_history; }
@@ -53,6 +66,50 @@ public:
 
     const std::vector<double> &convergence_history() const { return convergence_history_container; }
 
+    std::vector<double> &convergence_history() { return convergence_history_container; }
+
+    const std::string &name() const { return solverName; }
+
+    // File the solver state is periodically written to, see Checkpoint.hpp
+    std::string &checkpointFile() { return checkpoint_file; }
+
+    const std::string &checkpointFile() const { return checkpoint_file; }
+
+    // Iterations between two checkpoints, 0 disables checkpointing
+    std::size_t &checkpointInterval() { return checkpoint_interval; }
+
+    std::size_t checkpointInterval() const { return checkpoint_interval; }
+
+    // Continue from the state in checkpointFile() if it holds one for this system
+    bool &resumeFromCheckpoint() { return resume_from_checkpoint; }
+
+    bool resumeFromCheckpoint() const { return resume_from_checkpoint; }
+
+    // Receives timed events of the solver phases, see Trace.hpp; nullptr disables tracing
+    Tracer *&tracer() { return tracer_; }
+
+    Tracer *tracer() const { return tracer_; }
+
+    // Inner products and residual norms, see ReductionMode
+    ReductionMode &reductionMode() { return reduction_mode; }
+
+    ReductionMode reductionMode() const { return reduction_mode; }
+
+    // Upper bound in bytes for the workspace of a solve, 0 for no limit, see workspace_size()
+    std::size_t &memoryBudget() { return memory_budget; }
+
+    std::size_t memoryBudget() const { return memory_budget; }
+
+    // False, with the status MEMORY_BUDGET_EXCEEDED, if a workspace of this many bytes exceeds memoryBudget()
+    inline bool fitsMemoryBudget(std::size_t bytes)
+    {
+        if(memory_budget != 0 && bytes > memory_budget) {
+            terminationStatus = TerminationStatus::MEMORY_BUDGET_EXCEEDED;
+            return false;
+        }
+        return true;
+    }
+
 protected:
     std::size_t maximum_iterations{20};
     double relative_residual_tolerance{1.0e-6};
@@ -60,6 +117,15 @@ protected:
     std::string solverName{"Default"};
     TerminationStatus terminationStatus{TerminationStatus::NOT_TERMINATED};
     bool record_convergence_history{false};
+    std::string checkpoint_file;
+    std::size_t checkpoint_interval{0};
+    bool resume_from_checkpoint{false};
+    Tracer *tracer_{nullptr};
+    ReductionMode reduction_mode{ReductionMode::BLAZE};
+    std::size_t memory_budget{0};
+
+    // Upper bound for reserve_log, in case maximum_iterations is used as "unlimited"
+    static constexpr std::size_t maximum_log_reservation{1u << 20};
 
     //container for relative residual convergence history
     std::vector<double> convergence_history_container;
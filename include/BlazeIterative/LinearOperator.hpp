@@ -0,0 +1,114 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_LINEAROPERATOR_HPP
+#define BLAZE_ITERATIVE_LINEAROPERATOR_HPP
+
+#include "IterativeCommon.hpp"
+#include <type_traits>
+#include <utility>
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+/**
+ * \brief Types accepted as the operator A by solve() and solve_inplace().
+ *
+ * Every Blaze matrix is a linear operator. Other types (e.g. matrices
+ * that live in a memory-mapped file) specialize this trait, provide
+ * ElementType, rows() and columns(), and overload multiply() and
+ * symmetric_multiply() in their own namespace, where the solvers find
+ * them by argument dependent lookup. Only solvers that apply A
+ * exclusively through the functions below (CG, BiCGSTAB, GMRES, FGMRES,
+ * GCRO-DR and deflated CG) accept such operators. Lanczos and Arnoldi do as well, but pass
+ * matrix columns, which are not contiguous, so operators used there must
+ * accept any dense vector x. Preconditioned CG also accepts operators that
+ * assemble their entries with a member function matrix(), which its setup
+ * phase factorizes, and count them with nonZeros() for workspace_size().
+ */
+template<typename MatrixType>
+struct IsLinearOperator : public std::integral_constant<bool, IsMatrix<MatrixType>::value>
+{};
+
+namespace detail {
+
+// y = A * x
+template<typename MatrixType, typename VT, typename T>
+inline void multiply(DynamicVector<T> &y, const MatrixType &A, const VT &x)
+{
+    y = A * x;
+}
+
+// y = A * x for an A known to be symmetric
+template<typename MatrixType, typename VT, typename T>
+inline void symmetric_multiply(DynamicVector<T> &y, const MatrixType &A, const VT &x)
+{
+    y = declsym(A) * x;
+}
+
+// The entries of A for setup phases that factorize it: a Blaze matrix itself
+template<typename MatrixType>
+inline std::enable_if_t<IsMatrix<MatrixType>::value, const MatrixType &> assembled(const MatrixType &A)
+{
+    return A;
+}
+
+// ... or the matrix assembled by an operator, which lives as long as the setup
+template<typename MatrixType>
+inline std::enable_if_t<!IsMatrix<MatrixType>::value, decltype(std::declval<const MatrixType &>().matrix())>
+assembled(const MatrixType &A)
+{
+    return A.matrix();
+}
+
+// r = b - A * x
+template<typename MatrixType, typename T>
+inline void residual(DynamicVector<T> &r, const MatrixType &A, const DynamicVector<T> &x, const DynamicVector<T> &b)
+{
+    multiply(r, A, x);
+    r = b - r;
+}
+
+// Y = A * X with a single matrix-matrix product for Blaze matrices...
+template<typename MatrixType, typename T>
+inline void multiply_columns(DynamicMatrix<T, columnMajor> &Y, const MatrixType &A,
+                             const DynamicMatrix<T, columnMajor> &X, std::true_type)
+{
+    Y = A * X;
+}
+
+// ... and column by column for other linear operators
+template<typename MatrixType, typename T>
+inline void multiply_columns(DynamicMatrix<T, columnMajor> &Y, const MatrixType &A,
+                             const DynamicMatrix<T, columnMajor> &X, std::false_type)
+{
+    Y.resize(A.rows(), X.columns(), false);
+    DynamicVector<T> y(A.rows());
+    for(std::size_t j = 0; j < X.columns(); ++j) {
+        multiply(y, A, column(X, j));
+        column(Y, j) = y;
+    }
+}
+
+template<typename MatrixType, typename T>
+inline void multiply_columns(DynamicMatrix<T, columnMajor> &Y, const MatrixType &A,
+                             const DynamicMatrix<T, columnMajor> &X)
+{
+    multiply_columns(Y, A, X, std::integral_constant<bool, IsMatrix<MatrixType>::value>());
+}
+
+// Eigenvalues of A from those the eigensolvers computed for the operator:
+// unchanged except for spectral transformations such as shift-invert
+template<typename MatrixType, typename T>
+inline void recover_eigenvalues(DynamicVector<T> &, const MatrixType &)
+{}
+
+} //end namespace detail
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_LINEAROPERATOR_HPP
@@ -0,0 +1,120 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_REDUCTION_HPP
+#define BLAZE_ITERATIVE_REDUCTION_HPP
+
+#include "IterativeCommon.hpp"
+#include "IterativeTag.hpp"
+#include "ReductionMode.hpp"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+namespace detail {
+
+/*
+ * Deterministic reductions. The vector is cut into blocks of
+ * reduction_block_size elements (more for vectors longer than
+ * reduction_max_blocks blocks), so the blocking depends on the length
+ * only. Each block is summed by one thread into reduction_lanes
+ * accumulators, which the compiler can keep in one SIMD register without
+ * reassociating anything, and the lanes and then the block sums are added
+ * pairwise in a fixed tree. The threads only decide who computes which
+ * block, never the order of the additions.
+ */
+constexpr std::size_t reduction_block_size = 2048;
+constexpr std::size_t reduction_max_blocks = 4096;
+constexpr std::size_t reduction_lanes = 8;
+
+// Below this length a parallel region costs more than it saves
+constexpr std::size_t reduction_parallel_size = 32768;
+
+template<typename VT1, typename VT2>
+using ReductionType = decltype(std::declval<typename VT1::ElementType>() * std::declval<typename VT2::ElementType>());
+
+// Sum of x[i] * y[i] over [first, last) in a fixed order
+template<typename VT1, typename VT2>
+ReductionType<VT1, VT2> block_dot(const VT1 &x, const VT2 &y, std::size_t first, std::size_t last)
+{
+    using T = ReductionType<VT1, VT2>;
+
+    T lane[reduction_lanes] = {};
+    std::size_t i = first;
+    for(; i + reduction_lanes <= last; i += reduction_lanes) {
+        for(std::size_t k = 0; k < reduction_lanes; ++k) {
+            lane[k] += x[i + k] * y[i + k];
+        }
+    }
+    for(std::size_t k = 0; i + k < last; ++k) {
+        lane[k] += x[i + k] * y[i + k];
+    }
+
+    for(std::size_t stride = 1; stride < reduction_lanes; stride *= 2) {
+        for(std::size_t k = 0; k + stride < reduction_lanes; k += 2 * stride) {
+            lane[k] += lane[k + stride];
+        }
+    }
+    return lane[0];
+}
+
+// x^T y, bit-identical for any number of threads
+template<typename VT1, typename VT2>
+ReductionType<VT1, VT2> deterministic_dot(const VT1 &x, const VT2 &y)
+{
+    using T = ReductionType<VT1, VT2>;
+
+    const std::size_t n = x.size();
+    const std::size_t block = std::max(reduction_block_size, (n + reduction_max_blocks - 1) / reduction_max_blocks);
+    const std::size_t blocks = (n + block - 1) / block;
+    if(blocks == 0) {
+        return T(0);
+    }
+
+    T partial[reduction_max_blocks];
+#pragma omp parallel for schedule(static) if(n >= reduction_parallel_size)
+    for(long b = 0; b < static_cast<long>(blocks); ++b) {
+        const std::size_t first = static_cast<std::size_t>(b) * block;
+        partial[b] = block_dot(x, y, first, std::min(first + block, n));
+    }
+
+    for(std::size_t stride = 1; stride < blocks; stride *= 2) {
+        for(std::size_t b = 0; b + stride < blocks; b += 2 * stride) {
+            partial[b] += partial[b + stride];
+        }
+    }
+    return partial[0];
+}
+
+// x^T y in the reduction mode of the tag
+template<typename VT1, typename VT2>
+inline ReductionType<VT1, VT2> dot_product(const IterativeTag &tag, const VT1 &x, const VT2 &y)
+{
+    if(tag.reductionMode() == ReductionMode::DETERMINISTIC) {
+        return deterministic_dot(x, y);
+    }
+    return trans(x) * y;
+}
+
+// ||x|| in the reduction mode of the tag
+template<typename VT>
+inline ReductionType<VT, VT> vector_norm(const IterativeTag &tag, const VT &x)
+{
+    if(tag.reductionMode() == ReductionMode::DETERMINISTIC) {
+        return std::sqrt(deterministic_dot(x, x));
+    }
+    return norm(x);
+}
+
+} //end namespace detail
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_REDUCTION_HPP
@@ -0,0 +1,31 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_REDUCTIONMODE_HPP
+#define BLAZE_ITERATIVE_REDUCTIONMODE_HPP
+
+#include "IterativeCommon.hpp"
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+/**
+ * How the solvers compute inner products and residual norms.
+ * BLAZE uses Blaze's kernels, whose parallel reductions may round
+ * differently with another number of threads. DETERMINISTIC sums in
+ * blocks whose size depends only on the vector length and combines the
+ * block sums in a fixed tree, so results are bit-identical for any
+ * number of threads and any schedule (see Reduction.hpp).
+ */
+enum class ReductionMode : unsigned char {
+    BLAZE,
+    DETERMINISTIC
+};
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_REDUCTIONMODE_HPP
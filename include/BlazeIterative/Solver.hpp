@@ -0,0 +1,150 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_SOLVER_HPP
+#define BLAZE_ITERATIVE_SOLVER_HPP
+
+#include "IterativeCommon.hpp"
+#include "IterativeTag.hpp"
+#include "LinearOperator.hpp"
+#include "Trace.hpp"
+#include "solve.hpp"
+#include "solvers/solvers.hpp"
+#include <string>
+#include <utility>
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+namespace detail {
+
+// Solvers without a setup phase ignore the (empty) setup data
+template<typename MatrixType, typename T, typename TagType>
+void solve_impl(
+        DynamicVector<T> &x,
+        const MatrixType &A,
+        const DynamicVector<T> &b,
+        TagType &tag,
+        const SolverSetup<TagType, MatrixType, T> &setup)
+{
+    detail::solve_impl(x, A, b, tag);
+}
+
+} //end namespace detail
+
+/**
+ * \class Solver
+ * \brief Stateful solver for repeated solves with the same operator.
+ *
+ * The free function solve() redoes all preconditioner construction,
+ * factorization and validation of A on every call. A Solver splits that
+ * work off into setup(), which is executed once, and can then be used
+ * for any number of right-hand sides:
+ *
+ * \code
+ * PreconditionCGTag tag;
+ * auto solver = make_solver(A, tag, "SSOR");
+ * solver.setup();
+ * for(auto &b : rhs)
+ *     solver.solve(b, x);
+ * \endcode
+ *
+ * When the values of A change but its size (and sparsity pattern) stay
+ * the same, update_values() rebinds the solver to the new matrix and
+ * recomputes the setup data. The matrix and the tag are referenced, not
+ * copied, and must outlive the Solver.
+ */
+template<typename MatrixType, typename TagType>
+class Solver
+{
+public:
+    using ElementType = typename MatrixType::ElementType;
+
+    Solver(const MatrixType &A, TagType &tag, std::string Preconditioner = "")
+            : A_(&A), tag_(tag), preconditioner_(std::move(Preconditioner))
+    {
+        static_assert(IsLinearOperator<MatrixType>::value, "A must be a matrix or a linear operator");
+        assert(A.rows() == A.columns() && "A must be a square matrix");
+    }
+
+    /**
+     * Analyse and factorize the operator. Called implicitly by the
+     * first solve() if it was not called before.
+     */
+    void setup()
+    {
+        detail::TraceScope trace(tag_, "setup", "setup");
+        setup_.setup(*A_, preconditioner_, tag_);
+        is_setup_ = true;
+    }
+
+    /**
+     * Replace the matrix values. A must have the same dimensions as the
+     * matrix the solver was created with; the setup data is recomputed.
+     */
+    void update_values(const MatrixType &A)
+    {
+        assert(A.rows() == A_->rows() && A.columns() == A_->columns()
+               && "update_values requires a matrix of the same size");
+
+        A_ = &A;
+        setup();
+    }
+
+    /**
+     * Solve \f$ Ax = b \f$ using the values in "x" as initial guess.
+     */
+    void solve(const DynamicVector<ElementType> &b, DynamicVector<ElementType> &x)
+    {
+        assert(A_->columns() == b.size() && "A and b must have consistent dimensions");
+        assert(x.size() == b.size() && "x and b must be the same length");
+
+        if(!is_setup_) {
+            setup();
+        }
+        if(!detail::fits_memory_budget(*A_, tag_, preconditioner_)) {
+            return;
+        }
+
+        detail::solve_impl(x, *A_, b, tag_, setup_);
+    }
+
+    /**
+     * Solve \f$ Ax = b \f$ starting from a zero initial guess.
+     */
+    DynamicVector<ElementType> solve(const DynamicVector<ElementType> &b)
+    {
+        DynamicVector<ElementType> x(b.size(), 0.0);
+        solve(b, x);
+
+        return x;
+    }
+
+    bool isSetup() const { return is_setup_; }
+
+    const MatrixType &matrix() const { return *A_; }
+
+    TagType &tag() { return tag_; }
+
+private:
+    const MatrixType *A_;
+    TagType &tag_;
+    std::string preconditioner_;
+    detail::SolverSetup<TagType, MatrixType, ElementType> setup_;
+    bool is_setup_{false};
+};
+
+
+template<typename MatrixType, typename TagType>
+Solver<MatrixType, TagType> make_solver(const MatrixType &A, TagType &tag, std::string Preconditioner = "")
+{
+    return Solver<MatrixType, TagType>(A, tag, std::move(Preconditioner));
+}
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_SOLVER_HPP
@@ -15,7 +15,8 @@ enum class TerminationStatus : unsigned char {
     NOT_TERMINATED,
     CONVERGED_RELATIVE_RESIDUAL,
     CONVERGED_ABSOLUTE_RESIDUAL,
-    ITERATION_LIMIT
+    ITERATION_LIMIT,
+    MEMORY_BUDGET_EXCEEDED
 };
 
 ITERATIVE_NAMESPACE_CLOSE
@@ -0,0 +1,171 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_THREADPOOL_HPP
+#define BLAZE_ITERATIVE_THREADPOOL_HPP
+
+#include "IterativeCommon.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+/**
+ * \class ThreadPool
+ * \brief Work-stealing pool for independent solves.
+ *
+ * Every worker owns a task queue. Submitted tasks are distributed round
+ * robin; a worker takes tasks from the front of its own queue and, when
+ * that is empty, steals from the back of the others, so jobs that
+ * converge at very different speeds still keep all workers busy.
+ *
+ * Each task may itself run in parallel (e.g. Blaze's OpenMP kernels).
+ * To avoid oversubscription every worker limits the OpenMP threads of its
+ * tasks to threadsPerTask(), and the default number of workers is
+ * hardware_concurrency() / threadsPerTask().
+ */
+class ThreadPool
+{
+public:
+    explicit ThreadPool(std::size_t workers = 0, std::size_t threads_per_task = 1)
+            : threads_per_task_(std::max<std::size_t>(threads_per_task, 1))
+    {
+        if(workers == 0) {
+            workers = std::max<std::size_t>(std::thread::hardware_concurrency() / threads_per_task_, 1);
+        }
+
+        for(std::size_t i = 0; i < workers; ++i) {
+            queues_.emplace_back(new Queue);
+        }
+        for(std::size_t i = 0; i < workers; ++i) {
+            threads_.emplace_back(&ThreadPool::run, this, i);
+        }
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // Finishes all submitted tasks before the workers are joined
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for(auto &thread : threads_) {
+            thread.join();
+        }
+    }
+
+    template<typename F>
+    std::future<typename std::result_of<F()>::type> submit(F &&f)
+    {
+        using ResultType = typename std::result_of<F()>::type;
+
+        auto task = std::make_shared<std::packaged_task<ResultType()>>(std::forward<F>(f));
+        std::future<ResultType> result = task->get_future();
+
+        Queue &queue = *queues_[next_++ % queues_.size()];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.emplace_back([task]() { (*task)(); });
+            ++pending_;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+        }
+        wake_.notify_one();
+
+        return result;
+    }
+
+    std::size_t size() const { return threads_.size(); }
+
+    std::size_t threadsPerTask() const { return threads_per_task_; }
+
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void run(std::size_t i)
+    {
+#ifdef _OPENMP
+        omp_set_num_threads(static_cast<int>(threads_per_task_));
+#endif
+
+        std::function<void()> task;
+        while(true) {
+            if(pop(i, task)) {
+                task();
+                task = nullptr;
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this]() { return stop_ || pending_ > 0; });
+            if(stop_ && pending_ == 0) {
+                return;
+            }
+        }
+    }
+
+    // Own queue first (oldest task), then steal the newest task of another worker
+    bool pop(std::size_t i, std::function<void()> &task)
+    {
+        const std::size_t n = queues_.size();
+        for(std::size_t k = 0; k < n; ++k) {
+            Queue &queue = *queues_[(i + k) % n];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if(queue.tasks.empty()) {
+                continue;
+            }
+            if(k == 0) {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            } else {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            }
+            --pending_;
+            return true;
+        }
+        return false;
+    }
+
+    std::size_t threads_per_task_;
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::atomic<std::size_t> pending_{0};
+    std::atomic<std::size_t> next_{0};
+    bool stop_{false};
+};
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_THREADPOOL_HPP
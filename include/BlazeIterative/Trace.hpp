@@ -0,0 +1,217 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_TRACE_HPP
+#define BLAZE_ITERATIVE_TRACE_HPP
+
+#include "IterativeCommon.hpp"
+#include "IterativeTag.hpp"
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+/**
+ * \class Tracer
+ * \brief Collects timed solver phases and writes them as a Chrome trace.
+ *
+ * Attach a Tracer to a tag with tag.tracer() = &tracer; the solvers then
+ * record one event per solve, setup, iteration and phase (SpMV,
+ * preconditioner apply, orthogonalization, reductions), each tagged with
+ * the solver name, the iteration number and the thread. write() produces
+ * the Chrome JSON trace format, which opens in Perfetto (ui.perfetto.dev)
+ * and chrome://tracing. Without a tracer the solvers only test a null
+ * pointer per phase.
+ *
+ * A Tracer may be shared by tags used on several threads at once.
+ */
+class Tracer
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Event
+    {
+        const char *name;       // phase, e.g. "spmv"
+        const char *category;   // e.g. "spmv", "iteration", "setup"
+        std::size_t solver;     // index into solvers()
+        long iteration;         // -1 outside the iteration loop
+        std::size_t thread;     // index in order of first appearance
+        double begin;           // microseconds since construction of the tracer
+        double duration;        // microseconds
+    };
+
+    Tracer() : origin_(Clock::now()) {}
+
+    void record(const char *name, const char *category, const std::string &solver, long iteration,
+                Clock::time_point begin, Clock::time_point end)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        events_.push_back({name, category, solver_index(solver), iteration, thread_index(),
+                           microseconds(begin - origin_), microseconds(end - begin)});
+    }
+
+    // Copies taken under the lock, so they may be read while traced solves are still running
+    std::vector<Event> events() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return events_;
+    }
+
+    std::vector<std::string> solvers() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return solvers_;
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        events_.clear();
+    }
+
+    // Chrome JSON trace: one complete ("X") event per recorded phase
+    void write(std::ostream &out) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto precision = out.precision(15);
+
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        bool first = true;
+        for(std::size_t t = 0; t < threads_.size(); ++t) {
+            out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << t
+                << ",\"args\":{\"name\":\"thread " << t << "\"}}";
+            first = false;
+        }
+        for(const Event &event : events_) {
+            out << (first ? "" : ",") << "\n{\"name\":\"" << event.name << "\",\"cat\":\"" << event.category
+                << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread
+                << ",\"ts\":" << event.begin << ",\"dur\":" << event.duration
+                << ",\"args\":{\"solver\":\"";
+            escape(out, solvers_[event.solver]);
+            out << "\"";
+            if(event.iteration >= 0) {
+                out << ",\"iteration\":" << event.iteration;
+            }
+            out << "}}";
+            first = false;
+        }
+        out << "\n]}\n";
+        out.precision(precision);
+    }
+
+    // Writes the trace to a file, returns false if it cannot be created
+    bool write(const std::string &path) const
+    {
+        std::ofstream out(path);
+        if(!out) {
+            return false;
+        }
+        write(out);
+        return bool(out);
+    }
+
+private:
+    static double microseconds(Clock::duration d)
+    {
+        return std::chrono::duration<double, std::micro>(d).count();
+    }
+
+    static void escape(std::ostream &out, const std::string &s)
+    {
+        for(char c : s) {
+            if(c == '"' || c == '\\') {
+                out << '\\';
+            }
+            out << c;
+        }
+    }
+
+    // Solver names are interned; consecutive events almost always share one
+    std::size_t solver_index(const std::string &solver)
+    {
+        if(!solvers_.empty() && solvers_[last_solver_] == solver) {
+            return last_solver_;
+        }
+        for(last_solver_ = 0; last_solver_ < solvers_.size(); ++last_solver_) {
+            if(solvers_[last_solver_] == solver) {
+                return last_solver_;
+            }
+        }
+        solvers_.push_back(solver);
+        return last_solver_;
+    }
+
+    std::size_t thread_index()
+    {
+        const auto id = std::this_thread::get_id();
+        auto it = threads_.find(id);
+        if(it == threads_.end()) {
+            it = threads_.emplace(id, threads_.size()).first;
+        }
+        return it->second;
+    }
+
+    Clock::time_point origin_;
+    mutable std::mutex mutex_;
+    std::vector<Event> events_;
+    std::vector<std::string> solvers_;
+    std::size_t last_solver_{0};
+    std::map<std::thread::id, std::size_t> threads_;
+};
+
+namespace detail {
+
+/**
+ * Records the time from construction to destruction as one event of the
+ * tracer attached to the tag. Does nothing (not even read the clock) if
+ * the tag has no tracer.
+ */
+class TraceScope
+{
+public:
+    TraceScope(const IterativeTag &tag, const char *name, const char *category, long iteration = -1)
+            : tracer_(tag.tracer()), tag_(tag), name_(name), category_(category), iteration_(iteration)
+    {
+        if(tracer_) {
+            begin_ = Tracer::Clock::now();
+        }
+    }
+
+    ~TraceScope()
+    {
+        if(tracer_) {
+            tracer_->record(name_, category_, tag_.name(), iteration_, begin_, Tracer::Clock::now());
+        }
+    }
+
+    TraceScope(const TraceScope &) = delete;
+
+    TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+    Tracer *tracer_;
+    const IterativeTag &tag_;
+    const char *name_;
+    const char *category_;
+    long iteration_;
+    Tracer::Clock::time_point begin_;
+};
+
+} //end namespace detail
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_TRACE_HPP
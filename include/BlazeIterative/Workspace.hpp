@@ -0,0 +1,99 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_WORKSPACE_HPP
+#define BLAZE_ITERATIVE_WORKSPACE_HPP
+
+#include "IterativeCommon.hpp"
+#include "LinearOperator.hpp"
+#include <cstddef>
+#include <type_traits>
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+namespace detail {
+
+/*
+ * Building blocks of the workspace_impl overloads next to each solver.
+ * A workspace is the peak of the memory a solve allocates in addition to
+ * A, b and x, counting the elements of the Blaze vectors and matrices;
+ * SIMD padding and allocator overhead are not included, nor is memory
+ * that lives on in the tag (convergence history, recycled spaces).
+ */
+
+// Bytes of a dense rows x columns array with elements of the given size
+constexpr std::size_t dense_bytes(std::size_t rows, std::size_t columns, std::size_t element_size)
+{
+    return rows * columns * element_size;
+}
+
+// Bytes of a CompressedMatrix with n rows
+template<typename T>
+constexpr std::size_t sparse_bytes(std::size_t n, std::size_t nonzeros)
+{
+    return nonzeros * (sizeof(T) + sizeof(std::size_t)) + (n + 1) * sizeof(std::size_t);
+}
+
+// Bytes of a triangular factor: the CompressedMatrix it is computed in and its SparseTriangularSolver
+template<typename T>
+constexpr std::size_t factor_bytes(std::size_t n, std::size_t nonzeros)
+{
+    return 2 * sparse_bytes<T>(n, nonzeros) + n * (2 * sizeof(std::size_t) + sizeof(T));
+}
+
+template<typename MatrixType>
+std::size_t matrix_nonzeros(const MatrixType &A, std::true_type)
+{
+    return A.rows() * A.columns();
+}
+
+template<typename MatrixType>
+std::size_t matrix_nonzeros(const MatrixType &A, std::false_type)
+{
+    return nonZeros(A);
+}
+
+// Stored entries of A, all of them for dense matrices
+template<typename MatrixType>
+std::enable_if_t<IsMatrix<MatrixType>::value, std::size_t> matrix_nonzeros(const MatrixType &A)
+{
+    return matrix_nonzeros(A, std::integral_constant<bool, IsDenseMatrix<MatrixType>::value>());
+}
+
+// ... or the entries an operator reports, without assembling its matrix
+template<typename MatrixType>
+std::enable_if_t<!IsMatrix<MatrixType>::value, std::size_t> matrix_nonzeros(const MatrixType &A)
+{
+    return A.nonZeros();
+}
+
+/**
+ * The largest n in [1, n_max] whose workspace bytes(n) fits into budget,
+ * or 1 if none does; bytes must grow with n.
+ */
+template<typename Bytes>
+std::size_t largest_fitting(std::size_t n_max, std::size_t budget, Bytes bytes)
+{
+    std::size_t low = 1;
+    std::size_t high = n_max;
+    while(low < high) {
+        const std::size_t middle = low + (high - low + 1) / 2;
+        if(bytes(middle) <= budget) {
+            low = middle;
+        } else {
+            high = middle - 1;
+        }
+    }
+    return low;
+}
+
+} //end namespace detail
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_WORKSPACE_HPP
@@ -0,0 +1,138 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_BATCHEDBICGSTAB_HPP
+#define BLAZE_ITERATIVE_BATCHEDBICGSTAB_HPP
+
+#include <BlazeIterative/IterativeCommon.hpp>
+#include <BlazeIterative/solvers/BiCGSTABTag.hpp>
+#include "BatchedStorage.hpp"
+#include "BatchedKernels.hpp"
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+namespace detail {
+
+/**
+ * BiCGSTAB on the W systems of one chunk. Unlike the scalar solver the
+ * convergence test uses the recursively updated residual r = s - w t,
+ * which saves one product with A per iteration. Lanes that converged or
+ * broke down get zero step lengths and no longer change.
+ */
+template<typename T, std::size_t W>
+void batched_bicgstab_chunk(const T *A, const T *b, T *x, std::size_t n,
+                            const BiCGSTABTag &tag, T *workspace,
+                            TerminationStatus *status, std::size_t *iterations)
+{
+    T *r = workspace;
+    T *r0 = r + n * W;
+    T *p = r0 + n * W;
+    T *v = p + n * W;
+    T *s = v + n * W;
+    T *t = s + n * W;
+
+    T rr[W], rr0[W], rho[W], rho_prev[W], alpha[W], omega[W], beta[W], r0v[W], tt[W], ts[W];
+    bool active[W];
+    std::size_t active_count = 0;
+
+    lane_residual<T, W>(A, x, b, r, n);
+    for(std::size_t i = 0; i < n * W; ++i) {
+        r0[i] = r[i];
+        p[i] = T(0);
+        v[i] = T(0);
+    }
+    lane_dot<T, W>(r, r, rr0, n);
+
+    for(std::size_t l = 0; l < W; ++l) {
+        rho_prev[l] = alpha[l] = omega[l] = T(1);
+        active[l] = rr0[l] != T(0);
+        status[l] = active[l] ? TerminationStatus::NOT_TERMINATED : TerminationStatus::CONVERGED_ABSOLUTE_RESIDUAL;
+        iterations[l] = 0;
+        active_count += active[l];
+    }
+
+    for(std::size_t iteration = 0; active_count > 0; ++iteration) {
+        lane_dot<T, W>(r0, r, rho, n);
+        for(std::size_t l = 0; l < W; ++l) {
+            const T denominator = rho_prev[l] * omega[l];
+            beta[l] = active[l] && denominator != T(0) ? (rho[l] * alpha[l]) / denominator : T(0);
+        }
+
+        // p = r + beta (p - omega v)
+        for(std::size_t i = 0; i < n; ++i) {
+#pragma omp simd
+            for(std::size_t l = 0; l < W; ++l) {
+                p[i * W + l] = r[i * W + l] + beta[l] * (p[i * W + l] - omega[l] * v[i * W + l]);
+            }
+        }
+
+        lane_multiply<T, W>(A, p, v, n);
+        lane_dot<T, W>(r0, v, r0v, n);
+        for(std::size_t l = 0; l < W; ++l) {
+            alpha[l] = active[l] && r0v[l] != T(0) ? rho[l] / r0v[l] : T(0);
+        }
+
+        // s = r - alpha v
+        for(std::size_t i = 0; i < n; ++i) {
+#pragma omp simd
+            for(std::size_t l = 0; l < W; ++l) {
+                s[i * W + l] = r[i * W + l] - alpha[l] * v[i * W + l];
+            }
+        }
+
+        lane_multiply<T, W>(A, s, t, n);
+        lane_dot<T, W>(t, t, tt, n);
+        lane_dot<T, W>(t, s, ts, n);
+        for(std::size_t l = 0; l < W; ++l) {
+            omega[l] = active[l] && tt[l] != T(0) ? ts[l] / tt[l] : T(0);
+        }
+
+        // x += alpha p + omega s, r = s - omega t
+        for(std::size_t i = 0; i < n; ++i) {
+#pragma omp simd
+            for(std::size_t l = 0; l < W; ++l) {
+                x[i * W + l] += alpha[l] * p[i * W + l] + omega[l] * s[i * W + l];
+                r[i * W + l] = s[i * W + l] - omega[l] * t[i * W + l];
+            }
+        }
+        lane_dot<T, W>(r, r, rr, n);
+
+        for(std::size_t l = 0; l < W; ++l) {
+            if(active[l]) {
+                status[l] = lane_status(tag, iteration, rr[l], rr[l] / rr0[l]);
+                if(status[l] != TerminationStatus::NOT_TERMINATED) {
+                    active[l] = false;
+                    iterations[l] = iteration + 1;
+                    --active_count;
+                }
+            }
+            rho_prev[l] = rho[l];
+        }
+    }
+}
+
+template<typename T, std::size_t W>
+void batched_solve_impl(BatchedVector<T, W> &x,
+                        const BatchedMatrix<T, W> &A,
+                        const BatchedVector<T, W> &b,
+                        BiCGSTABTag &tag,
+                        BatchedSolveStatus &result)
+{
+    const std::size_t n = A.rows();
+
+    for_each_chunk<T>(A.chunks(), 6 * n * W, [&](std::size_t c, T *workspace) {
+        batched_bicgstab_chunk<T, W>(A.chunk(c), b.chunk(c), x.chunk(c), n, tag, workspace,
+                                     result.status.data() + c * W, result.iterations.data() + c * W);
+    });
+}
+
+} //end namespace detail
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_BATCHEDBICGSTAB_HPP
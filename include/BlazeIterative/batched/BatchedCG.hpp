@@ -0,0 +1,101 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_BATCHEDCG_HPP
+#define BLAZE_ITERATIVE_BATCHEDCG_HPP
+
+#include <BlazeIterative/IterativeCommon.hpp>
+#include <BlazeIterative/solvers/ConjugateGradientTag.hpp>
+#include "BatchedStorage.hpp"
+#include "BatchedKernels.hpp"
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+namespace detail {
+
+/**
+ * CG on the W systems of one chunk, with the same residual measure as the
+ * scalar solver (squared residual norm relative to the initial one).
+ * Converged lanes get alpha = beta = 0 and no longer change.
+ */
+template<typename T, std::size_t W>
+void batched_cg_chunk(const T *A, const T *b, T *x, std::size_t n,
+                      const ConjugateGradientTag &tag, T *workspace,
+                      TerminationStatus *status, std::size_t *iterations)
+{
+    T *r = workspace;
+    T *p = r + n * W;
+    T *Ap = p + n * W;
+
+    T rr[W], rr0[W], rr_new[W], pAp[W], alpha[W], beta[W];
+    bool active[W];
+    std::size_t active_count = 0;
+
+    lane_residual<T, W>(A, x, b, r, n);
+    for(std::size_t i = 0; i < n * W; ++i) {
+        p[i] = r[i];
+    }
+    lane_dot<T, W>(r, r, rr0, n);
+
+    for(std::size_t l = 0; l < W; ++l) {
+        rr[l] = rr0[l];
+        active[l] = rr0[l] != T(0);
+        status[l] = active[l] ? TerminationStatus::NOT_TERMINATED : TerminationStatus::CONVERGED_ABSOLUTE_RESIDUAL;
+        iterations[l] = 0;
+        active_count += active[l];
+    }
+
+    for(std::size_t iteration = 0; active_count > 0; ++iteration) {
+        lane_multiply<T, W>(A, p, Ap, n);
+        lane_dot<T, W>(p, Ap, pAp, n);
+        for(std::size_t l = 0; l < W; ++l) {
+            alpha[l] = active[l] ? rr[l] / pAp[l] : T(0);
+        }
+        lane_axpy<T, W>(alpha, p, x, n);
+        for(std::size_t l = 0; l < W; ++l) {
+            alpha[l] = -alpha[l];
+        }
+        lane_axpy<T, W>(alpha, Ap, r, n);
+        lane_dot<T, W>(r, r, rr_new, n);
+
+        for(std::size_t l = 0; l < W; ++l) {
+            if(active[l]) {
+                status[l] = lane_status(tag, iteration, rr_new[l], rr_new[l] / rr0[l]);
+                if(status[l] != TerminationStatus::NOT_TERMINATED) {
+                    active[l] = false;
+                    iterations[l] = iteration + 1;
+                    --active_count;
+                }
+            }
+            beta[l] = active[l] ? rr_new[l] / rr[l] : T(0);
+            rr[l] = rr_new[l];
+        }
+        lane_xpay<T, W>(r, beta, p, n);
+    }
+}
+
+template<typename T, std::size_t W>
+void batched_solve_impl(BatchedVector<T, W> &x,
+                        const BatchedMatrix<T, W> &A,
+                        const BatchedVector<T, W> &b,
+                        ConjugateGradientTag &tag,
+                        BatchedSolveStatus &result)
+{
+    const std::size_t n = A.rows();
+
+    for_each_chunk<T>(A.chunks(), 3 * n * W, [&](std::size_t c, T *workspace) {
+        batched_cg_chunk<T, W>(A.chunk(c), b.chunk(c), x.chunk(c), n, tag, workspace,
+                               result.status.data() + c * W, result.iterations.data() + c * W);
+    });
+}
+
+} //end namespace detail
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_BATCHEDCG_HPP
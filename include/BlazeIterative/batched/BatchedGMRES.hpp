@@ -0,0 +1,216 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_BATCHEDGMRES_HPP
+#define BLAZE_ITERATIVE_BATCHEDGMRES_HPP
+
+#include <BlazeIterative/IterativeCommon.hpp>
+#include <BlazeIterative/solvers/GMRESTag.hpp>
+#include "BatchedStorage.hpp"
+#include "BatchedKernels.hpp"
+#include <algorithm>
+#include <cmath>
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+namespace detail {
+
+/**
+ * Restarted GMRES(m) on the W systems of one chunk, with the residual
+ * measure of the scalar solver (||r|| / ||b||). All lanes run the Arnoldi
+ * process in lockstep; a lane that converges or breaks down stops at its
+ * own step count steps[l], and its later basis vectors are zero. At the end
+ * of a cycle every lane solves its own steps[l] x steps[l] system.
+ */
+template<typename T, std::size_t W>
+void batched_gmres_chunk(const T *A, const T *b, T *x, std::size_t n, std::size_t m,
+                         const GMRESTag &tag, T *workspace,
+                         TerminationStatus *status, std::size_t *iterations)
+{
+    // Q: (m+1) basis vectors, H(i,j) at H[(j * (m+1) + i) * W]
+    T *Q = workspace;
+    T *H = Q + (m + 1) * n * W;
+    T *cs = H + (m + 1) * m * W;
+    T *sn = cs + m * W;
+    T *g = sn + m * W;
+    T *y = g + (m + 1) * W;
+    T *w = y + m * W;
+    T *r = w + n * W;
+
+    T norm_b[W], beta[W], h[W];
+    std::size_t steps[W];
+    bool done[W], running[W];
+    std::size_t remaining = 0;
+
+    lane_dot<T, W>(b, b, norm_b, n);
+    for(std::size_t l = 0; l < W; ++l) {
+        norm_b[l] = std::sqrt(norm_b[l]);
+        done[l] = norm_b[l] == T(0);
+        status[l] = done[l] ? TerminationStatus::CONVERGED_ABSOLUTE_RESIDUAL : TerminationStatus::NOT_TERMINATED;
+        iterations[l] = 0;
+        remaining += !done[l];
+    }
+    for(std::size_t i = 0; i < n; ++i) {
+        for(std::size_t l = 0; l < W; ++l) {
+            if(done[l]) {
+                x[i * W + l] = T(0);
+            }
+        }
+    }
+
+    lane_residual<T, W>(A, x, b, r, n);
+
+    while(remaining > 0) {
+        lane_dot<T, W>(r, r, beta, n);
+        std::size_t running_count = 0;
+        for(std::size_t l = 0; l < W; ++l) {
+            beta[l] = std::sqrt(beta[l]);
+            if(!done[l] && beta[l] == T(0)) {
+                status[l] = lane_status(tag, iterations[l], T(0), T(0));
+                done[l] = status[l] != TerminationStatus::NOT_TERMINATED;
+                remaining -= done[l];
+            }
+            running[l] = !done[l] && beta[l] != T(0);
+            steps[l] = 0;
+            running_count += running[l];
+        }
+        if(running_count == 0) {
+            break;
+        }
+
+        std::fill(g, g + (m + 1) * W, T(0));
+        std::fill(H, H + (m + 1) * m * W, T(0));
+        for(std::size_t l = 0; l < W; ++l) {
+            g[l] = running[l] ? beta[l] : T(0);
+            h[l] = running[l] ? T(1) / beta[l] : T(0);
+        }
+        for(std::size_t i = 0; i < n; ++i) {
+#pragma omp simd
+            for(std::size_t l = 0; l < W; ++l) {
+                Q[i * W + l] = h[l] * r[i * W + l];
+            }
+        }
+
+        std::size_t k = 0;
+        for(; k < m && running_count > 0; ++k) {
+            T *Hk = H + k * (m + 1) * W;
+
+            // Arnoldi step with modified Gram-Schmidt
+            lane_multiply<T, W>(A, Q + k * n * W, w, n);
+            for(std::size_t i = 0; i <= k; ++i) {
+                const T *Qi = Q + i * n * W;
+                lane_dot<T, W>(Qi, w, Hk + i * W, n);
+                for(std::size_t l = 0; l < W; ++l) {
+                    h[l] = -Hk[i * W + l];
+                }
+                lane_axpy<T, W>(h, Qi, w, n);
+            }
+            lane_dot<T, W>(w, w, Hk + (k + 1) * W, n);
+
+            bool regular[W];
+            for(std::size_t l = 0; l < W; ++l) {
+                Hk[(k + 1) * W + l] = std::sqrt(Hk[(k + 1) * W + l]);
+                regular[l] = running[l] && Hk[(k + 1) * W + l] > T(1e-14) * beta[l];
+                h[l] = regular[l] ? T(1) / Hk[(k + 1) * W + l] : T(0);
+            }
+            T *Qk1 = Q + (k + 1) * n * W;
+            for(std::size_t i = 0; i < n; ++i) {
+#pragma omp simd
+                for(std::size_t l = 0; l < W; ++l) {
+                    Qk1[i * W + l] = h[l] * w[i * W + l];
+                }
+            }
+
+            // Givens rotations of column k, per lane
+            for(std::size_t i = 0; i < k; ++i) {
+#pragma omp simd
+                for(std::size_t l = 0; l < W; ++l) {
+                    const T temp = cs[i * W + l] * Hk[i * W + l] + sn[i * W + l] * Hk[(i + 1) * W + l];
+                    Hk[(i + 1) * W + l] = -sn[i * W + l] * Hk[i * W + l] + cs[i * W + l] * Hk[(i + 1) * W + l];
+                    Hk[i * W + l] = temp;
+                }
+            }
+            for(std::size_t l = 0; l < W; ++l) {
+                const T v1 = Hk[k * W + l];
+                const T v2 = Hk[(k + 1) * W + l];
+                const T denom = std::sqrt(v1 * v1 + v2 * v2);
+                cs[k * W + l] = denom == T(0) ? T(1) : v1 / denom;
+                sn[k * W + l] = denom == T(0) ? T(0) : v2 / denom;
+                Hk[k * W + l] = denom;
+                Hk[(k + 1) * W + l] = T(0);
+                g[(k + 1) * W + l] = -sn[k * W + l] * g[k * W + l];
+                g[k * W + l] = cs[k * W + l] * g[k * W + l];
+            }
+
+            for(std::size_t l = 0; l < W; ++l) {
+                if(!running[l]) {
+                    continue;
+                }
+                steps[l] = k + 1;
+
+                const T absolute_residual = std::abs(g[(k + 1) * W + l]);
+                status[l] = lane_status(tag, iterations[l], absolute_residual, absolute_residual / norm_b[l]);
+                if(status[l] != TerminationStatus::NOT_TERMINATED) {
+                    done[l] = true;
+                    --remaining;
+                }
+                ++iterations[l];
+
+                // Converged or (lucky) breakdown: this lane's cycle ends here
+                if(done[l] || !regular[l]) {
+                    running[l] = false;
+                    --running_count;
+                }
+            }
+        }
+
+        // Back-substitution per lane, y is zero beyond steps[l]
+        std::fill(y, y + m * W, T(0));
+        for(std::size_t i = k; i-- > 0; ) {
+            for(std::size_t l = 0; l < W; ++l) {
+                if(i >= steps[l]) {
+                    continue;
+                }
+                T sum = g[i * W + l];
+                for(std::size_t j = i + 1; j < steps[l]; ++j) {
+                    sum -= H[(j * (m + 1) + i) * W + l] * y[j * W + l];
+                }
+                y[i * W + l] = sum / H[(i * (m + 1) + i) * W + l];
+            }
+        }
+        for(std::size_t j = 0; j < k; ++j) {
+            lane_axpy<T, W>(y + j * W, Q + j * n * W, x, n);
+        }
+
+        lane_residual<T, W>(A, x, b, r, n);
+    }
+}
+
+template<typename T, std::size_t W>
+void batched_solve_impl(BatchedVector<T, W> &x,
+                        const BatchedMatrix<T, W> &A,
+                        const BatchedVector<T, W> &b,
+                        GMRESTag &tag,
+                        BatchedSolveStatus &result)
+{
+    const std::size_t n = A.rows();
+    const std::size_t m = std::max<std::size_t>(std::min(tag.restart(), n), 1);
+    const std::size_t workspace = (m + 1) * n * W + (m + 1) * m * W + 2 * m * W
+                                  + (m + 1) * W + m * W + 2 * n * W;
+
+    for_each_chunk<T>(A.chunks(), workspace, [&](std::size_t c, T *buffer) {
+        batched_gmres_chunk<T, W>(A.chunk(c), b.chunk(c), x.chunk(c), n, m, tag, buffer,
+                                  result.status.data() + c * W, result.iterations.data() + c * W);
+    });
+}
+
+} //end namespace detail
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_BATCHEDGMRES_HPP
@@ -0,0 +1,139 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_BATCHEDKERNELS_HPP
+#define BLAZE_ITERATIVE_BATCHEDKERNELS_HPP
+
+#include <BlazeIterative/IterativeCommon.hpp>
+#include <BlazeIterative/TerminationStatus.hpp>
+#include <cmath>
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+namespace detail {
+
+/*
+ * Kernels on one chunk of W interleaved systems. A vector of length n is
+ * stored as v[i * W + lane], a matrix as A[(i * n + j) * W + lane], and
+ * per-lane scalars as arrays of length W. The innermost loop always runs
+ * over the lanes, so every operation is a SIMD operation across systems.
+ */
+
+// y = A x
+template<typename T, std::size_t W>
+inline void lane_multiply(const T *A, const T *x, T *y, std::size_t n)
+{
+    for(std::size_t i = 0; i < n; ++i) {
+        T *yi = y + i * W;
+#pragma omp simd
+        for(std::size_t l = 0; l < W; ++l) {
+            yi[l] = T(0);
+        }
+        for(std::size_t j = 0; j < n; ++j) {
+            const T *a = A + (i * n + j) * W;
+            const T *xj = x + j * W;
+#pragma omp simd
+            for(std::size_t l = 0; l < W; ++l) {
+                yi[l] += a[l] * xj[l];
+            }
+        }
+    }
+}
+
+// d = x^T y for every lane
+template<typename T, std::size_t W>
+inline void lane_dot(const T *x, const T *y, T *d, std::size_t n)
+{
+#pragma omp simd
+    for(std::size_t l = 0; l < W; ++l) {
+        d[l] = T(0);
+    }
+    for(std::size_t i = 0; i < n; ++i) {
+#pragma omp simd
+        for(std::size_t l = 0; l < W; ++l) {
+            d[l] += x[i * W + l] * y[i * W + l];
+        }
+    }
+}
+
+// y += alpha x
+template<typename T, std::size_t W>
+inline void lane_axpy(const T *alpha, const T *x, T *y, std::size_t n)
+{
+    for(std::size_t i = 0; i < n; ++i) {
+#pragma omp simd
+        for(std::size_t l = 0; l < W; ++l) {
+            y[i * W + l] += alpha[l] * x[i * W + l];
+        }
+    }
+}
+
+// y = x + beta y
+template<typename T, std::size_t W>
+inline void lane_xpay(const T *x, const T *beta, T *y, std::size_t n)
+{
+    for(std::size_t i = 0; i < n; ++i) {
+#pragma omp simd
+        for(std::size_t l = 0; l < W; ++l) {
+            y[i * W + l] = x[i * W + l] + beta[l] * y[i * W + l];
+        }
+    }
+}
+
+// r = b - A x
+template<typename T, std::size_t W>
+inline void lane_residual(const T *A, const T *x, const T *b, T *r, std::size_t n)
+{
+    lane_multiply<T, W>(A, x, r, n);
+    for(std::size_t i = 0; i < n * W; ++i) {
+        r[i] = b[i] - r[i];
+    }
+}
+
+/**
+ * Calls f(c, workspace) for every chunk c. Chunks are distributed over
+ * the OpenMP threads, and every thread allocates its workspace of the
+ * given number of elements once, not per chunk.
+ */
+template<typename T, typename F>
+void for_each_chunk(std::size_t chunks, std::size_t workspace_size, F f)
+{
+#pragma omp parallel
+    {
+        DynamicVector<T> workspace(workspace_size);
+
+#pragma omp for schedule(dynamic)
+        for(long c = 0; c < static_cast<long>(chunks); ++c) {
+            f(static_cast<std::size_t>(c), workspace.data());
+        }
+    }
+}
+
+/**
+ * Termination test of IterativeTag::terminateIteration() for a single
+ * lane; the tag itself is not modified since every lane has its own status.
+ */
+template<typename TagType>
+inline TerminationStatus lane_status(const TagType &tag, std::size_t iteration,
+                                     double absolute_residual, double relative_residual)
+{
+    if(std::abs(relative_residual) < tag.relativeResidualTolerance()) {
+        return TerminationStatus::CONVERGED_RELATIVE_RESIDUAL;
+    } else if(std::abs(absolute_residual) < tag.absoluteResidualTolerance()) {
+        return TerminationStatus::CONVERGED_ABSOLUTE_RESIDUAL;
+    } else if(iteration >= tag.maximumIterations()) {
+        return TerminationStatus::ITERATION_LIMIT;
+    }
+    return TerminationStatus::NOT_TERMINATED;
+}
+
+} //end namespace detail
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_BATCHEDKERNELS_HPP
@@ -0,0 +1,150 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_BATCHEDSTORAGE_HPP
+#define BLAZE_ITERATIVE_BATCHEDSTORAGE_HPP
+
+#include <BlazeIterative/IterativeCommon.hpp>
+#include <BlazeIterative/TerminationStatus.hpp>
+#include <cassert>
+#include <vector>
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+/**
+ * \class BatchedMatrix
+ * \brief Many dense n x n systems in an interleaved struct-of-arrays layout.
+ *
+ * The systems are grouped into chunks of W; within a chunk, entry (i,j)
+ * of all W systems is stored contiguously, so system k occupies SIMD lane
+ * k % W of chunk k / W. The unused lanes of the last chunk hold identity
+ * matrices and never take part in a solve.
+ */
+template<typename T, std::size_t W = 8>
+class BatchedMatrix
+{
+public:
+    BatchedMatrix(std::size_t count, std::size_t n)
+            : count_(count), n_(n), data_(((count + W - 1) / W) * n * n * W, T(0))
+    {
+        for(std::size_t k = count; k < chunks() * W; ++k) {
+            for(std::size_t i = 0; i < n; ++i) {
+                (*this)(k, i, i) = T(1);
+            }
+        }
+    }
+
+    // Number of systems
+    std::size_t size() const { return count_; }
+
+    // Dimension of every system
+    std::size_t rows() const { return n_; }
+
+    std::size_t chunks() const { return (count_ + W - 1) / W; }
+
+    T &operator()(std::size_t system, std::size_t i, std::size_t j)
+    {
+        return data_[((system / W) * n_ * n_ + i * n_ + j) * W + system % W];
+    }
+
+    const T &operator()(std::size_t system, std::size_t i, std::size_t j) const
+    {
+        return data_[((system / W) * n_ * n_ + i * n_ + j) * W + system % W];
+    }
+
+    template<typename MT>
+    void setSystem(std::size_t system, const MT &A)
+    {
+        assert(A.rows() == n_ && A.columns() == n_ && "A must be an n x n matrix");
+        for(std::size_t i = 0; i < n_; ++i) {
+            for(std::size_t j = 0; j < n_; ++j) {
+                (*this)(system, i, j) = A(i, j);
+            }
+        }
+    }
+
+    const T *chunk(std::size_t c) const { return data_.data() + c * n_ * n_ * W; }
+
+private:
+    std::size_t count_;
+    std::size_t n_;
+    DynamicVector<T> data_;
+};
+
+/**
+ * \class BatchedVector
+ * \brief One vector of length n per system, interleaved like BatchedMatrix.
+ */
+template<typename T, std::size_t W = 8>
+class BatchedVector
+{
+public:
+    BatchedVector(std::size_t count, std::size_t n, T value = T(0))
+            : count_(count), n_(n), data_(((count + W - 1) / W) * n * W, value)
+    {
+        for(std::size_t k = count; k < chunks() * W; ++k) {
+            for(std::size_t i = 0; i < n; ++i) {
+                (*this)(k, i) = T(0);
+            }
+        }
+    }
+
+    std::size_t size() const { return count_; }
+
+    std::size_t rows() const { return n_; }
+
+    std::size_t chunks() const { return (count_ + W - 1) / W; }
+
+    T &operator()(std::size_t system, std::size_t i)
+    {
+        return data_[((system / W) * n_ + i) * W + system % W];
+    }
+
+    const T &operator()(std::size_t system, std::size_t i) const
+    {
+        return data_[((system / W) * n_ + i) * W + system % W];
+    }
+
+    template<typename VT>
+    void setSystem(std::size_t system, const VT &v)
+    {
+        assert(v.size() == n_ && "v must have length n");
+        for(std::size_t i = 0; i < n_; ++i) {
+            (*this)(system, i) = v[i];
+        }
+    }
+
+    DynamicVector<T> system(std::size_t system) const
+    {
+        DynamicVector<T> v(n_);
+        for(std::size_t i = 0; i < n_; ++i) {
+            v[i] = (*this)(system, i);
+        }
+        return v;
+    }
+
+    T *chunk(std::size_t c) { return data_.data() + c * n_ * W; }
+
+    const T *chunk(std::size_t c) const { return data_.data() + c * n_ * W; }
+
+private:
+    std::size_t count_;
+    std::size_t n_;
+    DynamicVector<T> data_;
+};
+
+// Per-system outcome of a batched solve
+struct BatchedSolveStatus
+{
+    std::vector<TerminationStatus> status;
+    std::vector<std::size_t> iterations;
+};
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_BATCHEDSTORAGE_HPP
@@ -0,0 +1,290 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_IO_BINARYCSR_HPP
+#define BLAZE_ITERATIVE_IO_BINARYCSR_HPP
+
+#include <BlazeIterative/IterativeCommon.hpp>
+#include <BlazeIterative/LinearOperator.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+/*
+ * Binary CSR file layout (native byte order, every field 8 byte aligned):
+ *   header                        BinaryCSRHeader
+ *   row pointers                  (rows + 1) x uint64
+ *   column indices                nonzeros x uint64, sorted within each row
+ *   values                        nonzeros x value_size bytes
+ */
+struct BinaryCSRHeader
+{
+    char magic[8];
+    std::uint64_t version;
+    std::uint64_t rows;
+    std::uint64_t columns;
+    std::uint64_t nonzeros;
+    std::uint64_t value_size;
+};
+
+namespace detail {
+
+inline BinaryCSRHeader binary_csr_header(std::size_t rows, std::size_t columns,
+                                         std::size_t nonzeros, std::size_t value_size)
+{
+    BinaryCSRHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "BLZCSR01", 8);
+    header.version = 1;
+    header.rows = rows;
+    header.columns = columns;
+    header.nonzeros = nonzeros;
+    header.value_size = value_size;
+    return header;
+}
+
+inline std::size_t binary_csr_padding(std::size_t bytes)
+{
+    return (8 - bytes % 8) % 8;
+}
+
+} //end namespace detail
+
+/**
+ * \brief Writes A in the native binary CSR format read by MappedCSRMatrix.
+ *
+ * Converting a matrix once (e.g. after read_matrix_market()) makes every
+ * later run start without parsing. Throws std::runtime_error on I/O errors.
+ */
+template<typename T>
+void write_binary_csr(const std::string &path, const CompressedMatrix<T, rowMajor> &A)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if(!out) {
+        throw std::runtime_error("Cannot create binary CSR file " + path);
+    }
+
+    const std::size_t rows = A.rows();
+    const std::size_t nonzeros = A.nonZeros();
+    const BinaryCSRHeader header = detail::binary_csr_header(rows, A.columns(), nonzeros, sizeof(T));
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    std::uint64_t offset = 0;
+    out.write(reinterpret_cast<const char *>(&offset), sizeof(offset));
+    for(std::size_t i = 0; i < rows; ++i) {
+        offset += A.nonZeros(i);
+        out.write(reinterpret_cast<const char *>(&offset), sizeof(offset));
+    }
+
+    for(std::size_t i = 0; i < rows; ++i) {
+        for(auto element = A.begin(i); element != A.end(i); ++element) {
+            const std::uint64_t j = element->index();
+            out.write(reinterpret_cast<const char *>(&j), sizeof(j));
+        }
+    }
+
+    for(std::size_t i = 0; i < rows; ++i) {
+        for(auto element = A.begin(i); element != A.end(i); ++element) {
+            const T value = element->value();
+            out.write(reinterpret_cast<const char *>(&value), sizeof(value));
+        }
+    }
+
+    const char zeros[8] = {};
+    out.write(zeros, detail::binary_csr_padding(nonzeros * sizeof(T)));
+
+    if(!out) {
+        throw std::runtime_error("Error while writing binary CSR file " + path);
+    }
+}
+
+/**
+ * \brief Read-only sparse operator backed by a memory-mapped binary CSR file.
+ *
+ * Opening the file only maps it: nothing is parsed or copied, and pages
+ * are read from disk on first use by the matrix-vector product, so very
+ * large matrices are ready to use immediately. The operator can be passed
+ * to solve() and solve_inplace() with the solvers that apply A only by
+ * matrix-vector products (CG, BiCGSTAB, GMRES, FGMRES, GCRO-DR, deflated CG).
+ */
+template<typename T>
+class MappedCSRMatrix
+{
+public:
+    using ElementType = T;
+
+    explicit MappedCSRMatrix(const std::string &path)
+    {
+        fd_ = ::open(path.c_str(), O_RDONLY);
+        struct stat info;
+        if(fd_ < 0 || ::fstat(fd_, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(BinaryCSRHeader)) {
+            release();
+            throw std::runtime_error("Cannot open binary CSR file " + path);
+        }
+        size_ = static_cast<std::size_t>(info.st_size);
+
+        void *p = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0);
+        if(p == MAP_FAILED) {
+            release();
+            throw std::runtime_error("Cannot map binary CSR file " + path);
+        }
+        map_ = p;
+        ::madvise(map_, size_, MADV_SEQUENTIAL);
+
+        const BinaryCSRHeader &header = *static_cast<const BinaryCSRHeader *>(map_);
+        rows_ = header.rows;
+        columns_ = header.columns;
+        nonzeros_ = header.nonzeros;
+
+        const std::size_t expected = sizeof(BinaryCSRHeader) + (rows_ + 1 + nonzeros_) * sizeof(std::uint64_t)
+                                     + nonzeros_ * sizeof(T) + detail::binary_csr_padding(nonzeros_ * sizeof(T));
+        if(std::memcmp(header.magic, "BLZCSR01", 8) != 0 || header.version != 1
+           || header.value_size != sizeof(T) || expected != size_) {
+            release();
+            throw std::runtime_error(path + " is not a binary CSR file with this element type");
+        }
+
+        const unsigned char *data = static_cast<const unsigned char *>(map_) + sizeof(BinaryCSRHeader);
+        row_pointers_ = reinterpret_cast<const std::uint64_t *>(data);
+        column_indices_ = row_pointers_ + rows_ + 1;
+        values_ = reinterpret_cast<const T *>(column_indices_ + nonzeros_);
+    }
+
+    MappedCSRMatrix(const MappedCSRMatrix &) = delete;
+
+    MappedCSRMatrix &operator=(const MappedCSRMatrix &) = delete;
+
+    MappedCSRMatrix(MappedCSRMatrix &&other) noexcept { *this = std::move(other); }
+
+    MappedCSRMatrix &operator=(MappedCSRMatrix &&other) noexcept
+    {
+        if(this != &other) {
+            release();
+            std::swap(fd_, other.fd_);
+            std::swap(map_, other.map_);
+            std::swap(size_, other.size_);
+            rows_ = other.rows_;
+            columns_ = other.columns_;
+            nonzeros_ = other.nonzeros_;
+            row_pointers_ = other.row_pointers_;
+            column_indices_ = other.column_indices_;
+            values_ = other.values_;
+        }
+        return *this;
+    }
+
+    ~MappedCSRMatrix() { release(); }
+
+    std::size_t rows() const { return rows_; }
+
+    std::size_t columns() const { return columns_; }
+
+    std::size_t nonZeros() const { return nonzeros_; }
+
+    const std::uint64_t *rowPointers() const { return row_pointers_; }
+
+    const std::uint64_t *columnIndices() const { return column_indices_; }
+
+    const T *values() const { return values_; }
+
+private:
+    void release()
+    {
+        if(map_ != nullptr) {
+            ::munmap(map_, size_);
+        }
+        if(fd_ >= 0) {
+            ::close(fd_);
+        }
+        map_ = nullptr;
+        fd_ = -1;
+        size_ = 0;
+    }
+
+    int fd_{-1};
+    void *map_{nullptr};
+    std::size_t size_{0};
+    std::size_t rows_{0};
+    std::size_t columns_{0};
+    std::size_t nonzeros_{0};
+    const std::uint64_t *row_pointers_{nullptr};
+    const std::uint64_t *column_indices_{nullptr};
+    const T *values_{nullptr};
+};
+
+template<typename T>
+struct IsLinearOperator<MappedCSRMatrix<T>> : public std::true_type
+{};
+
+// y = A * x, row-parallel if OpenMP is enabled
+template<typename T, typename VT, typename TY>
+void multiply(DynamicVector<TY> &y, const MappedCSRMatrix<T> &A, const VT &x)
+{
+    const std::uint64_t *row_pointers = A.rowPointers();
+    const std::uint64_t *column_indices = A.columnIndices();
+    const T *values = A.values();
+    const long rows = static_cast<long>(A.rows());
+
+    y.resize(A.rows(), false);
+
+#pragma omp parallel for schedule(static)
+    for(long i = 0; i < rows; ++i) {
+        TY sum(0);
+        for(std::uint64_t k = row_pointers[i]; k < row_pointers[i + 1]; ++k) {
+            sum += values[k] * x[column_indices[k]];
+        }
+        y[i] = sum;
+    }
+}
+
+// The file stores both triangles, so the symmetric product is the plain one
+template<typename T, typename VT, typename TY>
+void symmetric_multiply(DynamicVector<TY> &y, const MappedCSRMatrix<T> &A, const VT &x)
+{
+    multiply(y, A, x);
+}
+
+template<typename T>
+bool isSymmetric(const MappedCSRMatrix<T> &A)
+{
+    if(A.rows() != A.columns()) {
+        return false;
+    }
+
+    const std::uint64_t *row_pointers = A.rowPointers();
+    const std::uint64_t *column_indices = A.columnIndices();
+    const T *values = A.values();
+    for(std::size_t i = 0; i < A.rows(); ++i) {
+        for(std::uint64_t k = row_pointers[i]; k < row_pointers[i + 1]; ++k) {
+            const std::uint64_t j = column_indices[k];
+            const std::uint64_t *first = column_indices + row_pointers[j];
+            const std::uint64_t *last = column_indices + row_pointers[j + 1];
+            const std::uint64_t *pos = std::lower_bound(first, last, static_cast<std::uint64_t>(i));
+            if(pos == last || *pos != i || values[pos - column_indices] != values[k]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_IO_BINARYCSR_HPP
@@ -0,0 +1,117 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_IO_MATRIXMARKET_HPP
+#define BLAZE_ITERATIVE_IO_MATRIXMARKET_HPP
+
+#include <BlazeIterative/IterativeCommon.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+/**
+ * \brief Reads a sparse matrix in Matrix Market coordinate format.
+ *
+ * Supported are the "real", "integer" and "pattern" fields with
+ * "general", "symmetric" and "skew-symmetric" storage. Symmetric
+ * files store one triangle; the other one is mirrored here, so the
+ * result always holds the full matrix. Duplicate entries are summed.
+ * Throws std::runtime_error if the file cannot be read.
+ */
+template<typename T>
+CompressedMatrix<T, rowMajor> read_matrix_market(const std::string &path)
+{
+    std::ifstream in(path);
+    if(!in) {
+        throw std::runtime_error("Cannot open Matrix Market file " + path);
+    }
+
+    std::string line;
+    std::getline(in, line);
+    std::transform(line.begin(), line.end(), line.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    std::istringstream banner(line);
+    std::string tag, object, format, field, symmetry;
+    banner >> tag >> object >> format >> field >> symmetry;
+    if(tag != "%%matrixmarket" || object != "matrix" || format != "coordinate") {
+        throw std::runtime_error(path + " is not a Matrix Market coordinate matrix");
+    }
+    if(field != "real" && field != "integer" && field != "pattern") {
+        throw std::runtime_error("Unsupported Matrix Market field '" + field + "' in " + path);
+    }
+    if(symmetry != "general" && symmetry != "symmetric" && symmetry != "skew-symmetric") {
+        throw std::runtime_error("Unsupported Matrix Market symmetry '" + symmetry + "' in " + path);
+    }
+
+    while(std::getline(in, line) && (line.empty() || line[0] == '%')) {}
+
+    std::size_t rows, columns, entries;
+    if(!(std::istringstream(line) >> rows >> columns >> entries)) {
+        throw std::runtime_error("Invalid size line in " + path);
+    }
+
+    const bool pattern = field == "pattern";
+    const bool mirror = symmetry != "general";
+    const T sign = symmetry == "skew-symmetric" ? T(-1) : T(1);
+
+    std::vector<std::tuple<std::size_t, std::size_t, T>> triplets;
+    triplets.reserve(mirror ? 2 * entries : entries);
+
+    for(std::size_t k = 0; k < entries; ++k) {
+        std::size_t i, j;
+        double value = 1.0;
+        if(!(in >> i >> j) || (!pattern && !(in >> value))) {
+            throw std::runtime_error("Unexpected end of data in " + path);
+        }
+        if(i < 1 || i > rows || j < 1 || j > columns) {
+            throw std::runtime_error("Entry out of range in " + path);
+        }
+
+        triplets.emplace_back(i - 1, j - 1, T(value));
+        if(mirror && i != j) {
+            triplets.emplace_back(j - 1, i - 1, sign * T(value));
+        }
+    }
+
+    std::sort(triplets.begin(), triplets.end(),
+              [](const std::tuple<std::size_t, std::size_t, T> &a, const std::tuple<std::size_t, std::size_t, T> &b) {
+                  return std::get<0>(a) < std::get<0>(b)
+                         || (std::get<0>(a) == std::get<0>(b) && std::get<1>(a) < std::get<1>(b));
+              });
+
+    CompressedMatrix<T, rowMajor> A(rows, columns);
+    A.reserve(triplets.size());
+
+    std::size_t k = 0;
+    for(std::size_t i = 0; i < rows; ++i) {
+        while(k < triplets.size() && std::get<0>(triplets[k]) == i) {
+            const std::size_t j = std::get<1>(triplets[k]);
+            T value = std::get<2>(triplets[k]);
+            for(++k; k < triplets.size() && std::get<0>(triplets[k]) == i && std::get<1>(triplets[k]) == j; ++k) {
+                value += std::get<2>(triplets[k]);
+            }
+            A.append(i, j, value);
+        }
+        A.finalize(i);
+    }
+
+    return A;
+}
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_IO_MATRIXMARKET_HPP
@@ -0,0 +1,372 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_SHIFTINVERTOPERATOR_HPP
+#define BLAZE_ITERATIVE_SHIFTINVERTOPERATOR_HPP
+
+#include <BlazeIterative/IterativeCommon.hpp>
+#include <BlazeIterative/LinearOperator.hpp>
+#include <BlazeIterative/preconditioners/IncompleteFactorization.hpp>
+#include <BlazeIterative/preconditioners/TriangularSolve.hpp>
+#include <BlazeIterative/solve.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+namespace detail {
+
+/*
+ * LU factorization with partial pivoting of a matrix with p sub- and q
+ * superdiagonals, in band storage. Row interchanges widen U to p + q
+ * superdiagonals, so a row of the working band holds the columns i - p
+ * to i + p + q. The multipliers of step k are kept apart from the band,
+ * and solve() applies the interchanges and eliminations in their order.
+ */
+template<typename T>
+class BandedLU
+{
+public:
+    template<typename MT>
+    BandedLU(const MT &M, std::size_t p, std::size_t q)
+        : n_(M.rows()), p_(p), width_(2 * p + q + 1),
+          band_(n_, width_, T(0)), multipliers_(n_, std::max<std::size_t>(p, 1), T(0)), pivots_(n_)
+    {
+        for(std::size_t i = 0; i < n_; ++i) {
+            for(auto element = M.begin(i); element != M.end(i); ++element) {
+                band_(i, element->index() + p_ - i) = element->value();
+            }
+        }
+
+        for(std::size_t k = 0; k < n_; ++k) {
+            const std::size_t last_row = std::min(n_ - 1, k + p_);
+            const std::size_t last_column = std::min(n_ - 1, k + width_ - 1 - p_);
+
+            std::size_t r = k;
+            for(std::size_t i = k + 1; i <= last_row; ++i) {
+                if(std::abs(at(i, k)) > std::abs(at(r, k))) {
+                    r = i;
+                }
+            }
+            if(at(r, k) == T(0)) {
+                throw std::runtime_error("The shifted matrix A - sigma I is singular");
+            }
+            pivots_[k] = r;
+            if(r != k) {
+                for(std::size_t j = k; j <= last_column; ++j) {
+                    std::swap(at(k, j), at(r, j));
+                }
+            }
+
+            const T inverse_pivot = T(1) / at(k, k);
+            for(std::size_t i = k + 1; i <= last_row; ++i) {
+                const T l = at(i, k) * inverse_pivot;
+                multipliers_(k, i - k - 1) = l;
+                if(l == T(0)) {
+                    continue;
+                }
+                for(std::size_t j = k + 1; j <= last_column; ++j) {
+                    at(i, j) -= l * at(k, j);
+                }
+            }
+        }
+    }
+
+    // y = M^-1 x; x and y may be the same vector
+    void solve(DynamicVector<T> &y, const DynamicVector<T> &x) const
+    {
+        if(&y != &x) {
+            y = x;
+        }
+        for(std::size_t k = 0; k < n_; ++k) {
+            std::swap(y[k], y[pivots_[k]]);
+            for(std::size_t i = k + 1; i <= std::min(n_ - 1, k + p_); ++i) {
+                y[i] -= multipliers_(k, i - k - 1) * y[k];
+            }
+        }
+        for(std::size_t k = n_; k-- > 0;) {
+            T sum = y[k];
+            for(std::size_t j = k + 1; j <= std::min(n_ - 1, k + width_ - 1 - p_); ++j) {
+                sum -= band_(k, j + p_ - k) * y[j];
+            }
+            y[k] = sum / band_(k, p_);
+        }
+    }
+
+private:
+    T &at(std::size_t i, std::size_t j) { return band_(i, j + p_ - i); }
+
+    std::size_t n_;
+    std::size_t p_;
+    std::size_t width_;
+    DynamicMatrix<T, rowMajor> band_;
+    DynamicMatrix<T, rowMajor> multipliers_;
+    std::vector<std::size_t> pivots_;
+};
+
+} //end namespace detail
+
+/**
+ * \class ShiftInvertOperator
+ * \brief The spectral transformation (A - sigma I)^-1 for eigensolvers.
+ *
+ * An eigenvalue lambda of A is an eigenvalue 1 / (lambda - sigma) of the
+ * operator, so the eigenvalues of A closest to the shift sigma become the
+ * largest ones, well separated from the rest. Lanczos and Arnoldi find
+ * them in a few iterations and map the Ritz values back to eigenvalues of
+ * A with eigenvalue(theta) = sigma + 1 / theta:
+ * \code
+ * ShiftInvertOperator<double> S(A, 0.7);
+ * LanczosTag tag;
+ * auto lambda = solve(S, b, tag, 12);   // eigenvalues of A, those near 0.7 are accurate
+ * \endcode
+ *
+ * The systems with A - sigma I are solved either with a factorization
+ * computed once in the constructor, or with an inner Krylov solve per
+ * application:
+ *  - dense A is inverted with a pivoted LU decomposition;
+ *  - sparse A is factorized in sparse storage (an ILUT that drops nothing)
+ *    and applied with level-scheduled triangular solves. There is no
+ *    pivoting, and the fill per row is bounded by the bandwidth of A, so
+ *    this suits banded matrices (or matrices in a bandwidth reducing
+ *    order). If a pivot vanishes or is tiny, e.g. for shifts that are
+ *    eigenvalues of a leading block of A, the operator falls back to an LU
+ *    with partial pivoting in band storage (pivoted() is then true), and
+ *    throws std::runtime_error if A - sigma I is singular;
+ *  - with a tag, e.g. GMRESTag for indefinite A - sigma I, every
+ *    application runs that solver from a zero initial guess. Its
+ *    tolerance bounds the accuracy of the eigenvalues, so set it tight.
+ *
+ * A can be a Blaze matrix or an operator that assembles its matrix().
+ */
+template<typename T = double>
+class ShiftInvertOperator
+{
+public:
+    using ElementType = T;
+
+    ShiftInvertOperator() = default;
+
+    // Factorizes A - sigma I once
+    template<typename MT>
+    ShiftInvertOperator(const MT &A, T sigma)
+    {
+        assign(A, sigma);
+    }
+
+    // Solves with A - sigma I using a copy of inner_tag on every application
+    template<typename MT, typename TagType>
+    ShiftInvertOperator(const MT &A, T sigma, const TagType &inner_tag)
+    {
+        assign(A, sigma, inner_tag);
+    }
+
+    template<typename MT>
+    void assign(const MT &A, T sigma)
+    {
+        const auto &B = detail::assembled(A);
+        assert(B.rows() == B.columns() && "A shifted operator must be square");
+        prepare(B, sigma);
+        factorize(B, std::integral_constant<bool, IsDenseMatrix<std::decay_t<decltype(B)>>::value>());
+    }
+
+    template<typename MT, typename TagType>
+    void assign(const MT &A, T sigma, const TagType &inner_tag)
+    {
+        const auto &B = detail::assembled(A);
+        assert(B.rows() == B.columns() && "A shifted operator must be square");
+        prepare(B, sigma);
+
+        auto M = std::make_shared<const CompressedMatrix<T, rowMajor>>(shifted(B));
+        solve_ = [M, inner_tag](DynamicVector<T> &y, const DynamicVector<T> &x) mutable {
+            y.resize(x.size(), false);
+            reset(y);
+            solve_inplace(y, *M, x, inner_tag);
+        };
+    }
+
+    std::size_t rows() const { return n_; }
+
+    std::size_t columns() const { return n_; }
+
+    T shift() const { return sigma_; }
+
+    bool symmetric() const { return symmetric_; }
+
+    // True if the sparse factorization broke down and was replaced by a pivoted band LU
+    bool pivoted() const { return pivoted_; }
+
+    // y = (A - sigma I)^-1 x; x and y must be different vectors
+    void apply(DynamicVector<T> &y, const DynamicVector<T> &x) const
+    {
+        solve_(y, x);
+    }
+
+    /**
+     * The same for any dense vector x (e.g. a matrix column) or x aliasing y:
+     * x is copied into scratch space kept for later calls, so an operator
+     * must not be applied by several threads at the same time.
+     */
+    template<typename VT>
+    void applyCopy(DynamicVector<T> &y, const VT &x) const
+    {
+        rhs_ = x;
+        solve_(y, rhs_);
+    }
+
+    // The eigenvalue of A belonging to the eigenvalue theta of the operator
+    T eigenvalue(T theta) const
+    {
+        return sigma_ + T(1) / theta;
+    }
+
+private:
+    template<typename MT>
+    void prepare(const MT &B, T sigma)
+    {
+        n_ = B.rows();
+        sigma_ = sigma;
+        symmetric_ = blaze::isSymmetric(B);
+    }
+
+    template<typename MT>
+    CompressedMatrix<T, rowMajor> shifted(const MT &B) const
+    {
+        CompressedMatrix<T, rowMajor> M(B);
+        for(std::size_t i = 0; i < n_; ++i) {
+            M(i, i) -= sigma_;
+        }
+        return M;
+    }
+
+    // Dense: the inverse costs as much to apply as the two triangular solves of an LU
+    template<typename MT>
+    void factorize(const MT &B, std::true_type)
+    {
+        auto inverse = std::make_shared<DynamicMatrix<T, rowMajor>>(B);
+        for(std::size_t i = 0; i < n_; ++i) {
+            (*inverse)(i, i) -= sigma_;
+        }
+        invert(*inverse);
+
+        std::shared_ptr<const DynamicMatrix<T, rowMajor>> M(std::move(inverse));
+        solve_ = [M](DynamicVector<T> &y, const DynamicVector<T> &x) {
+            y = (*M) * x;
+        };
+    }
+
+    // Sparse: without pivoting the fill of L and U stays within the band of A
+    template<typename MT>
+    void factorize(const MT &B, std::false_type)
+    {
+        const CompressedMatrix<T, rowMajor> M(shifted(B));
+        std::size_t bandwidth = 0;
+        for(std::size_t i = 0; i < n_; ++i) {
+            for(auto element = M.begin(i); element != M.end(i); ++element) {
+                const std::size_t j = element->index();
+                bandwidth = std::max(bandwidth, j > i ? j - i : i - j);
+            }
+        }
+
+        CompressedMatrix<T, rowMajor> L;
+        CompressedMatrix<T, rowMajor> U;
+        if(ilut(M, 0.0, bandwidth, L, U) != 0) {
+            // A replaced or tiny pivot: these factors are not those of A - sigma I
+            factorize_pivoted(M);
+            return;
+        }
+
+        auto lower = std::make_shared<const SparseTriangularSolver<T>>(L, TriangularPart::LOWER);
+        auto upper = std::make_shared<const SparseTriangularSolver<T>>(U, TriangularPart::UPPER);
+        solve_ = [lower, upper](DynamicVector<T> &y, const DynamicVector<T> &x) {
+            lower->solve(y, x);
+            upper->solve(y, y);
+        };
+    }
+
+    void factorize_pivoted(const CompressedMatrix<T, rowMajor> &M)
+    {
+        std::size_t lower_bandwidth = 0;
+        std::size_t upper_bandwidth = 0;
+        for(std::size_t i = 0; i < n_; ++i) {
+            for(auto element = M.begin(i); element != M.end(i); ++element) {
+                const std::size_t j = element->index();
+                if(j < i) {
+                    lower_bandwidth = std::max(lower_bandwidth, i - j);
+                } else {
+                    upper_bandwidth = std::max(upper_bandwidth, j - i);
+                }
+            }
+        }
+
+        auto lu = std::make_shared<const detail::BandedLU<T>>(M, lower_bandwidth, upper_bandwidth);
+        solve_ = [lu](DynamicVector<T> &y, const DynamicVector<T> &x) {
+            lu->solve(y, x);
+        };
+        pivoted_ = true;
+    }
+
+    std::size_t n_{0};
+    T sigma_{0};
+    bool symmetric_{false};
+    bool pivoted_{false};
+    mutable DynamicVector<T> rhs_;
+    std::function<void(DynamicVector<T> &, const DynamicVector<T> &)> solve_;
+};
+
+template<typename T>
+struct IsLinearOperator<ShiftInvertOperator<T>> : public std::true_type
+{};
+
+// x may be a (non-contiguous, or single precision) matrix column
+template<typename T, typename VT>
+void multiply(DynamicVector<T> &y, const ShiftInvertOperator<T> &A, const VT &x)
+{
+    A.applyCopy(y, x);
+}
+
+template<typename T>
+void multiply(DynamicVector<T> &y, const ShiftInvertOperator<T> &A, const DynamicVector<T> &x)
+{
+    if(&x != &y) {
+        A.apply(y, x);
+    } else {
+        A.applyCopy(y, x);
+    }
+}
+
+template<typename T, typename VT>
+void symmetric_multiply(DynamicVector<T> &y, const ShiftInvertOperator<T> &A, const VT &x)
+{
+    multiply(y, A, x);
+}
+
+template<typename T>
+void recover_eigenvalues(DynamicVector<T> &lambda, const ShiftInvertOperator<T> &A)
+{
+    for(auto &value : lambda) {
+        value = A.eigenvalue(value);
+    }
+}
+
+template<typename T>
+bool isSymmetric(const ShiftInvertOperator<T> &A)
+{
+    return A.symmetric();
+}
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_SHIFTINVERTOPERATOR_HPP
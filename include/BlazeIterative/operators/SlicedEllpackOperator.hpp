@@ -0,0 +1,244 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_SLICEDELLPACKOPERATOR_HPP
+#define BLAZE_ITERATIVE_SLICEDELLPACKOPERATOR_HPP
+
+#include <BlazeIterative/IterativeCommon.hpp>
+#include <BlazeIterative/LinearOperator.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+/**
+ * \class SlicedEllpackOperator
+ * \brief Sparse matrix in SELL-C-sigma format with a vectorized product.
+ *
+ * The rows are grouped into chunks of C consecutive rows. Each chunk is
+ * stored column by column (the k-th entries of its C rows lie next to
+ * each other) and padded with zeros to the length of its longest row, so
+ * that the product processes C rows at once with unit-stride SIMD loads
+ * of the values. To keep the padding small, the rows are sorted by length
+ * (descending) within windows of sigma rows before they are chunked; the
+ * permutation is undone when the results are written. C should be a
+ * multiple of the SIMD width (8 suits AVX2 and AVX-512 for double);
+ * sigma = 1 disables sorting. Column indices are stored in 32 bits when
+ * the matrix has fewer than 2^32 columns, which halves the index traffic
+ * of the memory-bound product compared with CSR.
+ *
+ * Built once from any Blaze matrix, the operator plugs into the solvers
+ * that apply A through multiply() (CG, BiCGSTAB, GMRES, FGMRES, GCRO-DR and
+ * deflated CG):
+ * \code
+ * SlicedEllpackOperator<double> S(A);
+ * auto x = solve(S, b, tag);
+ * \endcode
+ */
+template<typename T = double, std::size_t C = 8>
+class SlicedEllpackOperator
+{
+public:
+    using ElementType = T;
+
+    static_assert(C >= 1, "The chunk height must be positive");
+
+    static constexpr std::size_t chunk_height = C;
+
+    SlicedEllpackOperator() = default;
+
+    template<typename MT>
+    explicit SlicedEllpackOperator(const MT &A, std::size_t sigma = 32 * C)
+    {
+        assign(A, sigma);
+    }
+
+    template<typename MT>
+    void assign(const MT &A, std::size_t sigma = 32 * C)
+    {
+        const CompressedMatrix<T, rowMajor> S(A);
+        rows_ = S.rows();
+        columns_ = S.columns();
+        sigma = std::max<std::size_t>(sigma, 1);
+
+        // Rows sorted by descending length within every window of sigma rows
+        permutation_.resize(rows_);
+        std::iota(permutation_.begin(), permutation_.end(), std::size_t(0));
+        for(std::size_t first = 0; first < rows_; first += sigma) {
+            const std::size_t last = std::min(first + sigma, rows_);
+            std::stable_sort(permutation_.begin() + first, permutation_.begin() + last,
+                             [&S](std::size_t a, std::size_t b) { return S.nonZeros(a) > S.nonZeros(b); });
+        }
+
+        const std::size_t chunks = (rows_ + C - 1) / C;
+        chunk_ptr_.assign(chunks + 1, 0);
+        chunk_length_.assign(chunks, 0);
+        for(std::size_t c = 0; c < chunks; ++c) {
+            std::size_t length = 0;
+            for(std::size_t r = 0; r < C && c * C + r < rows_; ++r) {
+                length = std::max(length, S.nonZeros(permutation_[c * C + r]));
+            }
+            chunk_length_[c] = length;
+            chunk_ptr_[c + 1] = chunk_ptr_[c] + length * C;
+        }
+
+        values_.assign(chunk_ptr_[chunks], T(0));
+        wide_indices_ = columns_ > std::numeric_limits<std::uint32_t>::max();
+        if(!wide_indices_) {
+            fill_indices(S, indices32_);
+            indices_.clear();
+        } else {
+            fill_indices(S, indices_);
+            indices32_.clear();
+        }
+        nonzeros_ = S.nonZeros();
+    }
+
+    std::size_t rows() const { return rows_; }
+
+    std::size_t columns() const { return columns_; }
+
+    // Stored entries of the original matrix
+    std::size_t nonZeros() const { return nonzeros_; }
+
+    // Stored entries including the padding, nonZeros() / storedEntries() is the fill efficiency
+    std::size_t storedEntries() const { return values_.size(); }
+
+    // Bytes of one stored column index
+    std::size_t indexBytes() const { return wide_indices_ ? sizeof(std::size_t) : sizeof(std::uint32_t); }
+
+    // y = A x for raw arrays of length columns() and rows()
+    template<typename TX, typename TY>
+    void apply(const TX *x, TY *y) const
+    {
+        if(wide_indices_) {
+            apply(indices_.data(), x, y);
+        } else {
+            apply(indices32_.data(), x, y);
+        }
+    }
+
+    // The stored matrix in CSR form
+    CompressedMatrix<T, rowMajor> matrix() const
+    {
+        std::vector<std::size_t> position(rows_);
+        for(std::size_t p = 0; p < rows_; ++p) {
+            position[permutation_[p]] = p;
+        }
+
+        CompressedMatrix<T, rowMajor> A(rows_, columns_);
+        A.reserve(nonzeros_);
+        for(std::size_t i = 0; i < rows_; ++i) {
+            const std::size_t p = position[i];
+            const std::size_t c = p / C;
+            for(std::size_t k = 0; k < chunk_length_[c]; ++k) {
+                const std::size_t q = chunk_ptr_[c] + k * C + p % C;
+                if(values_[q] != T(0)) {
+                    A.append(i, wide_indices_ ? indices_[q] : std::size_t(indices32_[q]), values_[q]);
+                }
+            }
+            A.finalize(i);
+        }
+        return A;
+    }
+
+private:
+    /**
+     * Column indices in chunk order. A padded entry repeats the last
+     * column of its row (the row index for empty rows, if that is a
+     * column), so the zero it multiplies comes from a cache line the row
+     * has just loaded instead of x[0], and the kernel stays branch free.
+     */
+    template<typename Index>
+    void fill_indices(const CompressedMatrix<T, rowMajor> &S, std::vector<Index> &indices)
+    {
+        indices.assign(values_.size(), Index(0));
+        for(std::size_t p = 0; p < rows_; ++p) {
+            const std::size_t c = p / C;
+            const std::size_t r = p % C;
+            std::size_t k = 0;
+            Index last = permutation_[p] < columns_ ? Index(permutation_[p]) : Index(0);
+            for(auto element = S.begin(permutation_[p]); element != S.end(permutation_[p]); ++element, ++k) {
+                values_[chunk_ptr_[c] + k * C + r] = element->value();
+                indices[chunk_ptr_[c] + k * C + r] = last = Index(element->index());
+            }
+            for(; k < chunk_length_[c]; ++k) {
+                indices[chunk_ptr_[c] + k * C + r] = last;
+            }
+        }
+    }
+
+    template<typename Index, typename TX, typename TY>
+    void apply(const Index *indices, const TX *x, TY *y) const
+    {
+        const T *values = values_.data();
+        const std::size_t *permutation = permutation_.data();
+        const std::size_t chunks = chunk_length_.size();
+
+#pragma omp parallel for schedule(static)
+        for(long c = 0; c < static_cast<long>(chunks); ++c) {
+            const std::size_t offset = chunk_ptr_[c];
+            TY sum[C] = {};
+            for(std::size_t k = 0; k < chunk_length_[c]; ++k) {
+                const T *v = values + offset + k * C;
+                const Index *j = indices + offset + k * C;
+#pragma omp simd
+                for(std::size_t r = 0; r < C; ++r) {
+                    sum[r] += v[r] * x[j[r]];
+                }
+            }
+            const std::size_t first = static_cast<std::size_t>(c) * C;
+            const std::size_t height = std::min(C, rows_ - first);
+            for(std::size_t r = 0; r < height; ++r) {
+                y[permutation[first + r]] = sum[r];
+            }
+        }
+    }
+
+    std::size_t rows_{0};
+    std::size_t columns_{0};
+    std::size_t nonzeros_{0};
+    std::vector<std::size_t> permutation_;
+    std::vector<std::size_t> chunk_ptr_;
+    std::vector<std::size_t> chunk_length_;
+    std::vector<T> values_;
+    bool wide_indices_{false};               // 2^32 or more columns
+    std::vector<std::uint32_t> indices32_;
+    std::vector<std::size_t> indices_;
+};
+
+template<typename T, std::size_t C>
+struct IsLinearOperator<SlicedEllpackOperator<T, C>> : public std::true_type
+{};
+
+template<typename T, std::size_t C, typename VT, typename TY>
+void multiply(DynamicVector<TY> &y, const SlicedEllpackOperator<T, C> &A, const VT &x)
+{
+    y.resize(A.rows(), false);
+    A.apply(x.data(), y.data());
+}
+
+template<typename T, std::size_t C, typename VT, typename TY>
+void symmetric_multiply(DynamicVector<TY> &y, const SlicedEllpackOperator<T, C> &A, const VT &x)
+{
+    multiply(y, A, x);
+}
+
+template<typename T, std::size_t C>
+bool isSymmetric(const SlicedEllpackOperator<T, C> &A)
+{
+    return blaze::isSymmetric(A.matrix());
+}
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_SLICEDELLPACKOPERATOR_HPP
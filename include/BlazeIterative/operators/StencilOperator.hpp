@@ -0,0 +1,207 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_STENCILOPERATOR_HPP
+#define BLAZE_ITERATIVE_STENCILOPERATOR_HPP
+
+#include <BlazeIterative/IterativeCommon.hpp>
+#include <BlazeIterative/LinearOperator.hpp>
+#include <algorithm>
+#include <type_traits>
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+/*
+ * A stencil is a type with a constexpr static member function
+ *     coefficient(dx, dy, dz)
+ * returning the weight of the neighbour at offset (dx, dy, dz), with
+ * offsets in {-1, 0, 1}. The stencils below discretize -Laplace(u) with
+ * homogeneous Dirichlet boundary conditions (up to the factor 1/h^2).
+ */
+
+// 2D five-point stencil
+struct Poisson5Point
+{
+    static constexpr double coefficient(int dx, int dy, int dz)
+    {
+        return dz != 0 ? 0.0 : (dx == 0 && dy == 0) ? 4.0 : (dx * dx + dy * dy == 1) ? -1.0 : 0.0;
+    }
+};
+
+// 3D seven-point stencil
+struct Poisson7Point
+{
+    static constexpr double coefficient(int dx, int dy, int dz)
+    {
+        return (dx == 0 && dy == 0 && dz == 0) ? 6.0 : (dx * dx + dy * dy + dz * dz == 1) ? -1.0 : 0.0;
+    }
+};
+
+// 3D 27-point stencil (as in the HPCG benchmark)
+struct Poisson27Point
+{
+    static constexpr double coefficient(int dx, int dy, int dz)
+    {
+        return (dx == 0 && dy == 0 && dz == 0) ? 26.0 : -1.0;
+    }
+};
+
+/**
+ * \class StencilOperator
+ * \brief Matrix-free constant-coefficient stencil on an NX x NY x NZ grid.
+ *
+ * Grid shape and coefficients are compile-time constants, so the operator
+ * stores nothing: no values, no index arrays. Unknowns are numbered
+ * lexicographically, i + NX * (j + NY * k). The product is a sweep over
+ * grid lines, where every line of y is accumulated from the (up to 9)
+ * neighbouring lines of x with a vectorized loop; lines are processed in
+ * blocks of rows so that the three x planes touched by a block stay in
+ * cache, which makes the sweep bandwidth bound. Use NZ = 1 for 2D stencils.
+ *
+ * The operator plugs into CG, BiCGSTAB, GMRES and FGMRES like a matrix:
+ * \code
+ * StencilOperator<Poisson7Point, 64, 64, 64> A;
+ * auto x = solve(A, b, tag);
+ * \endcode
+ */
+template<typename Stencil, std::size_t NX, std::size_t NY, std::size_t NZ = 1, typename T = double>
+class StencilOperator
+{
+public:
+    using ElementType = T;
+
+    static_assert(NX >= 1 && NY >= 1 && NZ >= 1, "The grid must not be empty");
+
+    static constexpr std::size_t size = NX * NY * NZ;
+
+    // Rows per block, chosen so that a block of three planes fits into ~256 KB
+    static constexpr std::size_t block_rows = std::max<std::size_t>(1, (256 * 1024 / (3 * sizeof(T))) / NX);
+
+    constexpr std::size_t rows() const { return size; }
+
+    constexpr std::size_t columns() const { return size; }
+
+    static constexpr T coefficient(int dx, int dy, int dz) { return T(Stencil::coefficient(dx, dy, dz)); }
+
+    // Entries of the assembled matrix: every nonzero coefficient once per point whose neighbour is in the grid
+    static constexpr std::size_t nonZeros()
+    {
+        std::size_t count = 0;
+        for(int dz = -1; dz <= 1; ++dz) {
+            for(int dy = -1; dy <= 1; ++dy) {
+                for(int dx = -1; dx <= 1; ++dx) {
+                    if(coefficient(dx, dy, dz) != T(0)) {
+                        count += inside(NX, dx) * inside(NY, dy) * inside(NZ, dz);
+                    }
+                }
+            }
+        }
+        return count;
+    }
+
+    // y = A x for raw arrays of length size()
+    template<typename TX, typename TY>
+    void apply(const TX *x, TY *y) const
+    {
+#pragma omp parallel for schedule(static)
+        for(long block = 0; block < static_cast<long>((NY + block_rows - 1) / block_rows); ++block) {
+            const std::size_t first = static_cast<std::size_t>(block) * block_rows;
+            const std::size_t last = std::min(first + block_rows, NY);
+
+            for(std::size_t k = 0; k < NZ; ++k) {
+                for(std::size_t j = first; j < last; ++j) {
+                    TY *line = y + (k * NY + j) * NX;
+                    std::fill(line, line + NX, TY(0));
+
+                    for(int dz = -1; dz <= 1; ++dz) {
+                        if((dz < 0 && k == 0) || (dz > 0 && k + 1 == NZ)) {
+                            continue;
+                        }
+                        for(int dy = -1; dy <= 1; ++dy) {
+                            if((dy < 0 && j == 0) || (dy > 0 && j + 1 == NY)) {
+                                continue;
+                            }
+                            const TX *neighbour = x + ((k + dz) * NY + (j + dy)) * NX;
+                            accumulate_line(line, neighbour,
+                                            coefficient(-1, dy, dz), coefficient(0, dy, dz), coefficient(1, dy, dz));
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // True if the stencil is point symmetric, i.e. the operator is symmetric
+    static constexpr bool symmetric()
+    {
+        return is_symmetric(-1, -1, -1);
+    }
+
+private:
+    // Points of a grid line of this length whose neighbour at offset d is on the line
+    static constexpr std::size_t inside(std::size_t length, int d)
+    {
+        return d == 0 ? length : (length > 1 ? length - 1 : 0);
+    }
+
+    // line[i] += cm * x[i-1] + c0 * x[i] + cp * x[i+1], without the points outside the grid
+    template<typename TX, typename TY>
+    static void accumulate_line(TY *line, const TX *x, T cm, T c0, T cp)
+    {
+        if(cm == T(0) && c0 == T(0) && cp == T(0)) {
+            return;
+        }
+        if(NX == 1) {
+            line[0] += c0 * x[0];
+            return;
+        }
+
+        line[0] += c0 * x[0] + cp * x[1];
+#pragma omp simd
+        for(std::size_t i = 1; i < NX - 1; ++i) {
+            line[i] += cm * x[i - 1] + c0 * x[i] + cp * x[i + 1];
+        }
+        line[NX - 1] += cm * x[NX - 2] + c0 * x[NX - 1];
+    }
+
+    static constexpr bool is_symmetric(int dx, int dy, int dz)
+    {
+        return dz > 1 ? true
+             : dy > 1 ? is_symmetric(-1, -1, dz + 1)
+             : dx > 1 ? is_symmetric(-1, dy + 1, dz)
+             : Stencil::coefficient(dx, dy, dz) == Stencil::coefficient(-dx, -dy, -dz)
+               && is_symmetric(dx + 1, dy, dz);
+    }
+};
+
+template<typename Stencil, std::size_t NX, std::size_t NY, std::size_t NZ, typename T>
+struct IsLinearOperator<StencilOperator<Stencil, NX, NY, NZ, T>> : public std::true_type
+{};
+
+template<typename Stencil, std::size_t NX, std::size_t NY, std::size_t NZ, typename T, typename VT, typename TY>
+void multiply(DynamicVector<TY> &y, const StencilOperator<Stencil, NX, NY, NZ, T> &A, const VT &x)
+{
+    y.resize(A.rows(), false);
+    A.apply(x.data(), y.data());
+}
+
+template<typename Stencil, std::size_t NX, std::size_t NY, std::size_t NZ, typename T, typename VT, typename TY>
+void symmetric_multiply(DynamicVector<TY> &y, const StencilOperator<Stencil, NX, NY, NZ, T> &A, const VT &x)
+{
+    multiply(y, A, x);
+}
+
+template<typename Stencil, std::size_t NX, std::size_t NY, std::size_t NZ, typename T>
+constexpr bool isSymmetric(const StencilOperator<Stencil, NX, NY, NZ, T> &)
+{
+    return StencilOperator<Stencil, NX, NY, NZ, T>::symmetric();
+}
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_STENCILOPERATOR_HPP
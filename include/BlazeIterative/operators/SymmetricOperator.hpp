@@ -0,0 +1,301 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_SYMMETRICOPERATOR_HPP
+#define BLAZE_ITERATIVE_SYMMETRICOPERATOR_HPP
+
+#include <BlazeIterative/IterativeCommon.hpp>
+#include <BlazeIterative/LinearOperator.hpp>
+#include <algorithm>
+#include <cassert>
+#include <type_traits>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+/**
+ * \class SymmetricOperator
+ * \brief Sparse symmetric matrix stored as its lower triangle.
+ *
+ * Only the strictly lower triangle (CSR) and the diagonal are kept, about
+ * half the memory of the full matrix. The product reads every stored entry
+ * once and uses it twice: a_ij x_j is gathered into row i and a_ij x_i is
+ * scattered into row j. The rows are split into one block per thread with
+ * about equal numbers of entries. Since scattered contributions of a block
+ * land in rows of other blocks, every block accumulates into a private
+ * window covering the rows from its smallest column to its last row; a
+ * second parallel pass sums the windows overlapping each row. For banded
+ * matrices the windows are barely larger than the blocks, and every block
+ * overlaps only the windows of a few later blocks.
+ *
+ * The windows live in scratch space of the thread that calls the product,
+ * so one operator may be shared by solves running at the same time (e.g.
+ * the jobs of solve_batch()).
+ *
+ * The operator is accepted by CG, preconditioned CG, Lanczos and Arnoldi
+ * (and every other solver that applies A through multiply()):
+ * \code
+ * SymmetricOperator<double> S(A);   // only the lower triangle of A is read
+ * auto x = solve(S, b, tag);
+ * \endcode
+ */
+template<typename T = double>
+class SymmetricOperator
+{
+public:
+    using ElementType = T;
+
+    SymmetricOperator() = default;
+
+    // threads = 0 uses one block per OpenMP thread
+    template<typename MT>
+    explicit SymmetricOperator(const MT &A, std::size_t threads = 0)
+    {
+        assign(A, threads);
+    }
+
+    template<typename MT>
+    void assign(const MT &A, std::size_t threads = 0)
+    {
+        assert(A.rows() == A.columns() && "A symmetric operator must be square");
+
+        const CompressedMatrix<T, rowMajor> S(A);
+        n_ = S.rows();
+
+        row_ptr_.assign(n_ + 1, 0);
+        columns_.clear();
+        values_.clear();
+        diagonal_.assign(n_, T(0));
+        for(std::size_t i = 0; i < n_; ++i) {
+            for(auto element = S.begin(i); element != S.end(i) && element->index() <= i; ++element) {
+                if(element->index() == i) {
+                    diagonal_[i] = element->value();
+                } else {
+                    columns_.push_back(element->index());
+                    values_.push_back(element->value());
+                }
+            }
+            row_ptr_[i + 1] = columns_.size();
+        }
+
+        partition(threads ? threads : default_threads());
+    }
+
+    std::size_t rows() const { return n_; }
+
+    std::size_t columns() const { return n_; }
+
+    // Entries of the full matrix, as in matrix()
+    std::size_t nonZeros() const { return 2 * values_.size() + n_; }
+
+    // Stored entries: strictly lower triangle plus diagonal
+    std::size_t storedEntries() const { return values_.size() + n_; }
+
+    std::size_t blocks() const { return block_ptr_.empty() ? 0 : block_ptr_.size() - 1; }
+
+    /**
+     * y = A x for raw arrays of length rows(). x and y may be the same
+     * array: x is read completely before y is written.
+     */
+    template<typename TX, typename TY>
+    void apply(const TX *x, TY *y) const
+    {
+        const std::size_t *row_ptr = row_ptr_.data();
+        const std::size_t *columns = columns_.data();
+        const T *values = values_.data();
+        const T *diagonal = diagonal_.data();
+        const long blocks = static_cast<long>(this->blocks());
+        if(blocks == 0) {
+            return;
+        }
+
+        // Reused by later products on this thread; the threads of the team share the caller's windows
+        static thread_local std::vector<T> scratch;
+        if(scratch.size() < window_ptr_.back()) {
+            scratch.resize(window_ptr_.back());
+        }
+        T *window = scratch.data();
+
+#pragma omp parallel
+        {
+#pragma omp for schedule(static, 1)
+            for(long b = 0; b < blocks; ++b) {
+                // Window of block b, w[j - low] accumulates row j
+                T *w = window + window_ptr_[b];
+                const std::size_t low = low_[b];
+                std::fill(w, window + window_ptr_[b + 1], T(0));
+
+                for(std::size_t i = block_ptr_[b]; i < block_ptr_[b + 1]; ++i) {
+                    const T xi = x[i];
+                    T sum = diagonal[i] * xi;
+                    // The columns of a row are distinct, so the scatter has no dependencies
+#pragma omp simd reduction(+:sum)
+                    for(std::size_t k = row_ptr[i]; k < row_ptr[i + 1]; ++k) {
+                        sum += values[k] * x[columns[k]];
+                        w[columns[k] - low] += values[k] * xi;
+                    }
+                    w[i - low] += sum;
+                }
+            }
+
+#pragma omp for schedule(static, 1)
+            for(long b = 0; b < blocks; ++b) {
+                for(std::size_t i = block_ptr_[b]; i < block_ptr_[b + 1]; ++i) {
+                    T sum = window[window_ptr_[b] + i - low_[b]];
+                    for(std::size_t k = overlap_ptr_[b]; k < overlap_ptr_[b + 1]; ++k) {
+                        const std::size_t c = overlap_[k];
+                        if(low_[c] <= i) {
+                            sum += window[window_ptr_[c] + i - low_[c]];
+                        }
+                    }
+                    y[i] = sum;
+                }
+            }
+        }
+    }
+
+    // The full matrix, e.g. for factorizations in a setup phase
+    CompressedMatrix<T, rowMajor> matrix() const
+    {
+        // Strictly upper triangle = transpose of the strictly lower one
+        std::vector<std::size_t> upper_ptr(n_ + 1, 0);
+        for(std::size_t j : columns_) {
+            ++upper_ptr[j + 1];
+        }
+        for(std::size_t i = 0; i < n_; ++i) {
+            upper_ptr[i + 1] += upper_ptr[i];
+        }
+        std::vector<std::size_t> upper_columns(columns_.size());
+        std::vector<T> upper_values(columns_.size());
+        std::vector<std::size_t> next(upper_ptr.begin(), upper_ptr.end() - 1);
+        for(std::size_t i = 0; i < n_; ++i) {
+            for(std::size_t k = row_ptr_[i]; k < row_ptr_[i + 1]; ++k) {
+                upper_columns[next[columns_[k]]] = i;
+                upper_values[next[columns_[k]]++] = values_[k];
+            }
+        }
+
+        CompressedMatrix<T, rowMajor> A(n_, n_);
+        A.reserve(2 * values_.size() + n_);
+        for(std::size_t i = 0; i < n_; ++i) {
+            for(std::size_t k = row_ptr_[i]; k < row_ptr_[i + 1]; ++k) {
+                A.append(i, columns_[k], values_[k]);
+            }
+            A.append(i, i, diagonal_[i]);
+            for(std::size_t k = upper_ptr[i]; k < upper_ptr[i + 1]; ++k) {
+                A.append(i, upper_columns[k], upper_values[k]);
+            }
+            A.finalize(i);
+        }
+        return A;
+    }
+
+private:
+    static std::size_t default_threads()
+    {
+#ifdef _OPENMP
+        return static_cast<std::size_t>(omp_get_max_threads());
+#else
+        return 1;
+#endif
+    }
+
+    // Splits the rows into blocks of about equal work, sizes their windows and lists the overlaps
+    void partition(std::size_t threads)
+    {
+        const std::size_t blocks = std::max<std::size_t>(1, std::min(threads, n_));
+        const std::size_t work = values_.size() + n_;
+
+        block_ptr_.assign(1, 0);
+        for(std::size_t b = 1; b < blocks; ++b) {
+            std::size_t i = block_ptr_.back();
+            while(i < n_ && row_ptr_[i] + i < b * work / blocks) {
+                ++i;
+            }
+            block_ptr_.push_back(i);
+        }
+        block_ptr_.push_back(n_);
+
+        low_.assign(blocks, 0);
+        window_ptr_.assign(blocks + 1, 0);
+        for(std::size_t b = 0; b < blocks; ++b) {
+            std::size_t low = block_ptr_[b];
+            for(std::size_t i = block_ptr_[b]; i < block_ptr_[b + 1]; ++i) {
+                if(row_ptr_[i] < row_ptr_[i + 1]) {
+                    low = std::min(low, columns_[row_ptr_[i]]);
+                }
+            }
+            low_[b] = low;
+            window_ptr_[b + 1] = window_ptr_[b] + block_ptr_[b + 1] - low;
+        }
+
+        // Later blocks whose windows reach down into the rows of block b, in ascending order
+        overlap_ptr_.assign(1, 0);
+        overlap_.clear();
+        for(std::size_t b = 0; b < blocks; ++b) {
+            for(std::size_t c = b + 1; c < blocks; ++c) {
+                if(low_[c] < block_ptr_[b + 1]) {
+                    overlap_.push_back(c);
+                }
+            }
+            overlap_ptr_.push_back(overlap_.size());
+        }
+    }
+
+    std::size_t n_{0};
+    std::vector<std::size_t> row_ptr_;
+    std::vector<std::size_t> columns_;
+    std::vector<T> values_;
+    std::vector<T> diagonal_;
+    std::vector<std::size_t> block_ptr_;
+    std::vector<std::size_t> low_;
+    std::vector<std::size_t> window_ptr_;
+    std::vector<std::size_t> overlap_ptr_;
+    std::vector<std::size_t> overlap_;
+};
+
+template<typename T>
+struct IsLinearOperator<SymmetricOperator<T>> : public std::true_type
+{};
+
+template<typename T, typename TX, typename TY>
+void multiply(DynamicVector<TY> &y, const SymmetricOperator<T> &A, const DynamicVector<TX> &x)
+{
+    if(static_cast<const void *>(&x) != &y) {
+        y.resize(A.rows(), false);
+    }
+    A.apply(x.data(), y.data());
+}
+
+// Views such as matrix columns may not be contiguous: copy into y, then multiply in place
+template<typename T, typename VT, typename TY>
+void multiply(DynamicVector<TY> &y, const SymmetricOperator<T> &A, const VT &x)
+{
+    y = x;
+    A.apply(y.data(), y.data());
+}
+
+template<typename T, typename VT, typename TY>
+void symmetric_multiply(DynamicVector<TY> &y, const SymmetricOperator<T> &A, const VT &x)
+{
+    multiply(y, A, x);
+}
+
+template<typename T>
+constexpr bool isSymmetric(const SymmetricOperator<T> &)
+{
+    return true;
+}
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_SYMMETRICOPERATOR_HPP
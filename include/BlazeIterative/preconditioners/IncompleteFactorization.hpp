@@ -0,0 +1,267 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_INCOMPLETEFACTORIZATION_HPP
+#define BLAZE_ITERATIVE_INCOMPLETEFACTORIZATION_HPP
+
+#include <BlazeIterative/IterativeCommon.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <vector>
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+/*
+ * Incomplete factorizations computed directly in sparse storage.
+ *
+ * All of them run the row-wise (IKJ) Gaussian elimination of Saad's ILUT:
+ * row i is scattered into a dense work row, eliminated with the rows of U
+ * computed before it in increasing column order, and gathered back. The
+ * threshold variants drop every entry below dropTolerance times the
+ * 2-norm of row i of A and then keep at most (entries of row i of A in
+ * that triangle) + maximumFill entries of largest magnitude in each of
+ * the L and U parts. Storage for U (and L) is reserved once from these
+ * bounds, so the peak memory of a factorization is known in advance:
+ * nnz(A) + n * maximumFill entries per factor. The level-0 variants
+ * (ILU(0), IC(0)) keep exactly the pattern of A.
+ *
+ * A pivot that vanishes (or, for the Cholesky variants, is not positive)
+ * is replaced by the norm of its row, so that the factorization always
+ * completes; the preconditioner is then less accurate but still usable.
+ * Every factorization returns the number of pivots it replaced or found
+ * tiny (below sqrt(epsilon) times the norm of their row), so callers that
+ * need the exact factors, e.g. without dropping, can detect the breakdown.
+ */
+
+namespace detail {
+
+template<typename T>
+class IncompleteElimination
+{
+public:
+    using Factor = CompressedMatrix<T, rowMajor>;
+
+    /**
+     * Factorizes A ~ L * U with unit lower triangular L. L is not formed
+     * if it is null. With fill == false entries outside the pattern of A
+     * are never created (level 0), otherwise the thresholds apply.
+     * Returns the number of replaced or tiny pivots.
+     */
+    std::size_t factorize(const Factor &A, bool fill, T drop_tolerance, std::size_t maximum_fill,
+                   bool positive_pivots, Factor *L, Factor &U)
+    {
+        assert(A.rows() == A.columns() && "The matrix must be square");
+
+        const std::size_t n = A.rows();
+        const std::size_t fill_per_row = fill ? std::min(maximum_fill, n) : 0;
+
+        std::size_t lower_nonzeros = 0;
+        std::size_t upper_nonzeros = 0;
+        for(std::size_t i = 0; i < n; ++i) {
+            for(auto element = A.begin(i); element != A.end(i); ++element) {
+                element->index() < i ? ++lower_nonzeros : ++upper_nonzeros;
+            }
+        }
+
+        // Every row of U keeps its diagonal even if A has none
+        U = Factor(n, n);
+        U.reserve(std::min(upper_nonzeros + n + n * fill_per_row, n * (n + 1) / 2));
+        if(L) {
+            *L = Factor(n, n);
+            L->reserve(std::min(lower_nonzeros + n + n * fill_per_row, n * (n + 1) / 2));
+        }
+
+        w_.assign(n, T(0));
+        present_.assign(n, false);
+        inverse_pivot_.assign(n, T(0));
+        std::size_t breakdowns = 0;
+
+        for(std::size_t i = 0; i < n; ++i) {
+            std::size_t row_lower = 0;
+            std::size_t row_upper = 0;
+            T norm = T(0);
+            start_row(i);
+            for(auto element = A.begin(i); element != A.end(i); ++element) {
+                const std::size_t j = element->index();
+                add(j, i);
+                w_[j] = element->value();
+                norm += element->value() * element->value();
+                if(j < i) {
+                    ++row_lower;
+                } else if(j > i) {
+                    ++row_upper;
+                }
+            }
+            norm = std::sqrt(norm);
+            const T tau = fill ? drop_tolerance * norm : T(0);
+
+            // Eliminate the entries left of the diagonal in increasing column order
+            lower_.clear();
+            while(!pending_.empty()) {
+                const std::size_t k = pending_.top();
+                pending_.pop();
+
+                const T l_ik = w_[k] * inverse_pivot_[k];
+                if(std::abs(l_ik) <= tau || l_ik == T(0)) {
+                    w_[k] = T(0);
+                    continue;
+                }
+                w_[k] = l_ik;
+                lower_.push_back(k);
+
+                for(auto element = U.begin(k); element != U.end(k); ++element) {
+                    const std::size_t j = element->index();
+                    if(j == k) {
+                        continue;
+                    }
+                    if(!present_[j]) {
+                        if(!fill) {
+                            continue;
+                        }
+                        add(j, i);
+                    }
+                    w_[j] -= l_ik * element->value();
+                }
+            }
+
+            upper_.clear();
+            for(std::size_t j : pattern_) {
+                if(j > i && std::abs(w_[j]) > tau && w_[j] != T(0)) {
+                    upper_.push_back(j);
+                }
+            }
+            keep_largest(lower_, row_lower + fill_per_row);
+            keep_largest(upper_, row_upper + fill_per_row);
+
+            T pivot = w_[i];
+            if(positive_pivots ? !(pivot > T(0)) : pivot == T(0)) {
+                pivot = norm > T(0) ? norm : T(1);
+                ++breakdowns;
+            } else if(std::abs(pivot) < std::sqrt(std::numeric_limits<T>::epsilon()) * norm) {
+                ++breakdowns;
+            }
+            inverse_pivot_[i] = T(1) / pivot;
+
+            if(L) {
+                for(std::size_t k : lower_) {
+                    L->append(i, k, w_[k]);
+                }
+                L->append(i, i, T(1));
+                L->finalize(i);
+            }
+            U.append(i, i, pivot);
+            for(std::size_t j : upper_) {
+                U.append(i, j, w_[j]);
+            }
+            U.finalize(i);
+
+            for(std::size_t j : pattern_) {
+                w_[j] = T(0);
+                present_[j] = false;
+            }
+        }
+        return breakdowns;
+    }
+
+private:
+    void start_row(std::size_t i)
+    {
+        pattern_.clear();
+        add(i, i);
+    }
+
+    void add(std::size_t j, std::size_t i)
+    {
+        if(present_[j]) {
+            return;
+        }
+        present_[j] = true;
+        pattern_.push_back(j);
+        if(j < i) {
+            pending_.push(j);
+        }
+    }
+
+    // Keeps the count entries of largest magnitude, in increasing column order
+    void keep_largest(std::vector<std::size_t> &indices, std::size_t count) const
+    {
+        if(indices.size() > count) {
+            std::nth_element(indices.begin(), indices.begin() + count, indices.end(),
+                             [this](std::size_t a, std::size_t b) { return std::abs(w_[a]) > std::abs(w_[b]); });
+            indices.resize(count);
+        }
+        std::sort(indices.begin(), indices.end());
+    }
+
+    std::vector<T> w_;
+    std::vector<bool> present_;
+    std::vector<T> inverse_pivot_;
+    std::vector<std::size_t> pattern_;
+    std::vector<std::size_t> lower_;
+    std::vector<std::size_t> upper_;
+    std::priority_queue<std::size_t, std::vector<std::size_t>, std::greater<std::size_t>> pending_;
+};
+
+} //end namespace detail
+
+/**
+ * Threshold incomplete LU factorization (ILUT) A ~ L * U. L is unit lower
+ * triangular with its diagonal stored, U is upper triangular. Returns the
+ * number of replaced or tiny pivots.
+ */
+template<typename MT, typename T>
+std::size_t ilut(const MT &A, double drop_tolerance, std::size_t maximum_fill,
+          CompressedMatrix<T, rowMajor> &L, CompressedMatrix<T, rowMajor> &U)
+{
+    const CompressedMatrix<T, rowMajor> S(A);
+    return detail::IncompleteElimination<T>().factorize(S, true, T(drop_tolerance), maximum_fill, false, &L, U);
+}
+
+// ILU(0): incomplete LU factorization restricted to the pattern of A
+template<typename MT, typename T>
+std::size_t ilu0(const MT &A, CompressedMatrix<T, rowMajor> &L, CompressedMatrix<T, rowMajor> &U)
+{
+    const CompressedMatrix<T, rowMajor> S(A);
+    return detail::IncompleteElimination<T>().factorize(S, false, T(0), 0, false, &L, U);
+}
+
+/**
+ * Threshold incomplete Cholesky factorization (ICT) of a symmetric
+ * positive definite A in the form A ~ trans(U) * inv(diag(d)) * U, with
+ * d the diagonal of U. Only U is stored: the elimination of row i reads
+ * the rows of U above it alone, and for symmetric A the unit lower factor
+ * is trans(U) * inv(diag(d)), so it is never formed.
+ */
+template<typename MT, typename T>
+std::size_t ict(const MT &A, double drop_tolerance, std::size_t maximum_fill,
+         CompressedMatrix<T, rowMajor> &U, DynamicVector<T> &d)
+{
+    const CompressedMatrix<T, rowMajor> S(A);
+    const std::size_t breakdowns = detail::IncompleteElimination<T>().factorize(S, true, T(drop_tolerance),
+                                                                                maximum_fill, true, nullptr, U);
+    d = band<0L>(U);
+    return breakdowns;
+}
+
+// IC(0): incomplete Cholesky factorization restricted to the pattern of A, same form as ict()
+template<typename MT, typename T>
+std::size_t ic0(const MT &A, CompressedMatrix<T, rowMajor> &U, DynamicVector<T> &d)
+{
+    const CompressedMatrix<T, rowMajor> S(A);
+    const std::size_t breakdowns = detail::IncompleteElimination<T>().factorize(S, false, T(0), 0, true, nullptr, U);
+    d = band<0L>(U);
+    return breakdowns;
+}
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_INCOMPLETEFACTORIZATION_HPP
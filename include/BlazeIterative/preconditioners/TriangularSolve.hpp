@@ -0,0 +1,173 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_TRIANGULARSOLVE_HPP
+#define BLAZE_ITERATIVE_TRIANGULARSOLVE_HPP
+
+#include <BlazeIterative/IterativeCommon.hpp>
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+#include <vector>
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+enum class TriangularPart : unsigned char {
+    LOWER,
+    UPPER
+};
+
+/**
+ * \class SparseTriangularSolver
+ * \brief Level-scheduled solution of sparse triangular systems.
+ *
+ * setup() analyses the dependencies between the rows once: row i of a
+ * lower triangular matrix depends on every row j < i with M(i,j) != 0, and
+ * its level is one more than the largest level of those rows. All rows of
+ * a level are independent of each other. The rows are stored level by
+ * level in CSR form (diagonal kept separately as its inverse), so that
+ * solve() can process the levels one after another, with the rows of a
+ * level distributed over the OpenMP threads and a vectorized dot product
+ * per row. Matrices whose levels are too narrow to amortize a barrier per
+ * level (e.g. tridiagonal ones) are solved serially in the same order.
+ *
+ * Only the triangle selected by the TriangularPart is read; the diagonal
+ * must be nonzero.
+ */
+template<typename T>
+class SparseTriangularSolver
+{
+public:
+    SparseTriangularSolver() = default;
+
+    template<typename MT>
+    SparseTriangularSolver(const MT &M, TriangularPart part)
+    {
+        setup(M, part);
+    }
+
+    template<typename MT>
+    void setup(const MT &M, TriangularPart part)
+    {
+        assert(M.rows() == M.columns() && "The triangular matrix must be square");
+
+        const CompressedMatrix<T, rowMajor> S(M);
+        const std::size_t n = S.rows();
+        const bool lower = part == TriangularPart::LOWER;
+
+        // Level of every row; rows are visited in dependency order
+        std::vector<std::size_t> level(n, 0);
+        std::size_t levels = 0;
+        for(std::size_t step = 0; step < n; ++step) {
+            const std::size_t i = lower ? step : n - 1 - step;
+            std::size_t l = 0;
+            for(auto element = S.begin(i); element != S.end(i); ++element) {
+                const std::size_t j = element->index();
+                if((lower && j < i) || (!lower && j > i)) {
+                    l = std::max(l, level[j] + 1);
+                }
+            }
+            level[i] = l;
+            levels = std::max(levels, l + 1);
+        }
+
+        // Counting sort of the rows by level, ascending row index within a level
+        level_ptr_.assign(levels + 1, 0);
+        for(std::size_t i = 0; i < n; ++i) {
+            ++level_ptr_[level[i] + 1];
+        }
+        std::partial_sum(level_ptr_.begin(), level_ptr_.end(), level_ptr_.begin());
+
+        order_.resize(n);
+        std::vector<std::size_t> next(level_ptr_.begin(), level_ptr_.end() - 1);
+        for(std::size_t i = 0; i < n; ++i) {
+            order_[next[level[i]]++] = i;
+        }
+
+        // Off-diagonal entries of the triangle and inverse diagonal, in level order
+        row_ptr_.assign(n + 1, 0);
+        columns_.clear();
+        values_.clear();
+        inverse_diagonal_.assign(n, T(0));
+        for(std::size_t p = 0; p < n; ++p) {
+            const std::size_t i = order_[p];
+            for(auto element = S.begin(i); element != S.end(i); ++element) {
+                const std::size_t j = element->index();
+                if(j == i) {
+                    inverse_diagonal_[p] = T(1) / element->value();
+                } else if((lower && j < i) || (!lower && j > i)) {
+                    columns_.push_back(j);
+                    values_.push_back(element->value());
+                }
+            }
+            row_ptr_[p + 1] = columns_.size();
+            assert(inverse_diagonal_[p] != T(0) && "The diagonal of a triangular factor must be nonzero");
+        }
+
+        parallel_ = n >= minimum_parallel_rows && n >= minimum_level_width * levels;
+    }
+
+    std::size_t rows() const { return order_.size(); }
+
+    std::size_t levels() const { return level_ptr_.empty() ? 0 : level_ptr_.size() - 1; }
+
+    // True if solve() distributes the levels over threads
+    bool parallel() const { return parallel_; }
+
+    /**
+     * x = M^-1 b. x may be the same vector as b: row i reads b[i] only
+     * before it writes x[i], and no other row reads b[i].
+     */
+    void solve(DynamicVector<T> &x, const DynamicVector<T> &b) const
+    {
+        const std::size_t n = rows();
+        if(&x != &b) {
+            x.resize(n, false);
+        }
+
+        const T *rhs = b.data();
+        T *solution = x.data();
+        const std::size_t *order = order_.data();
+        const std::size_t *row_ptr = row_ptr_.data();
+        const std::size_t *columns = columns_.data();
+        const T *values = values_.data();
+        const T *inverse_diagonal = inverse_diagonal_.data();
+        const std::size_t levels = this->levels();
+
+#pragma omp parallel if(parallel_)
+        for(std::size_t l = 0; l < levels; ++l) {
+#pragma omp for schedule(static)
+            for(long p = static_cast<long>(level_ptr_[l]); p < static_cast<long>(level_ptr_[l + 1]); ++p) {
+                const std::size_t i = order[p];
+                T sum = T(0);
+#pragma omp simd reduction(+:sum)
+                for(std::size_t k = row_ptr[p]; k < row_ptr[p + 1]; ++k) {
+                    sum += values[k] * solution[columns[k]];
+                }
+                solution[i] = (rhs[i] - sum) * inverse_diagonal[p];
+            }
+        }
+    }
+
+private:
+    // Below these sizes a barrier per level costs more than the parallel rows save
+    static constexpr std::size_t minimum_parallel_rows = 4096;
+    static constexpr std::size_t minimum_level_width = 64;
+
+    std::vector<std::size_t> level_ptr_;
+    std::vector<std::size_t> order_;
+    std::vector<std::size_t> row_ptr_;
+    std::vector<std::size_t> columns_;
+    std::vector<T> values_;
+    std::vector<T> inverse_diagonal_;
+    bool parallel_{false};
+};
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_TRIANGULARSOLVE_HPP
@@ -9,9 +9,11 @@
 
 #include "IterativeCommon.hpp"
 #include "IterativeTag.hpp"
+#include "LinearOperator.hpp"
 #include "solvers/solvers.hpp"
 #include <type_traits>
 #include <cstring>
+#include <string>
 #include <utility>
 
 #include <iostream>
@@ -19,6 +21,29 @@
 BLAZE_NAMESPACE_OPEN
 ITERATIVE_NAMESPACE_OPEN
 
+namespace detail {
+
+/*
+ * False, with the status MEMORY_BUDGET_EXCEEDED, if the workspace of the
+ * solve (see workspace_size()) exceeds tag.memoryBudget(). Checked before
+ * the solver allocates anything; the arguments after the tag are those of
+ * workspace_size().
+ */
+template<typename MatrixType, typename TagType, typename Argument>
+bool fits_memory_budget(const MatrixType &A, TagType &tag, const Argument &argument)
+{
+    return tag.memoryBudget() == 0 || tag.fitsMemoryBudget(workspace_impl(A, tag, argument));
+}
+
+// AutoTag checks the workspace of the solver it chooses
+template<typename MatrixType, typename Argument>
+bool fits_memory_budget(const MatrixType &, AutoTag &, const Argument &)
+{
+    return true;
+}
+
+} //end namespace detail
+
 /**
  * Solve a linear system using a preallocated buffer "x".
  * The values in "x" are used as the initial guess for
@@ -31,7 +56,7 @@ void solve_inplace(DynamicVector<T> &x,
                    TagType &tag)
 {
     //Compile-time assertions
-    BLAZE_CONSTRAINT_MUST_BE_MATRIX_TYPE(MatrixType);
+    static_assert(IsLinearOperator<MatrixType>::value, "A must be a matrix or a linear operator");
     static_assert(std::is_same<T, typename MatrixType::ElementType>::value,
                   "Matrix and vector data types must be the same");
 
@@ -40,6 +65,10 @@ void solve_inplace(DynamicVector<T> &x,
     assert(x.size() == b.size() && "x and b must be the same length");
     assert(A.rows() == A.columns() && "A must be a square matrix");
 
+    if(!detail::fits_memory_budget(A, tag, std::string())) {
+        return;
+    }
+
     // Call specific solver
     detail::solve_impl(x, A, b, tag);
 };
@@ -53,7 +82,7 @@ void solve_inplace(DynamicVector<T> &x,
                    std::string Preconditioner)
 {
     //Compile-time assertions
-    BLAZE_CONSTRAINT_MUST_BE_MATRIX_TYPE(MatrixType);
+    static_assert(IsLinearOperator<MatrixType>::value, "A must be a matrix or a linear operator");
     static_assert(std::is_same<T, typename MatrixType::ElementType>::value,
                   "Matrix and vector data types must be the same");
 
@@ -62,6 +91,10 @@ void solve_inplace(DynamicVector<T> &x,
     assert(x.size() == b.size() && "x and b must be the same length");
     assert(A.rows() == A.columns() && "A must be a square matrix");
 
+    if(!detail::fits_memory_budget(A, tag, Preconditioner)) {
+        return;
+    }
+
     // Call specific solver
     detail::solve_impl(x, A, b, tag,Preconditioner);
 };
@@ -77,7 +110,7 @@ void solve_inplace(DynamicVector<T> &x,
                        const std::size_t &n)
     {
         //Compile-time assertions
-        BLAZE_CONSTRAINT_MUST_BE_MATRIX_TYPE(MatrixType);
+        static_assert(IsLinearOperator<MatrixType>::value, "A must be a matrix or a linear operator");
         static_assert(std::is_same<T, typename MatrixType::ElementType>::value,
                       "Matrix and vector data types must be the same");
 
@@ -85,6 +118,10 @@ void solve_inplace(DynamicVector<T> &x,
         assert(A.columns() == b.size() && "A and b must have consistent dimensions");
         assert(n >= 1 && "n must be larger than or equal to 1");
 
+        if(!detail::fits_memory_budget(A, tag, n)) {
+            return;
+        }
+
         // Call specific solver
         detail::solve_impl(x, A, b, tag, n);
     };
@@ -148,6 +185,7 @@ DynamicVector<T> solve(const MatrixType &A,
 
 // For Arnoldi
 // For Lanczos
+// For LOBPCG
 // For GMRES
     template<typename MatrixType, typename T, typename TagType>
     DynamicVector<T> solve(const MatrixType &A, const DynamicVector<T> &b, TagType &tag, const std::size_t &n)
@@ -161,15 +199,77 @@ DynamicVector<T> solve(const MatrixType &A,
             DynamicVector<T> x(n, 0.0);
             solve_inplace(x, A, b, tag, n);
             return x;
-        } else {
+        } else if(typeid(tag).name() == typeid(LOBPCGTag).name()) {
+            // n is the number of eigenpairs
             DynamicVector<T> x(n, 0.0);
             solve_inplace(x, A, b, tag, n);
             return x;
+        } else {
+            // n is the restart length, the solution has the size of b
+            DynamicVector<T> x(b.size(), 0.0);
+            solve_inplace(x, A, b, tag, n);
+            return x;
         }
 
     };
 
 
+/**
+ * \brief Bytes a solve of \f$ Ax = b \f$ with this tag allocates.
+ *
+ * Counts the vectors, matrices and preconditioner factors the solver
+ * allocates in addition to A, b and x, for the parameters it will
+ * actually use: with a memoryBudget() on the tag, GMRES and FGMRES
+ * shorten the restart length and GMRES and Arnoldi store their basis in
+ * single precision to fit. Every solve_inplace() (and solve()) compares
+ * this size with the budget before it calls the solver; if it exceeds the
+ * budget, the solve returns with the status MEMORY_BUDGET_EXCEEDED
+ * without touching x. The result does not include SIMD padding or
+ * allocator overhead. The arguments after the tag are those of solve().
+ */
+template<typename MatrixType, typename TagType>
+std::size_t workspace_size(const MatrixType &A, const TagType &tag, std::string Preconditioner = "")
+{
+    return detail::workspace_impl(A, tag, Preconditioner);
+};
+
+// For Arnoldi, Lanczos and LOBPCG, and GMRES with the restart length n
+template<typename MatrixType, typename TagType>
+std::size_t workspace_size(const MatrixType &A, const TagType &tag, const std::size_t &n)
+{
+    return detail::workspace_impl(A, tag, n);
+};
+
+
+/**
+ * Fixed-size systems: x, A and b are Blaze static types, and the solver
+ * (ConjugateGradientTag or BiCGSTABTag) runs without heap allocations.
+ * The values in "x" are used as the initial guess.
+ */
+template<typename T, std::size_t N, bool SO, typename TagType>
+void solve_inplace(StaticVector<T, N> &x,
+                   const StaticMatrix<T, N, N, SO> &A,
+                   const StaticVector<T, N> &b,
+                   TagType &tag)
+{
+    detail::solve_impl(x, A, b, tag);
+};
+
+/**
+ * \brief Solve the fixed-size system \f$ Ax = b \f$ with the initial guess zero.
+ *
+ * Returns a StaticVector; see the StaticMatrix overload of solve_inplace.
+ */
+template<typename T, std::size_t N, bool SO, typename TagType>
+StaticVector<T, N> solve(const StaticMatrix<T, N, N, SO> &A, const StaticVector<T, N> &b, TagType &tag)
+{
+    StaticVector<T, N> x(T(0));
+    solve_inplace(x, A, b, tag);
+
+    return x;
+};
+
+
 ITERATIVE_NAMESPACE_CLOSE
 BLAZE_NAMESPACE_CLOSE
 
@@ -8,6 +8,8 @@
 #define BLAZE_ITERATIVE_ARNOLDI_HPP
 
 #include <BlazeIterative/IterativeCommon.hpp>
+#include <BlazeIterative/LinearOperator.hpp>
+#include <BlazeIterative/Workspace.hpp>
 #include "ArnoldiTag.hpp"
 
 BLAZE_NAMESPACE_OPEN
@@ -15,8 +17,10 @@ BLAZE_NAMESPACE_OPEN
 
         namespace detail {
 
-            template<typename MatrixType, typename T>
-            void  solve_impl(
+            // The Krylov basis Q is stored with element type BasisType,
+            // all other quantities use the element type T of the system
+            template<typename BasisType, typename MatrixType, typename T>
+            void  arnoldi_impl(
                     DynamicVector<T> &x,
                     const MatrixType &A,
                     const DynamicVector<T> &b,
@@ -45,7 +49,7 @@ BLAZE_NAMESPACE_OPEN
 
                 // Return a vector of eigenvalues
 
-                DynamicMatrix<T> Q(m, n + 1);
+                DynamicMatrix<BasisType, columnMajor> Q(m, n + 1);
                 DynamicMatrix<T> h(n + 1, n, 0);
                 DynamicVector<complex<double>> x_comp(n);
 
@@ -56,7 +60,7 @@ BLAZE_NAMESPACE_OPEN
                 DynamicVector<T> v(m);
 
                 for (int k = 0; k < n; ++k) {
-                    v = declsym(A) * column(Q, k);
+                    symmetric_multiply(v, A, column(Q, k));
 
                     for (int j = 0; j < k + 1; ++j) {
                         h(j, k) = ctrans(column(Q, j)) * v;
@@ -78,8 +82,51 @@ BLAZE_NAMESPACE_OPEN
                 auto sub_h = submatrix( h, 0UL, 0UL, (h.rows()-1), h.columns());
                 eigen(sub_h, x_comp);
                 x = real(x_comp);
+                recover_eigenvalues(x, A);
+
+            }; // end arnoldi_impl function
+
+            // Bytes of the basis, the Hessenberg matrix and the vectors of arnoldi_impl
+            template<typename T>
+            std::size_t arnoldi_workspace_bytes(std::size_t m, std::size_t n, BasisPrecision precision)
+            {
+                const std::size_t basis_size = precision == BasisPrecision::SINGLE ? sizeof(float) : sizeof(T);
+                return dense_bytes(m, n + 1, basis_size) + dense_bytes(n + 1, n, sizeof(T))
+                       + n * sizeof(complex<double>) + m * sizeof(T);
+            }
+
+            // n is the number of eigenvalues, so a tight memoryBudget() can only switch to a single precision basis
+            template<typename T>
+            BasisPrecision arnoldi_precision(const ArnoldiTag &tag, std::size_t m, std::size_t n)
+            {
+                const std::size_t budget = tag.memoryBudget();
+                if(budget == 0 || arnoldi_workspace_bytes<T>(m, n, tag.basisPrecision()) <= budget) {
+                    return tag.basisPrecision();
+                }
+                return BasisPrecision::SINGLE;
+            }
 
-            }; // end solve_imple function
+            template<typename MatrixType, typename T>
+            void  solve_impl(
+                    DynamicVector<T> &x,
+                    const MatrixType &A,
+                    const DynamicVector<T> &b,
+                    ArnoldiTag &tag,
+                    const std::size_t &n
+                   ) {
+                if (arnoldi_precision<T>(tag, b.size(), n) == BasisPrecision::SINGLE) {
+                    arnoldi_impl<float>(x, A, b, tag, n);
+                } else {
+                    arnoldi_impl<T>(x, A, b, tag, n);
+                }
+            }
+
+            template<typename MatrixType>
+            std::size_t workspace_impl(const MatrixType &A, const ArnoldiTag &tag, const std::size_t &n)
+            {
+                using T = typename MatrixType::ElementType;
+                return arnoldi_workspace_bytes<T>(A.rows(), n, arnoldi_precision<T>(tag, A.rows(), n));
+            }
 
         } //end namespace detail
 
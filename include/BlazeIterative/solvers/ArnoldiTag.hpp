@@ -9,6 +9,7 @@
 
 #include <BlazeIterative/IterativeCommon.hpp>
 #include <BlazeIterative/IterativeTag.hpp>
+#include <BlazeIterative/BasisPrecision.hpp>
 
 BLAZE_NAMESPACE_OPEN
     ITERATIVE_NAMESPACE_OPEN
@@ -19,6 +20,14 @@ BLAZE_NAMESPACE_OPEN
             ArnoldiTag() {
                 solverName = "Arnoldi";
             }
+
+            // Storage precision of the Krylov basis, see BasisPrecision
+            BasisPrecision &basisPrecision() { return basis_precision; }
+
+            BasisPrecision basisPrecision() const { return basis_precision; }
+
+        protected:
+            BasisPrecision basis_precision{BasisPrecision::FULL};
         };
 
     ITERATIVE_NAMESPACE_CLOSE
@@ -0,0 +1,497 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_AUTO_HPP
+#define BLAZE_ITERATIVE_AUTO_HPP
+
+#include "BlazeIterative/IterativeCommon.hpp"
+#include "BlazeIterative/LinearOperator.hpp"
+#include "AutoTag.hpp"
+#include "DenseSubspace.hpp"
+#include "ConjugateGradient.hpp"
+#include "BiCGSTAB.hpp"
+#include "GMRES.hpp"
+#include "MINRES.hpp"
+#include "PreconditionCG.hpp"
+#include "PreconditionBiCGSTAB.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+namespace detail {
+
+inline void fingerprint_mix(std::uint64_t &hash, std::uint64_t value)
+{
+    // FNV-1a on 64 bit words
+    hash ^= value;
+    hash *= 1099511628211ULL;
+}
+
+template<typename T>
+inline std::uint64_t fingerprint_bits(T value)
+{
+    const double d = static_cast<double>(value);
+    std::uint64_t bits;
+    std::memcpy(&bits, &d, sizeof(bits));
+    return bits;
+}
+
+/**
+ * Hash of the dimensions, the sparsity pattern and all values of A,
+ * computed in a single pass over the stored elements.
+ */
+template<typename MT, bool SO>
+std::uint64_t matrix_fingerprint(const DenseMatrix<MT, SO> &matrix)
+{
+    const MT &A = ~matrix;
+    std::uint64_t hash = 14695981039346656037ULL;
+    fingerprint_mix(hash, A.rows());
+    fingerprint_mix(hash, A.columns());
+
+    const std::size_t outer = SO == rowMajor ? A.rows() : A.columns();
+    for(std::size_t i = 0; i < outer; ++i) {
+        for(auto element = A.begin(i); element != A.end(i); ++element) {
+            fingerprint_mix(hash, fingerprint_bits(*element));
+        }
+    }
+    return hash;
+}
+
+template<typename MT, bool SO>
+std::uint64_t matrix_fingerprint(const SparseMatrix<MT, SO> &matrix)
+{
+    const MT &A = ~matrix;
+    std::uint64_t hash = 14695981039346656037ULL;
+    fingerprint_mix(hash, A.rows());
+    fingerprint_mix(hash, A.columns());
+
+    const std::size_t outer = SO == rowMajor ? A.rows() : A.columns();
+    for(std::size_t i = 0; i < outer; ++i) {
+        fingerprint_mix(hash, A.nonZeros(i));
+        for(auto element = A.begin(i); element != A.end(i); ++element) {
+            fingerprint_mix(hash, element->index());
+            fingerprint_mix(hash, fingerprint_bits(element->value()));
+        }
+    }
+    return hash;
+}
+
+// Pseudo-random weight in [1, 2) of index i (splitmix64)
+inline double fingerprint_weight(std::uint64_t i, std::uint64_t seed)
+{
+    std::uint64_t z = i * 0x9E3779B97F4A7C15ULL + seed;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+    return 1.0 + double(z >> 11) / 9007199254740992.0;
+}
+
+// floor(steps * log2(ratio)), with a separate value for ratios that are not positive and finite
+inline std::uint64_t fingerprint_bucket(double ratio, double steps)
+{
+    if(!(ratio > 0.0) || !std::isfinite(ratio)) {
+        return std::numeric_limits<std::uint64_t>::max();
+    }
+    return static_cast<std::uint64_t>(static_cast<std::int64_t>(std::floor(steps * std::log2(ratio))));
+}
+
+/**
+ * Statistics of the values of A that the choice of the solver depends
+ * on, collected one stored element at a time. The symmetry test compares
+ * sum_ij a_ij f_i g_j with sum_ij a_ij f_j g_i for pseudo-random weights
+ * f and g, which agree (up to rounding) only for symmetric A.
+ */
+struct FingerprintStatistics
+{
+    double diagonal_min{std::numeric_limits<double>::max()};
+    double diagonal_max{-std::numeric_limits<double>::max()};
+    double dominance{std::numeric_limits<double>::max()};   // min over rows (columns) of |a_ii| / sum_{j != i} |a_ij|
+    double asymmetry{0.0};
+    double magnitude{0.0};
+
+    double f_i{1.0};
+    double g_i{1.0};
+    double diagonal{0.0};
+    double off_diagonal{0.0};
+
+    void begin(std::size_t i)
+    {
+        f_i = fingerprint_weight(i, 1);
+        g_i = fingerprint_weight(i, 2);
+        diagonal = 0.0;
+        off_diagonal = 0.0;
+    }
+
+    void add(std::size_t i, std::size_t j, double value)
+    {
+        if(i == j) {
+            diagonal = value;
+            return;
+        }
+        off_diagonal += std::abs(value);
+        const double f_j = fingerprint_weight(j, 1);
+        const double g_j = fingerprint_weight(j, 2);
+        asymmetry += value * (f_i * g_j - f_j * g_i);
+        magnitude += std::abs(value) * (f_i * g_j + f_j * g_i);
+    }
+
+    void end()
+    {
+        diagonal_min = std::min(diagonal_min, diagonal);
+        diagonal_max = std::max(diagonal_max, diagonal);
+        if(off_diagonal > 0.0) {
+            dominance = std::min(dominance, std::abs(diagonal) / off_diagonal);
+        }
+    }
+
+    // Buckets of a quarter octave for the dominance, so that a bucket never straddles dominance 1
+    void mix(std::uint64_t &hash) const
+    {
+        fingerprint_mix(hash, diagonal_min > 0.0);
+        fingerprint_mix(hash, std::abs(asymmetry) <= 1e-10 * magnitude);
+        fingerprint_mix(hash, fingerprint_bucket(dominance, 4.0));
+        fingerprint_mix(hash, fingerprint_bucket(std::abs(diagonal_max) / std::abs(diagonal_min), 2.0));
+    }
+};
+
+/**
+ * Hash of the dimensions and of the statistics of FingerprintStatistics.
+ * Matrices that differ by small changes of their values share it, except
+ * where a statistic crosses a bucket boundary.
+ */
+template<typename MT, bool SO>
+std::uint64_t matrix_statistics_fingerprint(const DenseMatrix<MT, SO> &matrix)
+{
+    const MT &A = ~matrix;
+    std::uint64_t hash = 14695981039346656037ULL;
+    fingerprint_mix(hash, A.rows());
+    fingerprint_mix(hash, A.columns());
+
+    FingerprintStatistics statistics;
+    const std::size_t outer = SO == rowMajor ? A.rows() : A.columns();
+    const std::size_t inner = SO == rowMajor ? A.columns() : A.rows();
+    for(std::size_t i = 0; i < outer; ++i) {
+        statistics.begin(i);
+        for(std::size_t j = 0; j < inner; ++j) {
+            statistics.add(i, j, SO == rowMajor ? A(i, j) : A(j, i));
+        }
+        statistics.end();
+    }
+    statistics.mix(hash);
+    return hash;
+}
+
+/**
+ * As above, and the sparsity pattern exactly; the pattern is hashed in
+ * the same pass.
+ */
+template<typename MT, bool SO>
+std::uint64_t matrix_statistics_fingerprint(const SparseMatrix<MT, SO> &matrix)
+{
+    const MT &A = ~matrix;
+    std::uint64_t hash = 14695981039346656037ULL;
+    fingerprint_mix(hash, A.rows());
+    fingerprint_mix(hash, A.columns());
+
+    FingerprintStatistics statistics;
+    const std::size_t outer = SO == rowMajor ? A.rows() : A.columns();
+    for(std::size_t i = 0; i < outer; ++i) {
+        fingerprint_mix(hash, A.nonZeros(i));
+        statistics.begin(i);
+        for(auto element = A.begin(i); element != A.end(i); ++element) {
+            fingerprint_mix(hash, element->index());
+            statistics.add(i, element->index(), element->value());
+        }
+        statistics.end();
+    }
+    statistics.mix(hash);
+    return hash;
+}
+
+// Symmetry, diagonal and density of A
+template<typename MatrixType>
+void analyse_matrix(const MatrixType &A, AutoDecision &decision)
+{
+    const std::size_t n = A.rows();
+
+    decision.symmetric = isSymmetric(A);
+    decision.density = double(nonZeros(A)) / (double(n) * double(A.columns()));
+    decision.positive_diagonal = true;
+    decision.diagonal_dominance = std::numeric_limits<double>::max();
+
+    for(std::size_t i = 0; i < n; ++i) {
+        const double diagonal = A(i, i);
+        const double off_diagonal = double(sum(abs(row(A, i)))) - std::abs(diagonal);
+
+        decision.positive_diagonal = decision.positive_diagonal && diagonal > 0.0;
+        if(off_diagonal > 0.0) {
+            decision.diagonal_dominance = std::min(decision.diagonal_dominance, std::abs(diagonal) / off_diagonal);
+        }
+    }
+}
+
+/**
+ * Extreme Ritz values of a short Arnoldi run (Lanczos for symmetric A,
+ * i.e. the same recurrence with a symmetric Hessenberg matrix). Only a
+ * few products with A are needed; the extreme Ritz values approximate
+ * the extreme eigenvalues from the inside, so the condition estimate is
+ * a lower bound.
+ */
+template<typename MatrixType>
+void probe_spectrum(const MatrixType &A, std::size_t steps, AutoDecision &decision)
+{
+    using T = typename MatrixType::ElementType;
+
+    const std::size_t n = A.rows();
+    const std::size_t k = std::max<std::size_t>(std::min(steps, n), 1);
+
+    DynamicMatrix<T, columnMajor> Q(n, k + 1, T(0));
+    DynamicMatrix<T> H(k + 1, k, T(0));
+    DynamicVector<T> w(n);
+
+    // Deterministic start vector that is unlikely to be an eigenvector
+    for(std::size_t i = 0; i < n; ++i) {
+        w[i] = T(1) + T(0.1) * T(i % 7);
+    }
+    column(Q, 0) = w / norm(w);
+
+    std::size_t j = 0;
+    while(j < k) {
+        multiply(w, A, column(Q, j));
+        const T scale = norm(w);
+        for(std::size_t i = 0; i <= j; ++i) {
+            H(i, j) = trans(column(Q, i)) * w;
+            w -= H(i, j) * column(Q, i);
+        }
+        H(j + 1, j) = norm(w);
+        ++j;
+
+        if(!(H(j, j - 1) > T(1e-12) * scale)) {
+            break;
+        }
+        column(Q, j) = w / H(j, j - 1);
+    }
+
+    DynamicMatrix<T> Hj(submatrix(H, 0, 0, j, j));
+    if(decision.symmetric) {
+        DynamicVector<T> theta;
+        DynamicMatrix<T, columnMajor> V;
+        symmetric_eigen(Hj, theta, V);
+        decision.ritz_min = theta[0];
+        decision.ritz_max = theta[j - 1];
+    } else {
+        DynamicVector<complex<T>> theta(j);
+        eigen(Hj, theta);
+        decision.ritz_min = std::numeric_limits<double>::max();
+        decision.ritz_max = -std::numeric_limits<double>::max();
+        for(std::size_t i = 0; i < j; ++i) {
+            decision.ritz_min = std::min<double>(decision.ritz_min, real(theta[i]));
+            decision.ritz_max = std::max<double>(decision.ritz_max, real(theta[i]));
+        }
+    }
+
+    decision.condition_estimate = decision.ritz_min != 0.0
+                                  ? std::abs(decision.ritz_max / decision.ritz_min)
+                                  : std::numeric_limits<double>::infinity();
+}
+
+// Solvers worth trying for the analysed matrix, the preferred one first
+template<typename MatrixType>
+std::vector<AutoSolver> auto_candidates(const MatrixType &A, const AutoTag &tag, const AutoDecision &decision)
+{
+    const bool dense = IsDenseMatrix<MatrixType>::value && A.rows() <= tag.denseLimit();
+    const bool definite = decision.symmetric && decision.positive_diagonal && decision.ritz_min > 0.0;
+
+    std::vector<AutoSolver> candidates;
+    if(definite) {
+        if(decision.diagonal_dominance >= 1.0 || decision.condition_estimate < 1e3 || !dense) {
+            candidates.push_back(AutoSolver::CG);
+            if(dense) {
+                candidates.push_back(AutoSolver::PRECONDITION_CG);
+            }
+        } else {
+            candidates.push_back(AutoSolver::PRECONDITION_CG);
+            candidates.push_back(AutoSolver::CG);
+        }
+    } else if(decision.symmetric) {
+        // Indefinite: CG and BiCGSTAB may break down; MINRES minimizes the residual
+        // like GMRES, with constant memory
+        candidates.push_back(AutoSolver::MINRES);
+        candidates.push_back(AutoSolver::GMRES);
+    } else if(decision.diagonal_dominance >= 1.0 || decision.ritz_min > 0.0) {
+        // Spectrum (probably) in the right half plane
+        candidates.push_back(AutoSolver::BICGSTAB);
+        candidates.push_back(AutoSolver::GMRES);
+        if(dense) {
+            candidates.push_back(AutoSolver::PRECONDITION_BICGSTAB);
+        }
+    } else {
+        if(dense) {
+            candidates.push_back(AutoSolver::PRECONDITION_BICGSTAB);
+        }
+        candidates.push_back(AutoSolver::GMRES);
+        candidates.push_back(AutoSolver::BICGSTAB);
+    }
+    return candidates;
+}
+
+inline std::string auto_preconditioner(AutoSolver solver)
+{
+    switch(solver) {
+        case AutoSolver::PRECONDITION_CG:
+            return "incomplete_Cholesky";
+        case AutoSolver::PRECONDITION_BICGSTAB:
+            return "LU";
+        default:
+            return "";
+    }
+}
+
+template<typename TagType, typename MatrixType, typename T>
+void auto_run(DynamicVector<T> &x, const MatrixType &A, const DynamicVector<T> &b,
+              AutoTag &tag, std::size_t maximum_iterations, const std::string &preconditioner, bool adopt)
+{
+    TagType inner;
+    tag.configure(inner, maximum_iterations);
+    // Like solve_inplace(), do not start a solver whose workspace exceeds the budget
+    if(inner.memoryBudget() == 0 || inner.fitsMemoryBudget(workspace_impl(A, inner, preconditioner))) {
+        solve_impl(x, A, b, inner, preconditioner);
+    }
+    if(adopt) {
+        tag.adopt(inner);
+    }
+}
+
+// The preconditioned solvers build dense factorizations and only exist for dense matrices
+template<typename MatrixType, typename T>
+void auto_run_preconditioned(AutoSolver solver, DynamicVector<T> &x, const MatrixType &A, const DynamicVector<T> &b,
+                             AutoTag &tag, std::size_t maximum_iterations, const std::string &preconditioner,
+                             bool adopt, std::true_type)
+{
+    if(solver == AutoSolver::PRECONDITION_CG) {
+        auto_run<PreconditionCGTag>(x, A, b, tag, maximum_iterations, preconditioner, adopt);
+    } else {
+        auto_run<PreconditionBiCGSTABTag>(x, A, b, tag, maximum_iterations, preconditioner, adopt);
+    }
+}
+
+template<typename MatrixType, typename T>
+void auto_run_preconditioned(AutoSolver solver, DynamicVector<T> &x, const MatrixType &A, const DynamicVector<T> &b,
+                             AutoTag &tag, std::size_t maximum_iterations, const std::string &preconditioner,
+                             bool adopt, std::false_type)
+{
+    auto_run<GMRESTag>(x, A, b, tag, maximum_iterations, "", adopt);
+}
+
+template<typename MatrixType, typename T>
+void auto_run(AutoSolver solver, DynamicVector<T> &x, const MatrixType &A, const DynamicVector<T> &b,
+              AutoTag &tag, std::size_t maximum_iterations, const std::string &preconditioner, bool adopt)
+{
+    switch(solver) {
+        case AutoSolver::CG:
+            auto_run<ConjugateGradientTag>(x, A, b, tag, maximum_iterations, preconditioner, adopt);
+            break;
+        case AutoSolver::BICGSTAB:
+            auto_run<BiCGSTABTag>(x, A, b, tag, maximum_iterations, preconditioner, adopt);
+            break;
+        case AutoSolver::MINRES:
+            auto_run<MINRESTag>(x, A, b, tag, maximum_iterations, preconditioner, adopt);
+            break;
+        case AutoSolver::PRECONDITION_CG:
+        case AutoSolver::PRECONDITION_BICGSTAB:
+            auto_run_preconditioned(solver, x, A, b, tag, maximum_iterations, preconditioner, adopt,
+                                    std::integral_constant<bool, IsDenseMatrix<MatrixType>::value>());
+            break;
+        default:
+            auto_run<GMRESTag>(x, A, b, tag, maximum_iterations, preconditioner, adopt);
+            break;
+    }
+}
+
+/**
+ * Runs every candidate for tag.trialIterations() iterations from the
+ * initial guess and returns the one with the largest residual reduction
+ * per second, measured as -log(||r_trial|| / ||r_0||) / time.
+ */
+template<typename MatrixType, typename T>
+AutoSolver auto_trial_race(const std::vector<AutoSolver> &candidates, const DynamicVector<T> &x0,
+                           const MatrixType &A, const DynamicVector<T> &b, AutoTag &tag)
+{
+    DynamicVector<T> r(b.size());
+    residual(r, A, x0, b);
+    const double r0 = norm(r);
+    if(r0 == 0.0) {
+        return candidates.front();
+    }
+
+    AutoSolver best = candidates.front();
+    double best_rate = -std::numeric_limits<double>::max();
+    for(AutoSolver candidate : candidates) {
+        DynamicVector<T> x(x0);
+
+        const auto start = std::chrono::steady_clock::now();
+        auto_run(candidate, x, A, b, tag, tag.trialIterations(), auto_preconditioner(candidate), false);
+        const double seconds = std::max(
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), 1e-9);
+
+        residual(r, A, x, b);
+        const double reduction = std::max(double(norm(r)) / r0, 1e-300);
+        const double rate = std::isfinite(reduction) ? -std::log(reduction) / seconds
+                                                     : -std::numeric_limits<double>::max();
+        if(rate > best_rate) {
+            best_rate = rate;
+            best = candidate;
+        }
+    }
+    return best;
+}
+
+template<typename MatrixType, typename T>
+void solve_impl(
+        DynamicVector<T> &x,
+        const MatrixType &A,
+        const DynamicVector<T> &b,
+        AutoTag &tag,
+        std::string Preconditioner="")
+{
+    static_assert(IsMatrix<MatrixType>::value, "AutoTag inspects the entries of A and needs a Blaze matrix");
+
+    const std::uint64_t fingerprint = tag.exactFingerprint() ? matrix_fingerprint(A)
+                                                             : matrix_statistics_fingerprint(A);
+
+    AutoDecision decision;
+    if(!tag.lookup(fingerprint, decision)) {
+        analyse_matrix(A, decision);
+        probe_spectrum(A, tag.probeSteps(), decision);
+
+        const std::vector<AutoSolver> candidates = auto_candidates(A, tag, decision);
+        decision.solver = candidates.front();
+        if(tag.trialRace() && candidates.size() > 1) {
+            decision.solver = auto_trial_race(candidates, x, A, b, tag);
+            decision.from_trial = true;
+        }
+        decision.preconditioner = auto_preconditioner(decision.solver);
+
+        tag.record(fingerprint, decision);
+    }
+
+    auto_run(decision.solver, x, A, b, tag, tag.maximumIterations(), decision.preconditioner, true);
+}
+
+} //end namespace detail
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_AUTO_HPP
@@ -0,0 +1,180 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_AUTOTAG_HPP
+#define BLAZE_ITERATIVE_AUTOTAG_HPP
+
+#include "BlazeIterative/IterativeCommon.hpp"
+#include "BlazeIterative/IterativeTag.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <utility>
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+// Solvers AutoTag can choose from
+enum class AutoSolver : unsigned char {
+    CG,
+    BICGSTAB,
+    GMRES,
+    PRECONDITION_CG,
+    PRECONDITION_BICGSTAB,
+    MINRES
+};
+
+/**
+ * What AutoTag found out about a matrix and which solver it picked.
+ */
+struct AutoDecision
+{
+    AutoSolver solver{AutoSolver::GMRES};
+    std::string preconditioner;
+
+    // Properties of A
+    bool symmetric{false};
+    bool positive_diagonal{false};
+    double diagonal_dominance{0.0};   // min_i |a_ii| / sum_{j != i} |a_ij|
+    double density{0.0};              // nonzeros / (rows * columns)
+
+    // Spectrum probe: extreme Ritz values of a short Lanczos/Arnoldi run
+    double ritz_min{0.0};             // smallest (real part of a) Ritz value
+    double ritz_max{0.0};             // largest (real part of a) Ritz value
+    double condition_estimate{0.0};   // |ritz_max / ritz_min|, a lower bound
+
+    bool from_trial{false};           // decided by the trial race
+    bool from_cache{false};           // reused for a matrix seen before
+};
+
+/**
+ * \class AutoTag
+ * \brief Tag type that chooses the solver and preconditioner itself.
+ *
+ * On the first solve with a matrix, AutoTag inspects A (symmetry, sign of
+ * the diagonal, diagonal dominance, density) and runs a short Lanczos or
+ * Arnoldi probe of the spectrum. From that it picks CG, MINRES (symmetric
+ * indefinite A), BiCGSTAB, GMRES or one of the preconditioned solvers. With trialRace() enabled, the
+ * plausible candidates additionally run trialIterations() iterations each
+ * and the one with the fastest residual reduction per second wins.
+ *
+ * Decisions are cached on the tag under a fingerprint of A, so solving
+ * with the same matrix again skips the analysis. By default the
+ * fingerprint covers the dimensions and the sparsity pattern exactly, but
+ * the values only through a few quantized statistics (sign and spread of
+ * the diagonal, diagonal dominance, symmetry). The slowly changing
+ * operators of a time integration therefore reuse the decision of an
+ * earlier step; exactFingerprint() hashes all values instead. The cache
+ * keeps the cacheCapacity() most recently used decisions.
+ *
+ * Tolerances, iteration limit and logging of the tag are passed on to the
+ * chosen solver; its status and history end up in this tag.
+ */
+class AutoTag : public IterativeTag
+{
+public:
+    AutoTag() {
+        solverName = "Auto";
+    }
+
+    // Run the candidate solvers for a few iterations before deciding
+    bool &trialRace() { return trial_race; }
+
+    bool trialRace() const { return trial_race; }
+
+    std::size_t &trialIterations() { return trial_iterations; }
+
+    std::size_t trialIterations() const { return trial_iterations; }
+
+    // Steps of the Lanczos/Arnoldi spectrum probe
+    std::size_t &probeSteps() { return probe_steps; }
+
+    std::size_t probeSteps() const { return probe_steps; }
+
+    // Largest size for which the (dense) preconditioned solvers are considered
+    std::size_t &denseLimit() { return dense_limit; }
+
+    std::size_t denseLimit() const { return dense_limit; }
+
+    // Hash all values of A instead of quantized statistics, so only identical matrices share a decision
+    bool &exactFingerprint() { return exact_fingerprint; }
+
+    bool exactFingerprint() const { return exact_fingerprint; }
+
+    // Number of decisions kept; the least recently used one is dropped first
+    std::size_t &cacheCapacity() { return cache_capacity; }
+
+    std::size_t cacheCapacity() const { return cache_capacity; }
+
+    // Decision used by the last solve
+    const AutoDecision &decision() const { return last_decision; }
+
+    std::size_t cacheSize() const { return decisions.size(); }
+
+    void clearCache() { decisions.clear(); }
+
+    // Cached decision for a fingerprint; also makes it the current decision()
+    bool lookup(std::uint64_t fingerprint, AutoDecision &decision)
+    {
+        for(auto it = decisions.begin(); it != decisions.end(); ++it) {
+            if(it->first == fingerprint) {
+                decisions.splice(decisions.begin(), decisions, it);
+                decision = it->second;
+                decision.from_cache = true;
+                last_decision = decision;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void record(std::uint64_t fingerprint, const AutoDecision &decision)
+    {
+        decisions.emplace_front(fingerprint, decision);
+        while(decisions.size() > std::max<std::size_t>(cache_capacity, 1)) {
+            decisions.pop_back();
+        }
+        last_decision = decision;
+    }
+
+    // Copies tolerances, iteration limit, logging, reduction mode and memory budget to the tag of the chosen solver
+    template<typename TagType>
+    void configure(TagType &tag, std::size_t maximum_iterations) const
+    {
+        tag.relativeResidualTolerance() = relative_residual_tolerance;
+        tag.absoluteResidualTolerance() = absolute_residual_tolerance;
+        tag.maximumIterations() = maximum_iterations;
+        tag.do_log() = record_convergence_history;
+        tag.tracer() = tracer_;
+        tag.reductionMode() = reduction_mode;
+        tag.memoryBudget() = memory_budget;
+    }
+
+    // Takes over the outcome of the solve with the chosen solver
+    void adopt(const IterativeTag &tag)
+    {
+        terminationStatus = tag.status();
+        convergence_history_container.insert(convergence_history_container.end(),
+                                             tag.convergence_history().begin(),
+                                             tag.convergence_history().end());
+    }
+
+protected:
+    bool trial_race{false};
+    std::size_t trial_iterations{10};
+    std::size_t probe_steps{12};
+    std::size_t dense_limit{2000};
+    bool exact_fingerprint{false};
+    std::size_t cache_capacity{8};
+    AutoDecision last_decision;
+    std::list<std::pair<std::uint64_t, AutoDecision>> decisions;   // most recently used first
+};
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_AUTOTAG_HPP
@@ -6,6 +6,10 @@
 #ifndef BLAZE_ITERATIVE_BICGSTAB_HPP
 #define BLAZE_ITERATIVE_BICGSTAB_HPP
 
+#include "BlazeIterative/LinearOperator.hpp"
+#include "BlazeIterative/Reduction.hpp"
+#include "BlazeIterative/Trace.hpp"
+#include "BlazeIterative/Workspace.hpp"
 #include "BiCGSTABTag.hpp"
 
 BLAZE_NAMESPACE_OPEN
@@ -27,7 +31,10 @@ void solve_impl(
         std::string Preconditioner="")
 {
 
-    DynamicVector<T> r = b - A * x;
+    TraceScope trace_solve(tag, "solve", "solve");
+
+    DynamicVector<T> r(b.size());
+    residual(r, A, x, b);
     DynamicVector<T> p(r);
     DynamicVector<T> v(r);
     DynamicVector<T> r0(r);
@@ -35,7 +42,7 @@ void solve_impl(
     DynamicVector<T> t(p.size());
     DynamicVector<T> error(r);
 
-    auto absolute_residual_0 = trans(r) * r;
+    auto absolute_residual_0 = dot_product(tag, r, r);
     auto absolute_residual = absolute_residual_0;
 
     auto rho_prev = T(1);
@@ -44,32 +51,56 @@ void solve_impl(
 
 
     std::size_t iteration{0};
+    tag.reserve_log(tag.maximumIterations() + 2);
     while (true) {
+        TraceScope trace_iteration(tag, "iteration", "iteration", iteration);
 
-        auto rho = trans(r0) * r;
+        T rho;
+        {
+            TraceScope trace(tag, "r0.r", "reduction", iteration);
+            rho = dot_product(tag, r0, r);
+        }
         auto beta = (rho * alpha) / (rho_prev * w);
 
         p = r + beta * (p - w * v);
-        v = A * p;
-        alpha = rho / (trans(r0) * v);
+        {
+            TraceScope trace(tag, "spmv", "spmv", iteration);
+            multiply(v, A, p);
+        }
+        {
+            TraceScope trace(tag, "r0.v", "reduction", iteration);
+            alpha = rho / dot_product(tag, r0, v);
+        }
 
         s = r - alpha * v;
-        t = A*s;
+        {
+            TraceScope trace(tag, "spmv", "spmv", iteration);
+            multiply(t, A, s);
+        }
 
         // sometimes, t will be zero, so trans(t)*t is zero.
         // This happens if the solution is exactly correct,
         // So best to set w=0, and loop will terminate below.
-        auto t_dot_t = (trans(t)*t);
-        if(t_dot_t == 0)
-            w = 0;
-        else
-            w = (trans(t)*s)/t_dot_t;
+        {
+            TraceScope trace(tag, "t.t, t.s", "reduction", iteration);
+            auto t_dot_t = dot_product(tag, t, t);
+            if(t_dot_t == 0)
+                w = 0;
+            else
+                w = dot_product(tag, t, s)/t_dot_t;
+        }
 
 
         x += alpha*p + w*s;
 
-        error = b - A*x;
-        absolute_residual = trans(error)*error;
+        {
+            TraceScope trace(tag, "residual", "spmv", iteration);
+            residual(error, A, x, b);
+        }
+        {
+            TraceScope trace(tag, "r.r", "reduction", iteration);
+            absolute_residual = dot_product(tag, error, error);
+        }
         auto relative_residual = absolute_residual/absolute_residual_0;
         if(tag.do_log()) {
             tag.log_residual(relative_residual);
@@ -87,6 +118,13 @@ void solve_impl(
 
 }
 
+// r, p, v, r0, s, t and the true residual
+template<typename MatrixType>
+std::size_t workspace_impl(const MatrixType &A, const BiCGSTABTag &tag, const std::string &Preconditioner)
+{
+    return dense_bytes(A.rows(), 7, sizeof(typename MatrixType::ElementType));
+}
+
 } //end namespace detail
 
 ITERATIVE_NAMESPACE_CLOSE
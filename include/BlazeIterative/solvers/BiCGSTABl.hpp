@@ -0,0 +1,215 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_BICGSTABL_HPP
+#define BLAZE_ITERATIVE_BICGSTABL_HPP
+
+#include "BlazeIterative/IterativeCommon.hpp"
+#include "BlazeIterative/LinearOperator.hpp"
+#include "BlazeIterative/Reduction.hpp"
+#include "BlazeIterative/Trace.hpp"
+#include "BlazeIterative/Workspace.hpp"
+#include "BiCGSTABlTag.hpp"
+#include <type_traits>
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+namespace detail {
+
+/**
+ *  Implementation of BiCGSTAB(l), following Sleijpen and Fokkema,
+ *  "BiCGstab(l) for linear equations involving unsymmetric matrices with
+ *  complex spectrum" (1993), with the minimal residual part computed by
+ *  modified Gram-Schmidt. With a preconditioner the method runs on
+ *  A M^-1 y = r_0 and x = x_0 + M^-1 y is formed once at the end; the
+ *  residuals of both systems are the same.
+ */
+template<typename MatrixType, typename T>
+void solve_impl(
+        DynamicVector<T> &x,
+        const MatrixType &A,
+        const DynamicVector<T> &b,
+        BiCGSTABlTag &tag,
+        std::string Preconditioner="")
+{
+    static_assert(std::is_same<T, double>::value, "The BiCGSTAB(l) preconditioner callback works on double vectors");
+
+    BLAZE_INTERNAL_ASSERT(tag.polynomialDegree() >= 1, "l must be larger than or equal to 1")
+
+    TraceScope trace_solve(tag, "solve", "solve");
+
+    const std::size_t m = b.size();
+    const std::size_t l = tag.polynomialDegree();
+
+    const T norm_b = vector_norm(tag, b);
+    if(norm_b == T(0)) {
+        reset(x);
+        return;
+    }
+
+    // Columns 0..l hold r_j = (A M^-1)^j r and u_j = (A M^-1)^j u
+    DynamicMatrix<T, columnMajor> R(m, l + 1, T(0));
+    DynamicMatrix<T, columnMajor> U(m, l + 1, T(0));
+    DynamicMatrix<T> tau(l + 1, l + 1, T(0));
+    DynamicVector<T> sigma(l + 1, T(0));
+    DynamicVector<T> gamma(l + 1, T(0));
+    DynamicVector<T> gamma_1(l + 1, T(0));
+    DynamicVector<T> gamma_2(l + 1, T(0));
+    DynamicVector<T> y(m, T(0));
+    DynamicVector<T> z(m);
+    DynamicVector<T> w(m);
+    DynamicVector<T> r_shadow(m);
+
+    residual(w, A, x, b);
+    column(R, 0) = w;
+    r_shadow = w;
+
+    // w = A M^-1 column j of V
+    auto apply_operator = [&](const DynamicMatrix<T, columnMajor> &V, std::size_t j, std::size_t iteration) {
+        w = column(V, j);
+        {
+            TraceScope trace(tag, "preconditioner", "preconditioner", iteration);
+            if(tag.preconditioner()) {
+                tag.preconditioner()(z, w);
+            } else {
+                z = w;
+            }
+        }
+        TraceScope trace(tag, "spmv", "spmv", iteration);
+        multiply(w, A, z);
+    };
+
+    T rho_0 = T(1);
+    T alpha = T(0);
+    T omega = T(1);
+
+    std::size_t iteration{0};
+    tag.reserve_log(tag.maximumIterations() + 2);
+    bool terminated = false;
+    while(!terminated) {
+        rho_0 = -omega * rho_0;
+
+        // BiCG part: l steps, each multiplying by A twice
+        bool breakdown = false;
+        for(std::size_t j = 0; j < l; ++j) {
+            TraceScope trace_iteration(tag, "iteration", "iteration", iteration + j);
+
+            T rho_1;
+            {
+                TraceScope trace(tag, "r~.r", "reduction", iteration + j);
+                rho_1 = dot_product(tag, r_shadow, column(R, j));
+            }
+            if(rho_0 == T(0)) {
+                breakdown = true;
+                break;
+            }
+            const T beta = alpha * rho_1 / rho_0;
+            rho_0 = rho_1;
+            for(std::size_t i = 0; i <= j; ++i) {
+                column(U, i) = column(R, i) - beta * column(U, i);
+            }
+
+            apply_operator(U, j, iteration + j);
+            column(U, j + 1) = w;
+            T gamma_j;
+            {
+                TraceScope trace(tag, "r~.u", "reduction", iteration + j);
+                gamma_j = dot_product(tag, r_shadow, w);
+            }
+            if(gamma_j == T(0)) {
+                breakdown = true;
+                break;
+            }
+            alpha = rho_0 / gamma_j;
+            for(std::size_t i = 0; i <= j; ++i) {
+                column(R, i) -= alpha * column(U, i + 1);
+            }
+
+            apply_operator(R, j, iteration + j);
+            column(R, j + 1) = w;
+            y += alpha * column(U, 0);
+        }
+
+        if(!breakdown) {
+            // MR part: minimize ||r_0 - sum gamma_j r_j|| over the polynomial coefficients
+            TraceScope trace(tag, "minimal residual", "orthogonalization", iteration);
+            for(std::size_t j = 1; j <= l; ++j) {
+                for(std::size_t i = 1; i < j; ++i) {
+                    tau(i, j) = sigma[i] > T(0) ? dot_product(tag, column(R, j), column(R, i)) / sigma[i] : T(0);
+                    column(R, j) -= tau(i, j) * column(R, i);
+                }
+                sigma[j] = dot_product(tag, column(R, j), column(R, j));
+                gamma_1[j] = sigma[j] > T(0) ? dot_product(tag, column(R, 0), column(R, j)) / sigma[j] : T(0);
+            }
+
+            gamma[l] = gamma_1[l];
+            omega = gamma[l];
+            for(std::size_t j = l - 1; j >= 1; --j) {
+                gamma[j] = gamma_1[j];
+                for(std::size_t i = j + 1; i <= l; ++i) {
+                    gamma[j] -= tau(j, i) * gamma[i];
+                }
+            }
+            for(std::size_t j = 1; j < l; ++j) {
+                gamma_2[j] = gamma[j + 1];
+                for(std::size_t i = j + 1; i < l; ++i) {
+                    gamma_2[j] += tau(j, i) * gamma[i + 1];
+                }
+            }
+
+            y += gamma[1] * column(R, 0);
+            column(R, 0) -= gamma_1[l] * column(R, l);
+            column(U, 0) -= gamma[l] * column(U, l);
+            for(std::size_t j = 1; j < l; ++j) {
+                column(U, 0) -= gamma[j] * column(U, j);
+                y += gamma_2[j] * column(R, j);
+                column(R, 0) -= gamma_1[j] * column(R, j);
+            }
+        }
+
+        iteration += l;
+
+        T absolute_residual;
+        {
+            TraceScope trace(tag, "r.r", "reduction", iteration);
+            absolute_residual = vector_norm(tag, column(R, 0));
+        }
+        const T relative_residual = absolute_residual / norm_b;
+        if(tag.do_log()) {
+            tag.log_residual(relative_residual);
+        }
+
+        terminated = tag.terminateIteration(iteration, absolute_residual, relative_residual) || breakdown
+                     || omega == T(0);
+    }
+
+    if(tag.preconditioner()) {
+        TraceScope trace(tag, "preconditioner", "preconditioner", iteration);
+        tag.preconditioner()(z, y);
+        x += z;
+    } else {
+        x += y;
+    }
+}
+
+// R and U with l + 1 columns, y, z, w, the shadow residual and the small MR system
+template<typename MatrixType>
+std::size_t workspace_impl(const MatrixType &A, const BiCGSTABlTag &tag, const std::string &Preconditioner)
+{
+    using T = typename MatrixType::ElementType;
+
+    const std::size_t m = A.rows();
+    const std::size_t l = tag.polynomialDegree();
+    return dense_bytes(m, 2 * l + 6, sizeof(T)) + dense_bytes(l + 1, l + 5, sizeof(T));
+}
+
+} //end namespace detail
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_BICGSTABL_HPP
@@ -0,0 +1,67 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_BICGSTABLTAG_HPP
+#define BLAZE_ITERATIVE_BICGSTABLTAG_HPP
+
+#include <BlazeIterative/IterativeCommon.hpp>
+#include <BlazeIterative/IterativeTag.hpp>
+#include <functional>
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+/**
+ * \class BiCGSTABlTag
+ * \brief Tag type to dispatch a BiCGSTAB(l) solver
+ *
+ * BiCGSTAB(l) (Sleijpen and Fokkema 1993) follows l BiCG steps by a
+ * minimal residual polynomial of degree l, where BiCGSTAB uses degree 1.
+ * The higher degree avoids the stagnation of BiCGSTAB on matrices with
+ * eigenvalues close to the imaginary axis, as in convection-dominated
+ * problems. Memory is 2l + 6 vectors; a cycle takes 2l matrix-vector
+ * products.
+ *
+ * The preconditioner is an optional callback computing z ~ M^-1 v, used
+ * as a right preconditioner:
+ * \code
+ * BiCGSTABlTag tag;
+ * tag.polynomialDegree() = 4;
+ * auto x = solve(A, b, tag);
+ * \endcode
+ *
+ * One iteration is one BiCG step (two products, as for BiCGSTAB), so a
+ * cycle counts l iterations and termination is checked after every
+ * cycle. The residuals checked by terminateIteration() are ||r|| and
+ * ||r|| / ||b||.
+ */
+class BiCGSTABlTag : public IterativeTag
+{
+public:
+    using PreconditionerType = std::function<void(DynamicVector<double> &, const DynamicVector<double> &)>;
+
+    BiCGSTABlTag() {
+        solverName = "BiCGSTAB(l)";
+    }
+
+    // l, the degree of the minimal residual polynomial
+    std::size_t &polynomialDegree() { return polynomial_degree; }
+
+    std::size_t polynomialDegree() const { return polynomial_degree; }
+
+    PreconditionerType &preconditioner() { return apply_preconditioner; }
+
+    const PreconditionerType &preconditioner() const { return apply_preconditioner; }
+
+protected:
+    std::size_t polynomial_degree{2};
+    PreconditionerType apply_preconditioner;
+};
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_BICGSTABLTAG_HPP
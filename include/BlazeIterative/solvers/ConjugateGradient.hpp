@@ -7,6 +7,11 @@
 #define BLAZE_ITERATIVE_CONJUGATEGRADIENT_HPP
 
 #include "BlazeIterative/IterativeCommon.hpp"
+#include "BlazeIterative/Checkpoint.hpp"
+#include "BlazeIterative/LinearOperator.hpp"
+#include "BlazeIterative/Reduction.hpp"
+#include "BlazeIterative/Trace.hpp"
+#include "BlazeIterative/Workspace.hpp"
 #include "ConjugateGradientTag.hpp"
 
 
@@ -26,30 +31,67 @@ void solve_impl(
 
     BLAZE_INTERNAL_ASSERT(isSymmetric(A), "A must be a symmetric matrix")
 
-    DynamicVector<T> r = b - A*x;
+    TraceScope trace_solve(tag, "solve", "solve");
+
+    DynamicVector<T> r(b.size());
+    residual(r, A, x, b);
     DynamicVector<T> p(r);
     DynamicVector<T> Ap(p.size());
 
-    auto absolute_residual_0 = trans(r)*r;
+    auto absolute_residual_0 = dot_product(tag, r, r);
     auto absolute_residual = absolute_residual_0;
     auto absolute_residual_prev = absolute_residual;
 
-    if(tag.do_log()) {
-        tag.log_residual(absolute_residual/absolute_residual_0);
+    std::size_t iteration{0};
+    tag.reserve_log(tag.maximumIterations() + 2);
+
+    // Checkpoint slot: iteration, residuals, x, r, p and the history of this solve
+    const std::size_t m = b.size();
+    const std::size_t history_capacity = tag.maximumIterations() + 2;
+    const std::size_t history_offset = tag.convergence_history().size();
+    const auto layout = checkpoint_layout(tag.name(), m, 0, sizeof(T), sizeof(T),
+                                          sizeof(std::uint64_t) + 2 * sizeof(T) + 3 * m * sizeof(T)
+                                          + checkpoint_history_size(history_capacity));
+    CheckpointFile checkpoint;
+
+    if(tag.resumeFromCheckpoint() && checkpoint.open(tag.checkpointFile(), layout)) {
+        std::uint64_t stored_iteration;
+        CheckpointReader(checkpoint.slot(checkpoint.activeSlot()))
+                .scalar(stored_iteration).scalar(absolute_residual).scalar(absolute_residual_0)
+                .vector(x).vector(r).vector(p)
+                .history(tag.convergence_history(), history_capacity);
+        iteration = stored_iteration;
+    } else {
+        if(tag.checkpointInterval() > 0) {
+            checkpoint.create(tag.checkpointFile(), layout);
+        }
+        if(tag.do_log()) {
+            tag.log_residual(absolute_residual/absolute_residual_0);
+        }
     }
 
 
-    std::size_t iteration{0};
     while(true) {
+        TraceScope trace_iteration(tag, "iteration", "iteration", iteration);
+
         absolute_residual_prev = absolute_residual;
-        Ap = declsym(A)*p;
+        {
+            TraceScope trace(tag, "spmv", "spmv", iteration);
+            symmetric_multiply(Ap, A, p);
+        }
 
-        auto alpha = absolute_residual/(trans(p)*Ap);
+        T alpha;
+        {
+            TraceScope trace(tag, "p.Ap", "reduction", iteration);
+            alpha = absolute_residual/dot_product(tag, p, Ap);
+        }
         x += alpha*p;
         r -= alpha*Ap;
 
-
-        absolute_residual = trans(r)*r;
+        {
+            TraceScope trace(tag, "r.r", "reduction", iteration);
+            absolute_residual = dot_product(tag, r, r);
+        }
 
         if(tag.do_log()) {
             tag.log_residual(absolute_residual/absolute_residual_0);
@@ -63,12 +105,28 @@ void solve_impl(
         p = r + beta*p;
 
         ++iteration;
+
+        if(checkpoint.isOpen() && tag.checkpointInterval() > 0 && iteration % tag.checkpointInterval() == 0) {
+            const std::size_t slot = checkpoint.nextSlot();
+            CheckpointWriter(checkpoint.slot(slot))
+                    .scalar(static_cast<std::uint64_t>(iteration)).scalar(absolute_residual).scalar(absolute_residual_0)
+                    .vector(x).vector(r).vector(p)
+                    .history(tag.convergence_history(), history_offset, history_capacity);
+            checkpoint.commit(slot);
+        }
     }//end while
 
 
 };
 
 
+// r, p and Ap
+template<typename MatrixType>
+std::size_t workspace_impl(const MatrixType &A, const ConjugateGradientTag &tag, const std::string &Preconditioner)
+{
+    return dense_bytes(A.rows(), 3, sizeof(typename MatrixType::ElementType));
+}
+
 } //end namespace detail
 
 ITERATIVE_NAMESPACE_CLOSE
@@ -0,0 +1,174 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_DEFLATEDCG_HPP
+#define BLAZE_ITERATIVE_DEFLATEDCG_HPP
+
+#include "BlazeIterative/IterativeCommon.hpp"
+#include "BlazeIterative/LinearOperator.hpp"
+#include "BlazeIterative/Reduction.hpp"
+#include "BlazeIterative/Workspace.hpp"
+#include "DeflatedCGTag.hpp"
+#include "DenseSubspace.hpp"
+
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+namespace detail {
+
+/**
+ *  Deflated CG following Saad, Yeung, Erhel and Guyomarc'h,
+ *  "A deflated version of the conjugate gradient algorithm" (2000).
+ *  The search directions are kept A-orthogonal to the recycled space W,
+ *  which removes the eigenvalues captured by W from the convergence rate.
+ */
+template<typename MatrixType, typename T>
+void solve_impl(
+        DynamicVector<T> &x,
+        const MatrixType &A,
+        const DynamicVector<T> &b,
+        DeflatedCGTag &tag,
+        std::string Preconditioner="")
+{
+
+    BLAZE_INTERNAL_ASSERT(isSymmetric(A), "A must be a symmetric matrix")
+
+    const std::size_t m = b.size();
+
+    // A recycled space of a different problem size cannot be reused
+    DynamicMatrix<T, columnMajor> W(tag.recycledSpace());
+    if(W.rows() != m) {
+        W.resize(m, 0, false);
+    }
+    const std::size_t k = W.columns();
+
+    DynamicMatrix<T, columnMajor> AW(m, k);
+    DynamicMatrix<T> WtAW_inv(k, k);
+    DynamicVector<T> mu(k);
+    DynamicVector<T> AWr(k);
+
+    DynamicVector<T> r(m);
+    residual(r, A, x, b);
+
+    auto absolute_residual_0 = dot_product(tag, r, r);
+
+    if(k > 0) {
+        multiply_columns(AW, A, W);
+        WtAW_inv = trans(W) * AW;
+        invert(WtAW_inv);
+
+        // Initial guess with a residual orthogonal to W
+        mu = WtAW_inv * (trans(W) * r);
+        x += W * mu;
+        residual(r, A, x, b);
+    }
+
+    DynamicVector<T> p(r);
+    DynamicVector<T> Ap(m);
+
+    if(k > 0) {
+        AWr = trans(AW) * r;
+        mu = WtAW_inv * AWr;
+        p -= W * mu;
+    }
+
+    auto absolute_residual = dot_product(tag, r, r);
+    auto absolute_residual_prev = absolute_residual;
+
+    tag.reserve_log(tag.maximumIterations() + 2);
+    if(tag.do_log()) {
+        tag.log_residual(absolute_residual/absolute_residual_0);
+    }
+
+    // The first search directions are kept to refine W after the solve
+    const std::size_t s = std::min(tag.storedDirections(), m);
+    DynamicMatrix<T, columnMajor> P(m, s);
+    DynamicMatrix<T, columnMajor> AP(m, s);
+    std::size_t stored{0};
+
+    std::size_t iteration{0};
+    while(true) {
+        absolute_residual_prev = absolute_residual;
+        symmetric_multiply(Ap, A, p);
+
+        if(stored < s) {
+            column(P, stored) = p;
+            column(AP, stored) = Ap;
+            ++stored;
+        }
+
+        auto alpha = absolute_residual/dot_product(tag, p, Ap);
+        x += alpha*p;
+        r -= alpha*Ap;
+
+        absolute_residual = dot_product(tag, r, r);
+
+        if(tag.do_log()) {
+            tag.log_residual(absolute_residual/absolute_residual_0);
+        }
+
+        if(tag.terminateIteration(iteration, absolute_residual, absolute_residual/absolute_residual_0)) {
+            break;
+        }
+
+        auto beta = absolute_residual/absolute_residual_prev;
+        if(k > 0) {
+            AWr = trans(AW) * r;
+            mu = WtAW_inv * AWr;
+            p = beta*p + r;
+            p -= W*mu;
+        } else {
+            p = r + beta*p;
+        }
+
+        ++iteration;
+    }//end while
+
+    // Rayleigh-Ritz on span{W, P}: the Ritz vectors of the smallest
+    // Ritz values become the recycled space of the next solve
+    const std::size_t nz = k + stored;
+    if(nz == 0) {
+        return;
+    }
+
+    DynamicMatrix<T, columnMajor> Z(m, nz);
+    DynamicMatrix<T, columnMajor> AZ(m, nz);
+    if(k > 0) {
+        submatrix(Z, 0, 0, m, k) = W;
+        submatrix(AZ, 0, 0, m, k) = AW;
+    }
+    submatrix(Z, 0, k, m, stored) = submatrix(P, 0, 0, m, stored);
+    submatrix(AZ, 0, k, m, stored) = submatrix(AP, 0, 0, m, stored);
+
+    DynamicMatrix<T> F = trans(Z) * AZ;
+    DynamicMatrix<T> G = trans(Z) * Z;
+    DynamicMatrix<T, columnMajor> Y;
+    smallest_ritz_vectors(F, G, tag.recycleSize(), Y);
+
+    tag.recycledSpace() = Z * Y;
+};
+
+
+// Peak during the Rayleigh-Ritz step after the iteration: W, AW, P, AP, Z, AZ and the new recycled space
+template<typename MatrixType>
+std::size_t workspace_impl(const MatrixType &A, const DeflatedCGTag &tag, const std::string &Preconditioner)
+{
+    using T = typename MatrixType::ElementType;
+
+    const std::size_t m = A.rows();
+    const std::size_t k = tag.recycledSpace().rows() == m ? tag.recycledSpace().columns() : 0;
+    const std::size_t s = std::min(tag.storedDirections(), m);
+    return dense_bytes(m, 4 * (k + s) + 3 + tag.recycleSize(), sizeof(T))
+           + dense_bytes(k + s, 3 * (k + s), sizeof(T)) + dense_bytes(k, k + 2, sizeof(T));
+}
+
+} //end namespace detail
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_DEFLATEDCG_HPP
@@ -0,0 +1,59 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_DEFLATEDCGTAG_HPP
+#define BLAZE_ITERATIVE_DEFLATEDCGTAG_HPP
+
+#include "BlazeIterative/IterativeCommon.hpp"
+#include "BlazeIterative/IterativeTag.hpp"
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+/**
+ * \class DeflatedCGTag
+ * \brief Tag type to dispatch a deflated Conjugate Gradient solver
+ *
+ * Deflated CG keeps the iteration A-orthogonal to a small recycled space W
+ * of approximate eigenvectors belonging to the smallest eigenvalues of A.
+ * W is stored on the tag: after each solve it is replaced by the Ritz
+ * vectors of span{W, first search directions}, so reusing the same tag for a
+ * sequence of related SPD systems lowers the iteration counts along the
+ * sequence. Call clearRecycledSpace() when the next system is unrelated.
+ */
+class DeflatedCGTag : public IterativeTag
+{
+public:
+    DeflatedCGTag() {
+        solverName = "Deflated Conjugate Gradient";
+    }
+
+    // Number of approximate eigenvectors kept between solves
+    std::size_t &recycleSize() { return recycle_size; }
+
+    std::size_t recycleSize() const { return recycle_size; }
+
+    // Number of search directions of each solve used to update the recycled space
+    std::size_t &storedDirections() { return stored_directions; }
+
+    std::size_t storedDirections() const { return stored_directions; }
+
+    DynamicMatrix<double, columnMajor> &recycledSpace() { return recycled_space; }
+
+    const DynamicMatrix<double, columnMajor> &recycledSpace() const { return recycled_space; }
+
+    void clearRecycledSpace() { recycled_space.clear(); }
+
+protected:
+    std::size_t recycle_size{4};
+    std::size_t stored_directions{8};
+    DynamicMatrix<double, columnMajor> recycled_space;
+};
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_DEFLATEDCGTAG_HPP
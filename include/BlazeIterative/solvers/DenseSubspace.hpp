@@ -0,0 +1,269 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_DENSESUBSPACE_HPP
+#define BLAZE_ITERATIVE_DENSESUBSPACE_HPP
+
+#include <BlazeIterative/IterativeCommon.hpp>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+namespace detail {
+
+/**
+ * Eigenvalues (ascending) and eigenvectors (columns of V) of the
+ * symmetric part of a small dense matrix.
+ */
+template<typename T>
+void symmetric_eigen(const DynamicMatrix<T> &M, DynamicVector<T> &w, DynamicMatrix<T, columnMajor> &V)
+{
+    const std::size_t n = M.rows();
+
+    SymmetricMatrix<DynamicMatrix<T, columnMajor>> S(n);
+    for(std::size_t j = 0; j < n; ++j) {
+        for(std::size_t i = 0; i <= j; ++i) {
+            S(i, j) = T(0.5) * (M(i, j) + M(j, i));
+        }
+    }
+
+    w.resize(n, false);
+    V.resize(n, n, false);
+    eigen(S, w, V);
+}
+
+/**
+ * Thin QR factorization M = Q * R of a tall matrix by modified
+ * Gram-Schmidt with one reorthogonalization pass.
+ * Returns false if M is numerically rank deficient.
+ */
+template<typename MT, typename T>
+bool thin_qr(const MT &M, DynamicMatrix<T, columnMajor> &Q, DynamicMatrix<T> &R)
+{
+    const std::size_t k = M.columns();
+
+    Q = M;
+    R.resize(k, k, false);
+    reset(R);
+
+    for(std::size_t j = 0; j < k; ++j) {
+        const T norm_in = norm(column(Q, j));
+
+        for(int pass = 0; pass < 2; ++pass) {
+            for(std::size_t i = 0; i < j; ++i) {
+                const T c = trans(column(Q, i)) * column(Q, j);
+                R(i, j) += c;
+                column(Q, j) -= c * column(Q, i);
+            }
+        }
+
+        R(j, j) = norm(column(Q, j));
+        if(!(R(j, j) > T(1e-12) * norm_in)) {
+            return false;
+        }
+        column(Q, j) /= R(j, j);
+    }
+
+    return true;
+}
+
+/**
+ * Rayleigh-Ritz for the symmetric-definite pencil (F, G):
+ * solves F y = theta G y on the numerically nonsingular part of G and
+ * returns the G-orthonormal eigenvectors of the "count" smallest
+ * Ritz values as the columns of Y.
+ */
+template<typename T>
+void smallest_ritz_vectors(const DynamicMatrix<T> &F,
+                           const DynamicMatrix<T> &G,
+                           std::size_t count,
+                           DynamicMatrix<T, columnMajor> &Y)
+{
+    const std::size_t n = G.rows();
+    if(n == 0) {
+        Y.resize(0, 0, false);
+        return;
+    }
+
+    DynamicVector<T> g;
+    DynamicMatrix<T, columnMajor> U;
+    symmetric_eigen(G, g, U);
+
+    // Directions with tiny Gram eigenvalues are (nearly) linearly dependent
+    std::size_t rank = 0;
+    while(rank < n && g[n - rank - 1] > T(1e-10) * g[n - 1]) {
+        ++rank;
+    }
+
+    DynamicMatrix<T, columnMajor> S(n, rank);
+    for(std::size_t j = 0; j < rank; ++j) {
+        column(S, j) = column(U, n - rank + j) / std::sqrt(g[n - rank + j]);
+    }
+
+    DynamicMatrix<T> F_reduced = trans(S) * F * S;
+    DynamicVector<T> theta;
+    DynamicMatrix<T, columnMajor> V;
+    symmetric_eigen(F_reduced, theta, V);
+
+    count = std::min(count, rank);
+    Y = S * submatrix(V, 0, 0, rank, count);
+}
+
+/**
+ * Solves A X = B for X in place of B by Gaussian elimination with
+ * partial pivoting; A is overwritten by its LU factors and pivots must
+ * hold n entries. Allocates nothing. Returns false if A is singular.
+ */
+template<typename T, bool SO1, bool SO2>
+bool solve_dense_inplace(DynamicMatrix<T, SO1> &A, DynamicMatrix<T, SO2> &B, std::vector<std::size_t> &pivots)
+{
+    const std::size_t n = A.rows();
+
+    for(std::size_t k = 0; k < n; ++k) {
+        std::size_t p = k;
+        for(std::size_t i = k + 1; i < n; ++i) {
+            if(std::abs(A(i, k)) > std::abs(A(p, k))) {
+                p = i;
+            }
+        }
+        if(A(p, k) == T(0)) {
+            return false;
+        }
+        pivots[k] = p;
+        if(p != k) {
+            for(std::size_t j = 0; j < n; ++j) {
+                std::swap(A(k, j), A(p, j));
+            }
+            for(std::size_t j = 0; j < B.columns(); ++j) {
+                std::swap(B(k, j), B(p, j));
+            }
+        }
+        for(std::size_t i = k + 1; i < n; ++i) {
+            const T l = A(i, k) / A(k, k);
+            A(i, k) = l;
+            for(std::size_t j = k + 1; j < n; ++j) {
+                A(i, j) -= l * A(k, j);
+            }
+            for(std::size_t j = 0; j < B.columns(); ++j) {
+                B(i, j) -= l * B(k, j);
+            }
+        }
+    }
+
+    for(std::size_t j = 0; j < B.columns(); ++j) {
+        for(std::size_t i = n; i-- > 0; ) {
+            T sum = B(i, j);
+            for(std::size_t l = i + 1; l < n; ++l) {
+                sum -= A(i, l) * B(l, j);
+            }
+            B(i, j) = sum / A(i, i);
+        }
+    }
+    return true;
+}
+
+/**
+ * Work arrays of smallest_eigenvectors() for matrices of up to n_max
+ * rows. The LAPACK work size is queried once here, so that the
+ * eigenvalue problems of a restart loop do not allocate.
+ */
+template<typename T>
+struct EigenWorkspace
+{
+    explicit EigenWorkspace(std::size_t n_max)
+            : A(n_max, n_max, T(0)), VR(n_max, n_max, T(0)), wr(n_max), wi(n_max), work(1)
+    {
+        order.reserve(n_max);
+
+        int info = 0;
+        T size = T(0);
+        const int n = std::max<int>(int(n_max), 1);
+        geev('N', 'V', n, A.data(), std::max<int>(int(A.spacing()), 1), wr.data(), wi.data(),
+             VR.data(), 1, VR.data(), std::max<int>(int(VR.spacing()), 1), &size, -1, &info);
+        work.resize(std::max<std::size_t>(std::size_t(size), 4 * std::size_t(n)), false);
+    }
+
+    DynamicMatrix<T, columnMajor> A;
+    DynamicMatrix<T, columnMajor> VR;
+    DynamicVector<T> wr;
+    DynamicVector<T> wi;
+    DynamicVector<T> work;
+    std::vector<std::size_t> order;
+};
+
+/**
+ * Real basis (columns of P) of the invariant subspace belonging to the
+ * "count" eigenvalues of smallest magnitude of a general real matrix M.
+ * Complex conjugate pairs contribute their real and imaginary parts and are
+ * never split, so P may get count+1 columns. P should have room for
+ * count+1 columns, then nothing is allocated.
+ */
+template<typename T>
+void smallest_eigenvectors(const DynamicMatrix<T> &M, std::size_t count, DynamicMatrix<T, columnMajor> &P,
+                           EigenWorkspace<T> &ws)
+{
+    const std::size_t n = M.rows();
+
+    ws.A = M;
+    ws.VR.resize(n, n, false);
+    int info = 0;
+    geev('N', 'V', int(n), ws.A.data(), std::max<int>(int(ws.A.spacing()), 1), ws.wr.data(), ws.wi.data(),
+         ws.VR.data(), 1, ws.VR.data(), std::max<int>(int(ws.VR.spacing()), 1),
+         ws.work.data(), int(ws.work.size()), &info);
+    if(info != 0) {
+        P.resize(n, 0, false);
+        return;
+    }
+
+    // LAPACK stores a complex pair as real part (column j) and imaginary part (column j+1), wi[j] > 0
+    std::vector<std::size_t> &order = ws.order;
+    order.resize(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&ws](std::size_t i, std::size_t j) {
+        return std::hypot(ws.wr[i], ws.wi[i]) < std::hypot(ws.wr[j], ws.wi[j]);
+    });
+
+    // Number of columns first: P is filled without resizing it while preserving its contents
+    const std::size_t room = std::min(count + 1, n);
+    std::size_t columns = 0;
+    for(std::size_t idx : order) {
+        if(columns >= count || columns >= n) {
+            break;
+        }
+        const T im = ws.wi[idx];
+        if(std::abs(im) <= T(1e-12) * std::hypot(ws.wr[idx], im)) {
+            ++columns;
+        } else if(im > T(0) && columns + 1 < room) {
+            columns += 2;
+        }
+    }
+
+    P.resize(n, columns, false);
+    std::size_t c = 0;
+    for(std::size_t idx : order) {
+        if(c >= columns) {
+            break;
+        }
+        const T im = ws.wi[idx];
+        if(std::abs(im) <= T(1e-12) * std::hypot(ws.wr[idx], im)) {
+            column(P, c++) = column(ws.VR, idx);
+        } else if(im > T(0) && c + 1 < room) {
+            column(P, c++) = column(ws.VR, idx);
+            column(P, c++) = column(ws.VR, idx + 1);
+        }
+    }
+}
+
+} //end namespace detail
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_DENSESUBSPACE_HPP
@@ -0,0 +1,179 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_FGMRES_HPP
+#define BLAZE_ITERATIVE_FGMRES_HPP
+
+#include <BlazeIterative/IterativeCommon.hpp>
+#include <BlazeIterative/Reduction.hpp>
+#include <BlazeIterative/Trace.hpp>
+#include <BlazeIterative/Workspace.hpp>
+#include "FGMRESTag.hpp"
+#include "GMRES.hpp"
+#include <cmath>
+#include <type_traits>
+
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+namespace detail {
+
+// Bytes of the work arrays of FGMRES with the restart length n
+template<typename T>
+std::size_t fgmres_workspace_bytes(std::size_t m, std::size_t n)
+{
+    return dense_bytes(m, 2 * n + 1, sizeof(T)) + dense_bytes(n + 1, n, sizeof(T)) + (4 * n + 1 + 4 * m) * sizeof(T);
+}
+
+// The restart length of the tag, shortened until the work arrays fit into tag.memoryBudget() (at least 1)
+template<typename T>
+std::size_t fgmres_restart(const FGMRESTag &tag, std::size_t m)
+{
+    const std::size_t restart = tag.restart();
+    const std::size_t budget = tag.memoryBudget();
+    if(budget == 0 || fgmres_workspace_bytes<T>(m, restart) <= budget) {
+        return restart;
+    }
+    return largest_fitting(restart, budget, [m](std::size_t n) { return fgmres_workspace_bytes<T>(m, n); });
+}
+
+/**
+ *  Implementation of restarted flexible GMRES with right preconditioning,
+ *  following Saad, "A flexible inner-outer preconditioned GMRES algorithm" (1993).
+ *  The preconditioned vectors z_j = M_j^-1 v_j are kept in Z, and the
+ *  update is x += Z y instead of x += M^-1 V y.
+ */
+template<typename MatrixType, typename T>
+void solve_impl(
+        DynamicVector<T> &x,
+        const MatrixType &A,
+        const DynamicVector<T> &b,
+        FGMRESTag &tag,
+        std::string Preconditioner="")
+{
+    static_assert(std::is_same<T, double>::value, "The FGMRES preconditioner callback works on double vectors");
+
+    BLAZE_INTERNAL_ASSERT(tag.restart() >= 1, "restart must be larger than or equal to 1")
+
+    TraceScope trace_solve(tag, "solve", "solve");
+
+    const std::size_t m = b.size();
+    const std::size_t restart = fgmres_restart<T>(tag, m);
+
+    DynamicMatrix<T, columnMajor> V(m, restart + 1);
+    DynamicMatrix<T, columnMajor> Z(m, restart);
+    DynamicMatrix<T> H(restart + 1, restart);
+    DynamicVector<T> g(restart + 1);
+    DynamicVector<T> cs(restart);
+    DynamicVector<T> sn(restart);
+    DynamicVector<T> y(restart);
+    DynamicVector<T> v(m);
+    DynamicVector<T> z(m);
+    DynamicVector<T> w(m);
+
+    DynamicVector<T> r(m);
+    residual(r, A, x, b);
+    const T norm_b = vector_norm(tag, b);
+    if(norm_b == T(0)) {
+        reset(x);
+        return;
+    }
+
+    std::size_t iteration{0};
+    bool terminated = false;
+    tag.reserve_log(tag.maximumIterations() + 2);
+
+    while(!terminated) {
+        const T beta = vector_norm(tag, r);
+        if(beta == T(0)) {
+            tag.terminateIteration(iteration, beta, beta);
+            break;
+        }
+
+        reset(H);
+        reset(g);
+        g[0] = beta;
+        column(V, 0) = r / beta;
+
+        std::size_t j = 0;
+        while(j < restart) {
+            TraceScope trace_iteration(tag, "iteration", "iteration", iteration);
+
+            v = column(V, j);
+            {
+                TraceScope trace(tag, "preconditioner", "preconditioner", iteration);
+                if(tag.preconditioner()) {
+                    tag.preconditioner()(z, v);
+                } else {
+                    z = v;
+                }
+            }
+            column(Z, j) = z;
+
+            {
+                TraceScope trace(tag, "spmv", "spmv", iteration);
+                multiply(w, A, z);
+            }
+            {
+                TraceScope trace(tag, "orthogonalization", "orthogonalization", iteration);
+                for(std::size_t i = 0; i <= j; ++i) {
+                    H(i, j) = dot_product(tag, column(V, i), w);
+                    w -= H(i, j) * column(V, i);
+                }
+                H(j + 1, j) = vector_norm(tag, w);
+            }
+
+            const bool breakdown = !(H(j + 1, j) > T(1e-14) * beta);
+            if(!breakdown) {
+                column(V, j + 1) = w / H(j + 1, j);
+            }
+
+            apply_givens_rotation(H, cs, sn, g, j);
+
+            ++j;
+
+            const T absolute_residual = std::abs(g[j]);
+            const T relative_residual = absolute_residual / norm_b;
+            if(tag.do_log()) {
+                tag.log_residual(relative_residual);
+            }
+
+            if(tag.terminateIteration(iteration, absolute_residual, relative_residual)) {
+                terminated = true;
+                break;
+            }
+            ++iteration;
+
+            // Lucky breakdown: finish the cycle, the restart recomputes the residual
+            if(breakdown) {
+                break;
+            }
+        }
+
+        // Back-substitution with the j x j triangular block
+        TraceScope trace_restart(tag, "update", "restart", iteration);
+        back_substitution(H, g, y, j);
+
+        x += submatrix(Z, 0, 0, m, j) * subvector(y, 0, j);
+        residual(r, A, x, b);
+    }
+
+}
+
+template<typename MatrixType>
+std::size_t workspace_impl(const MatrixType &A, const FGMRESTag &tag, const std::string &Preconditioner)
+{
+    using T = typename MatrixType::ElementType;
+    return fgmres_workspace_bytes<T>(A.rows(), fgmres_restart<T>(tag, A.rows()));
+}
+
+} //end namespace detail
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_FGMRES_HPP
@@ -0,0 +1,62 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_FGMRESTAG_HPP
+#define BLAZE_ITERATIVE_FGMRESTAG_HPP
+
+#include <BlazeIterative/IterativeCommon.hpp>
+#include <BlazeIterative/IterativeTag.hpp>
+#include <functional>
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+/**
+ * \class FGMRESTag
+ * \brief Tag type to dispatch a flexible GMRES solver
+ *
+ * FGMRES (Saad 1993) is restarted GMRES with right preconditioning where
+ * the preconditioner may change from one iteration to the next, e.g. an
+ * inner Krylov solve, a multigrid cycle or any other inexact solve.
+ * The preconditioner is a callback computing z ~ M^-1 v:
+ *
+ * \code
+ * FGMRESTag tag;
+ * tag.preconditioner() = [&](DynamicVector<double> &z, const DynamicVector<double> &v) {
+ *     reset(z);
+ *     solve_inplace(z, A, v, inner_tag);
+ * };
+ * \endcode
+ *
+ * Without a callback no preconditioning is applied. The preconditioned
+ * basis vectors are stored, so memory is twice that of GMRES.
+ */
+class FGMRESTag : public IterativeTag
+{
+public:
+    using PreconditionerType = std::function<void(DynamicVector<double> &, const DynamicVector<double> &)>;
+
+    FGMRESTag() {
+        solverName = "FGMRES";
+    }
+
+    std::size_t &restart() { return restart_length; }
+
+    std::size_t restart() const { return restart_length; }
+
+    PreconditionerType &preconditioner() { return apply_preconditioner; }
+
+    const PreconditionerType &preconditioner() const { return apply_preconditioner; }
+
+protected:
+    std::size_t restart_length{30};
+    PreconditionerType apply_preconditioner;
+};
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_FGMRESTAG_HPP
@@ -0,0 +1,337 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_GCRODR_HPP
+#define BLAZE_ITERATIVE_GCRODR_HPP
+
+#include <BlazeIterative/IterativeCommon.hpp>
+#include <BlazeIterative/LinearOperator.hpp>
+#include <BlazeIterative/Reduction.hpp>
+#include <BlazeIterative/Workspace.hpp>
+#include "GCRODRTag.hpp"
+#include "DenseSubspace.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+
+BLAZE_NAMESPACE_OPEN
+    ITERATIVE_NAMESPACE_OPEN
+
+        namespace detail {
+
+            /**
+             * Work arrays of GCRO-DR, allocated once per solve for the largest
+             * cycle (restart total dimensions, at most recycle+1 recycled
+             * vectors) and resized within their capacity by every cycle.
+             */
+            template<typename T>
+            struct GCRODRWorkspace
+            {
+                GCRODRWorkspace(std::size_t m, std::size_t restart, std::size_t recycle)
+                        : U(m, recycle + 1), C(m, recycle + 1), V(m, restart + 1), H(restart + 1, restart), w(m), r(m),
+                          d(restart), G(restart + 1, restart), R(restart + 1, restart), g(restart + 1),
+                          cs(restart), sn(restart), y(restart),
+                          Vhat(m, restart), What(m, restart + 1), WtV(restart + 1, restart),
+                          GtG(restart, restart), GtWV(restart, restart), pivots(restart),
+                          P(restart, recycle + 1), GP(restart + 1, recycle + 1), Q(restart + 1, recycle + 1),
+                          RP(recycle + 1, recycle + 1), eigen(restart)
+                {
+                    U.resize(m, 0, false);
+                    C.resize(m, 0, false);
+                }
+
+                DynamicMatrix<T, columnMajor> U;       // recycled space
+                DynamicMatrix<T, columnMajor> C;       // A U, orthonormal
+                DynamicMatrix<T, columnMajor> V;       // Arnoldi basis
+                DynamicMatrix<T> H;                    // Arnoldi Hessenberg matrix
+                DynamicVector<T> w;
+                DynamicVector<T> r;
+                DynamicVector<T> d;                    // column scaling of U
+                DynamicMatrix<T> G;                    // as built, kept for the eigenproblem
+                DynamicMatrix<T> R;                    // Givens-rotated copy of G
+                DynamicVector<T> g;
+                DynamicVector<T> cs;
+                DynamicVector<T> sn;
+                DynamicVector<T> y;
+
+                // Harmonic Ritz problem and the new recycled space
+                DynamicMatrix<T, columnMajor> Vhat;
+                DynamicMatrix<T, columnMajor> What;
+                DynamicMatrix<T> WtV;
+                DynamicMatrix<T> GtG;                  // becomes (G^T What^T Vhat)^-1 G^T G
+                DynamicMatrix<T> GtWV;
+                std::vector<std::size_t> pivots;
+                DynamicMatrix<T, columnMajor> P;
+                DynamicMatrix<T, columnMajor> GP;
+                DynamicMatrix<T, columnMajor> Q;
+                DynamicMatrix<T> RP;
+                EigenWorkspace<T> eigen;
+            };
+
+            /**
+             *  GCRO-DR following Parks, de Sturler, Mackey, Johnson and Maiti,
+             *  "Recycling Krylov subspaces for sequences of linear systems" (2006).
+             *
+             *  With a recycled space U and C = A U orthonormal, every cycle runs
+             *  Arnoldi on (I - C C^T) A, which gives A [U D, V] = [C, V+] G with
+             *     G = | D  B |
+             *         | 0  H |
+             *  (D scales U to unit columns, H is the Arnoldi Hessenberg matrix).
+             *  The residual is minimized over span{U, V}, and the harmonic Ritz
+             *  vectors of the smallest harmonic Ritz values become the next U.
+             *  Without a recycled space the first cycle is plain GMRES.
+             */
+            template<typename MatrixType, typename T>
+            void  solve_impl(
+                    DynamicVector<T> &x,
+                    const MatrixType &A,
+                    const DynamicVector<T> &b,
+                    GCRODRTag &tag,
+                    std::string Preconditioner="")
+            {
+
+                BLAZE_INTERNAL_ASSERT(tag.restart() > tag.recycleSize() + 1, "restart must exceed recycleSize by at least 2")
+
+                const std::size_t m = b.size();
+                const std::size_t restart = tag.restart();
+                const std::size_t recycle = tag.recycleSize();
+
+                GCRODRWorkspace<T> ws(m, restart, recycle);
+                DynamicMatrix<T, columnMajor> &U = ws.U;
+                DynamicMatrix<T, columnMajor> &C = ws.C;
+                DynamicMatrix<T, columnMajor> &V = ws.V;
+                DynamicVector<T> &r = ws.r;
+                if(tag.recycledSpace().rows() == m && tag.recycledSpace().columns() + 1 < restart) {
+                    U = tag.recycledSpace();
+                }
+
+                residual(r, A, x, b);
+                const T norm_b = vector_norm(tag, b);
+                if(norm_b == T(0)) {
+                    reset(x);
+                    return;
+                }
+
+                // The operator may have changed since U was computed: C = A U, orthonormalized
+                if(U.columns() > 0) {
+                    DynamicMatrix<T, columnMajor> AU;
+                    multiply_columns(AU, A, U);
+                    DynamicMatrix<T> R;
+                    if(thin_qr(AU, C, R)) {
+                        U = U * inv(R);
+                        DynamicVector<T> Ctr = trans(C) * r;
+                        x += U * Ctr;
+                        r -= C * Ctr;
+                    } else {
+                        U.resize(m, 0, false);
+                        C.resize(m, 0, false);
+                    }
+                }
+
+                DynamicMatrix<T> &H = ws.H;
+                DynamicVector<T> &w = ws.w;
+                DynamicMatrix<T> &G = ws.G;
+                DynamicMatrix<T> &R = ws.R;
+                DynamicVector<T> &g = ws.g;
+                DynamicVector<T> &cs = ws.cs;
+                DynamicVector<T> &sn = ws.sn;
+                DynamicVector<T> &d = ws.d;
+                DynamicVector<T> &y = ws.y;
+
+                std::size_t iteration{0};
+                bool terminated = false;
+                tag.reserve_log(tag.maximumIterations() + 2);
+
+                while(!terminated) {
+                    const std::size_t k = U.columns();
+                    const std::size_t jmax = restart - k;
+
+                    d.resize(k, false);
+                    for(std::size_t i = 0; i < k; ++i) {
+                        d[i] = T(1) / vector_norm(tag, column(U, i));
+                    }
+
+                    reset(G);
+                    reset(R);
+                    reset(g);
+                    reset(cs);
+                    reset(sn);
+
+                    for(std::size_t i = 0; i < k; ++i) {
+                        G(i, i) = d[i];
+                        R(i, i) = d[i];
+                    }
+
+                    const T beta = vector_norm(tag, r);
+                    if(beta == T(0)) {
+                        tag.terminateIteration(iteration, beta, beta);
+                        break;
+                    }
+                    if(k > 0) {
+                        subvector(g, 0, k) = trans(C) * r;
+                    }
+                    g[k] = beta;
+                    reset(H);
+                    reset(V);
+                    column(V, 0) = r / beta;
+
+                    std::size_t j = 0;
+                    bool breakdown = false;
+                    while(j < jmax) {
+                        multiply(w, A, column(V, j));
+
+                        if(k > 0) {
+                            auto B_j = subvector(column(G, k + j), 0, k);
+                            B_j = trans(C) * w;
+                            w -= C * B_j;
+                        }
+
+                        for(std::size_t i = 0; i <= j; ++i) {
+                            H(i, j) = dot_product(tag, column(V, i), w);
+                            w -= H(i, j) * column(V, i);
+                        }
+                        H(j + 1, j) = vector_norm(tag, w);
+
+                        breakdown = !(H(j + 1, j) > T(1e-14) * beta);
+                        if(!breakdown) {
+                            column(V, j + 1) = w / H(j + 1, j);
+                        }
+
+                        const std::size_t col = k + j;
+                        for(std::size_t i = 0; i <= j + 1; ++i) {
+                            G(k + i, col) = H(i, j);
+                        }
+                        column(R, col) = column(G, col);
+
+                        // Only the Hessenberg rows need rotations, the D block is already triangular
+                        for(std::size_t i = 0; i < j; ++i) {
+                            const std::size_t p = k + i;
+                            const T temp = cs[i] * R(p, col) + sn[i] * R(p + 1, col);
+                            R(p + 1, col) = -sn[i] * R(p, col) + cs[i] * R(p + 1, col);
+                            R(p, col) = temp;
+                        }
+
+                        const std::size_t p = k + j;
+                        const T denom = std::sqrt(R(p, col) * R(p, col) + R(p + 1, col) * R(p + 1, col));
+                        cs[j] = denom == T(0) ? T(1) : R(p, col) / denom;
+                        sn[j] = denom == T(0) ? T(0) : R(p + 1, col) / denom;
+                        R(p, col) = denom;
+                        R(p + 1, col) = 0;
+                        g[p + 1] = -sn[j] * g[p];
+                        g[p] = cs[j] * g[p];
+
+                        ++j;
+
+                        const T absolute_residual = std::abs(g[p + 1]);
+                        const T relative_residual = absolute_residual / norm_b;
+                        if(tag.do_log()) {
+                            tag.log_residual(relative_residual);
+                        }
+
+                        if(tag.terminateIteration(iteration, absolute_residual, relative_residual)) {
+                            terminated = true;
+                            break;
+                        }
+                        ++iteration;
+
+                        if(breakdown) {
+                            break;
+                        }
+                    }
+
+                    // Minimizer of the cycle: R y = g by back-substitution
+                    const std::size_t n = k + j;
+                    y.resize(n, false);
+                    for(std::size_t i = n; i-- > 0; ) {
+                        T sum = g[i];
+                        for(std::size_t l = i + 1; l < n; ++l) {
+                            sum -= R(i, l) * y[l];
+                        }
+                        y[i] = sum / R(i, i);
+                    }
+
+                    // x += [U D, V] y
+                    if(k > 0) {
+                        subvector(y, 0, k) *= d;
+                        x += U * subvector(y, 0, k);
+                    }
+                    x += submatrix(V, 0, 0, m, j) * subvector(y, k, j);
+                    residual(r, A, x, b);
+
+                    // Harmonic Ritz vectors of this cycle: G^T G z = theta G^T What^T Vhat z,
+                    // with Vhat = [U D, V_j] and What = [C, V_{j+1}]
+                    ws.Vhat.resize(m, n, false);
+                    ws.What.resize(m, n + 1, false);
+                    if(k > 0) {
+                        for(std::size_t i = 0; i < k; ++i) {
+                            column(ws.Vhat, i) = d[i] * column(U, i);
+                        }
+                        submatrix(ws.What, 0, 0, m, k) = C;
+                    }
+                    submatrix(ws.Vhat, 0, k, m, j) = submatrix(V, 0, 0, m, j);
+                    submatrix(ws.What, 0, k, m, j + 1) = submatrix(V, 0, 0, m, j + 1);
+
+                    auto Gsub = submatrix(G, 0, 0, n + 1, n);
+                    ws.GtG = trans(Gsub) * Gsub;
+                    ws.WtV = trans(ws.What) * ws.Vhat;
+                    ws.GtWV = trans(Gsub) * ws.WtV;
+
+                    ws.P.resize(n, 0, false);
+                    if(solve_dense_inplace(ws.GtWV, ws.GtG, ws.pivots)) {
+                        smallest_eigenvectors(ws.GtG, std::min(recycle, n - 1), ws.P, ws.eigen);
+                    }
+
+                    ws.GP = Gsub * ws.P;
+                    if(ws.P.columns() > 0 && thin_qr(ws.GP, ws.Q, ws.RP)) {
+                        C = ws.What * ws.Q;
+
+                        // U = Vhat P RP^-1, by back-substitution on the columns
+                        U = ws.Vhat * ws.P;
+                        for(std::size_t c = 0; c < U.columns(); ++c) {
+                            for(std::size_t i = 0; i < c; ++i) {
+                                column(U, c) -= ws.RP(i, c) * column(U, i);
+                            }
+                            column(U, c) /= ws.RP(c, c);
+                        }
+                    } else {
+                        U.resize(m, 0, false);
+                        C.resize(m, 0, false);
+                    }
+
+                    if(breakdown) {
+                        break;
+                    }
+                }
+
+                tag.recycledSpace() = U;
+
+            }; // end solve_imple function
+
+            // GCRODRWorkspace plus the temporaries of adapting U to the current operator;
+            // the LAPACK work array is counted at its minimal size
+            template<typename MatrixType>
+            std::size_t workspace_impl(const MatrixType &A, const GCRODRTag &tag, const std::string &Preconditioner)
+            {
+                using T = typename MatrixType::ElementType;
+
+                const std::size_t m = A.rows();
+                const std::size_t n = tag.restart();
+                const std::size_t k = tag.recycledSpace().rows() == m && tag.recycledSpace().columns() + 1 < n
+                                      ? tag.recycledSpace().columns() : 0;
+                const std::size_t p = std::max(k, tag.recycleSize() + 1);
+                const std::size_t small = 8 * n * n + 15 * n + 1 + (3 * n + 2) * (tag.recycleSize() + 1)
+                                          + (tag.recycleSize() + 1) * (tag.recycleSize() + 1);
+                return dense_bytes(m, 2 * n + 4 + 2 * p + k, sizeof(T)) + small * sizeof(T)
+                       + 2 * n * sizeof(std::size_t);
+            }
+
+        } //end namespace detail
+
+    ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_GCRODR_HPP
@@ -0,0 +1,57 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_GCRODRTAG_HPP
+#define BLAZE_ITERATIVE_GCRODRTAG_HPP
+
+#include <BlazeIterative/IterativeCommon.hpp>
+#include <BlazeIterative/IterativeTag.hpp>
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+/**
+ * \class GCRODRTag
+ * \brief Tag type to dispatch a GCRO-DR (recycling GMRES) solver
+ *
+ * GCRO-DR is restarted GMRES that carries a space U of harmonic Ritz
+ * vectors from one restart cycle to the next and from one linear system to
+ * the next. U is stored on the tag, so solving a sequence of related
+ * non-symmetric systems with the same tag reuses the information of the
+ * previous solves. restart() is the total subspace dimension per cycle
+ * (recycled plus new Krylov vectors) and must exceed recycleSize() + 1.
+ */
+class GCRODRTag : public IterativeTag
+{
+public:
+    GCRODRTag() {
+        solverName = "GCRO-DR";
+    }
+
+    std::size_t &restart() { return restart_length; }
+
+    std::size_t restart() const { return restart_length; }
+
+    std::size_t &recycleSize() { return recycle_size; }
+
+    std::size_t recycleSize() const { return recycle_size; }
+
+    DynamicMatrix<double, columnMajor> &recycledSpace() { return recycled_space; }
+
+    const DynamicMatrix<double, columnMajor> &recycledSpace() const { return recycled_space; }
+
+    void clearRecycledSpace() { recycled_space.clear(); }
+
+protected:
+    std::size_t restart_length{20};
+    std::size_t recycle_size{5};
+    DynamicMatrix<double, columnMajor> recycled_space;
+};
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_GCRODRTAG_HPP
@@ -8,10 +8,15 @@
 #define BLAZE_ITERATIVE_GMRES_HPP
 
 #include <BlazeIterative/IterativeCommon.hpp>
+#include <BlazeIterative/Checkpoint.hpp>
+#include <BlazeIterative/LinearOperator.hpp>
+#include <BlazeIterative/Reduction.hpp>
+#include <BlazeIterative/Trace.hpp>
+#include <BlazeIterative/Workspace.hpp>
 #include "GMRESTag.hpp"
-#include <utility>
-
-#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <string>
 
 
 BLAZE_NAMESPACE_OPEN
@@ -19,62 +24,125 @@ BLAZE_NAMESPACE_OPEN
 
         namespace detail {
 
-            template< typename MatrixType, typename T>
-            std::pair< DynamicMatrix<T>,  DynamicVector<T> > arnoldi( const MatrixType &A, DynamicMatrix<T> &Q, int &k)
+            /**
+             * Work arrays of restarted GMRES, allocated once per solve and
+             * reused by every restart cycle so that the iteration itself does
+             * not allocate.
+             * Q: m * (n+1) Krylov basis
+             * R: (n+1) * n Hessenberg matrix, reduced in place to upper
+             *    triangular form by the Givens rotations (cs, sn)
+             * g: rotated right-hand side of the least-squares problem
+             */
+            template<typename T, typename BasisType>
+            struct GMRESWorkspace
+            {
+                GMRESWorkspace(std::size_t m, std::size_t n)
+                        : Q(m, n + 1, 0), R(n + 1, n, 0), cs(n, 0), sn(n, 0),
+                          g(n + 1, 0), y(n, 0), w(m, 0), r(m, 0) {}
+
+                DynamicMatrix<BasisType, columnMajor> Q;
+                DynamicMatrix<T, columnMajor> R;
+                DynamicVector<T> cs;
+                DynamicVector<T> sn;
+                DynamicVector<T> g;
+                DynamicVector<T> y;
+                DynamicVector<T> w;
+                DynamicVector<T> r;
+            };
+
+            /**
+             * One Arnoldi step with modified Gram-Schmidt: column k of the
+             * Hessenberg matrix is written to column k of R and the new basis
+             * vector to column k+1 of Q. Returns false on (lucky) breakdown,
+             * i.e. if the Krylov space is invariant under A. Both phases are
+             * traced as part of the given iteration.
+             */
+            template<typename MatrixType, typename T, typename BasisType>
+            bool arnoldi(const MatrixType &A,
+                         DynamicMatrix<BasisType, columnMajor> &Q,
+                         DynamicMatrix<T, columnMajor> &R,
+                         DynamicVector<T> &w,
+                         std::size_t k,
+                         T breakdown_tolerance,
+                         const IterativeTag &tag,
+                         long iteration)
             {
-                std::size_t m = A.columns();
-                DynamicVector<T> q(m);
-                DynamicMatrix<T> h(k+2, 1);
-
-                q = A * column(Q,k);
-                for(int i = 0; i <= k; ++i){
-                    h(i,0) = ctrans(q) * column(Q,i);
-                    q -= h(i,0) * column(Q,i);
+                {
+                    TraceScope trace(tag, "spmv", "spmv", iteration);
+                    multiply(w, A, column(Q, k));
                 }
-                h(k+1, 0) = norm(q);
-                q = q / h(k+1, 0);
-                return std::make_pair(h,q);
+                TraceScope trace(tag, "orthogonalization", "orthogonalization", iteration);
+                for(std::size_t i = 0; i <= k; ++i){
+                    R(i, k) = dot_product(tag, column(Q, i), w);
+                    w -= R(i, k) * column(Q, i);
+                }
+                R(k + 1, k) = vector_norm(tag, w);
+
+                if(!(R(k + 1, k) > breakdown_tolerance)) {
+                    return false;
+                }
+                column(Q, k + 1) = w / R(k + 1, k);
+                return true;
             }
 
             template<typename T>
-            std::pair< T, T> givens_rotation( T &v1, T &v2)
+            void givens_rotation(T v1, T v2, T &cs, T &sn)
             {
-                T cs_k, sn_k;
-                if (v1 == 0){
-                    cs_k = 0;
-                    sn_k = 0;
-
+                if (v1 == T(0) && v2 == T(0)){
+                    cs = 1;
+                    sn = 0;
                 } else {
-                    auto t = sqrt(v1 * v1 + v2 * v2);
-                    cs_k = abs(v1) / t;
-                    sn_k = cs_k * v2 / v1;
+                    const T t = std::sqrt(v1 * v1 + v2 * v2);
+                    cs = v1 / t;
+                    sn = v2 / t;
                 }
-
-                return std::make_pair(cs_k,sn_k);
             }
 
-            template<typename T>
-            std::tuple<DynamicMatrix<T>,  T, T> apply_givens_rotation( DynamicMatrix<T> &h, DynamicVector<T> &cs, DynamicVector<T> &sn, int &k)
+            /**
+             * Applies the previous rotations to column k of R, then computes the
+             * rotation annihilating R(k+1,k) and applies it to R and to the
+             * rotated right-hand side g. Afterwards |g[k+1]| is the residual norm.
+             */
+            template<typename MT, typename T>
+            void apply_givens_rotation(MT &R, DynamicVector<T> &cs, DynamicVector<T> &sn, DynamicVector<T> &g, std::size_t k)
             {
-                for(int i = 0; i < k; ++i){
-                    auto temp = cs[i] * h(i,0) + sn[i] * h(i+1,0);
-                    h(i+1,0) = -sn[i] * h(i,0) + cs[i] * h(i+1,0);
-                    h(i,0) = temp;
+                for(std::size_t i = 0; i < k; ++i){
+                    const T temp = cs[i] * R(i, k) + sn[i] * R(i + 1, k);
+                    R(i + 1, k) = -sn[i] * R(i, k) + cs[i] * R(i + 1, k);
+                    R(i, k) = temp;
                 }
 
-                T cs_k, sn_k;
-                auto res = givens_rotation(h(k,0), h(k+1,0));
-                cs_k = res.first;
-                sn_k = res.second;
+                givens_rotation<T>(R(k, k), R(k + 1, k), cs[k], sn[k]);
 
-                h(k,0) = cs_k * h(k,0) + sn_k * h(k+1,0);
-                h(k+1,0) = 0.0;
+                R(k, k) = cs[k] * R(k, k) + sn[k] * R(k + 1, k);
+                R(k + 1, k) = 0;
 
-                return std::make_tuple(h, cs_k, sn_k);
+                g[k + 1] = -sn[k] * g[k];
+                g[k] = cs[k] * g[k];
             }
 
-            template<typename MatrixType, typename T>
-            void  solve_impl(
+            // Solves the leading k x k upper triangular system R y = g
+            template<typename MT, typename T>
+            void back_substitution(const MT &R, const DynamicVector<T> &g, DynamicVector<T> &y, std::size_t k)
+            {
+                for(std::size_t i = k; i-- > 0; ){
+                    T sum = g[i];
+                    for(std::size_t l = i + 1; l < k; ++l){
+                        sum -= R(i, l) * y[l];
+                    }
+                    y[i] = sum / R(i, i);
+                }
+            }
+
+            /**
+             * Restarted GMRES(n). Every cycle builds at most n Arnoldi vectors;
+             * the total number of Arnoldi steps, the tolerances and the logging
+             * of the relative residual ||r|| / ||b|| are controlled by the tag.
+             * The Krylov basis is stored with element type BasisType, all other
+             * quantities use the element type T of the system.
+             */
+            template<typename BasisType, typename MatrixType, typename T>
+            void  gmres_impl(
                     DynamicVector<T> &x,
                     const MatrixType &A,
                     const DynamicVector<T> &b,
@@ -85,63 +153,205 @@ BLAZE_NAMESPACE_OPEN
 
                 BLAZE_INTERNAL_ASSERT(n >= 1, "n must larger than or equal to 1")
 
-                // A: m * m matrix; n is max_iteration;
+                // A: m * m matrix; n is the restart length
 
 
-                std::size_t m = A.columns();
-                DynamicVector<T> r(m,0);
-                DynamicMatrix<T> H(n+1,n,0);
-                DynamicMatrix<T> Q(m,n+1,0);
-                DynamicVector<T> sn(n,0);
-                DynamicVector<T> cs(n,0);
-                DynamicVector<T> e1(m,0);
-                DynamicVector<T> beta(m,0);
-                DynamicVector<T> err_set(n+1,0);
+                TraceScope trace_solve(tag, "solve", "solve");
 
-                DynamicMatrix<T> H_sub(n,n,0);
-                DynamicMatrix<T> Q_sub(n,n,0);
-                DynamicVector<T> beta_sub (n,0);
-                DynamicVector<T> y(n,0);
+                const std::size_t m = A.columns();
+                GMRESWorkspace<T, BasisType> ws(m, n);
 
+                const T norm_b = vector_norm(tag, b);
+                if (norm_b == T(0)){
+                    reset(x);
+                    tag.terminateIteration(0, T(0), T(0));
+                    return;
+                }
 
-                r = b - A * x;
-                auto err = norm(r) / norm(b);
-                err_set[0] = err;
+                std::size_t iteration{0};
+                bool terminated = false;
+                tag.reserve_log(tag.maximumIterations() + 2);
+
+                // Checkpoint slot: iteration, cycle position, beta, x, the Givens
+                // state, R, Q and the history of this solve. Basis vectors never
+                // change within a cycle, so only the ones that are new since the
+                // last write to the same slot are copied.
+                const std::size_t history_capacity = tag.maximumIterations() + 2;
+                const std::size_t history_offset = tag.convergence_history().size();
+                const auto layout = checkpoint_layout(tag.name(), m, n, sizeof(T), sizeof(BasisType),
+                                                      2 * sizeof(std::uint64_t) + sizeof(T)
+                                                      + (m + 3 * n + 1 + (n + 1) * n) * sizeof(T)
+                                                      + (n + 1) * m * sizeof(BasisType)
+                                                      + checkpoint_history_size(history_capacity));
+                CheckpointFile checkpoint;
+                std::size_t flushed[2] = {0, 0};
+
+                bool resume = false;
+                std::size_t k = 0;
+                T beta(0);
+
+                if(tag.resumeFromCheckpoint() && checkpoint.open(tag.checkpointFile(), layout)) {
+                    const std::size_t slot = checkpoint.activeSlot();
+                    std::uint64_t stored_iteration, stored_k;
+                    CheckpointReader in(checkpoint.slot(slot));
+                    in.scalar(stored_iteration).scalar(stored_k).scalar(beta);
+                    k = stored_k;
+                    in.vector(x).vector(ws.cs).vector(ws.sn).vector(ws.g)
+                      .columns(ws.R, 0, n).columns(ws.Q, 0, k + 1)
+                      .history(tag.convergence_history(), history_capacity);
+                    iteration = stored_iteration;
+                    flushed[slot] = k + 1;
+                    resume = true;
+                } else {
+                    if(tag.checkpointInterval() > 0) {
+                        checkpoint.create(tag.checkpointFile(), layout);
+                    }
+                    residual(ws.r, A, x, b);
+                }
 
-                e1[0] = 1;
-                column(Q,0) = r / norm(r);
-                beta = norm(r) * e1;
+                while(!terminated){
+                    if(resume) {
+                        resume = false;
+                    } else {
+                        beta = vector_norm(tag, ws.r);
+                        if (beta == T(0)){
+                            tag.terminateIteration(iteration, beta, beta / norm_b);
+                            break;
+                        }
+
+                        reset(ws.g);
+                        ws.g[0] = beta;
+                        column(ws.Q, 0) = ws.r / beta;
+                        k = 0;
+                        flushed[0] = flushed[1] = 0;
+                    }
 
-                for(int k = 0; k < n; ++k){
-                    auto res_1 = arnoldi(A, Q, k);
-                    column(Q,k+1) = res_1.second;
+                    while(k < n){
+                        TraceScope trace_iteration(tag, "iteration", "iteration", iteration);
+
+                        const bool regular = arnoldi(A, ws.Q, ws.R, ws.w, k, T(1e-14) * beta, tag, iteration);
+                        apply_givens_rotation(ws.R, ws.cs, ws.sn, ws.g, k);
+                        ++k;
+
+                        const T absolute_residual = std::abs(ws.g[k]);
+                        const T relative_residual = absolute_residual / norm_b;
+                        if(tag.do_log()) {
+                            tag.log_residual(relative_residual);
+                        }
+
+                        if(tag.terminateIteration(iteration, absolute_residual, relative_residual)) {
+                            terminated = true;
+                            break;
+                        }
+                        ++iteration;
+
+                        // Lucky breakdown: the cycle already contains the solution
+                        if(!regular) {
+                            break;
+                        }
+
+                        if(checkpoint.isOpen() && tag.checkpointInterval() > 0 && iteration % tag.checkpointInterval() == 0) {
+                            const std::size_t slot = checkpoint.nextSlot();
+                            CheckpointWriter(checkpoint.slot(slot))
+                                    .scalar(static_cast<std::uint64_t>(iteration)).scalar(static_cast<std::uint64_t>(k))
+                                    .scalar(beta)
+                                    .vector(x).vector(ws.cs).vector(ws.sn).vector(ws.g)
+                                    .columns(ws.R, 0, n).columns(ws.Q, flushed[slot], k + 1)
+                                    .history(tag.convergence_history(), history_offset, history_capacity);
+                            flushed[slot] = k + 1;
+                            checkpoint.commit(slot);
+                        }
+                    }
 
-                    auto res_2 = apply_givens_rotation(res_1.first, cs, sn, k);
-                    submatrix(H, 0, k, k+2, 1) = std::get<0>(res_2);
-                    cs[k] = std::get<1>(res_2);
-                    sn[k] = std::get<2>(res_2);
+                    // Only the k x k system built in this cycle is solved
+                    TraceScope trace_restart(tag, "update", "restart", iteration);
+                    back_substitution(ws.R, ws.g, ws.y, k);
+                    x += submatrix(ws.Q, 0, 0, m, k) * subvector(ws.y, 0, k);
+                    residual(ws.r, A, x, b);
+                }
 
-                    beta[k+1] = -sn[k] * beta[k];
-                    beta[k] = cs[k] * beta[k];
+            }; // end gmres_impl function
 
-                    err = abs(beta[k+1]) / norm(b);
-                    err_set[k+1] = err;
+            // Bytes of GMRESWorkspace for the restart length n
+            template<typename T>
+            std::size_t gmres_workspace_bytes(std::size_t m, std::size_t n, BasisPrecision precision)
+            {
+                const std::size_t basis_size = precision == BasisPrecision::SINGLE ? sizeof(float) : sizeof(T);
+                return dense_bytes(m, n + 1, basis_size) + dense_bytes(n + 1, n, sizeof(T))
+                       + (4 * n + 1 + 2 * m) * sizeof(T);
+            }
 
-                    double eps = 1e-8;
-                    if (err <= eps){
-                        break;
-                    }
+            /**
+             * Restart length and basis precision of a solve with the
+             * restart length n. If their workspace exceeds tag.memoryBudget(),
+             * the basis is stored in single precision first, which costs
+             * little convergence, and only then the restart length shortened.
+             * If even the restart length 1 does not fit, n becomes 1 and the
+             * workspace stays over the budget.
+             */
+            template<typename T>
+            void fit_memory_budget(const GMRESTag &tag, std::size_t m, std::size_t &n, BasisPrecision &precision)
+            {
+                precision = tag.basisPrecision();
+                const std::size_t budget = tag.memoryBudget();
+                if(budget == 0 || gmres_workspace_bytes<T>(m, n, precision) <= budget) {
+                    return;
+                }
+
+                precision = BasisPrecision::SINGLE;
+                n = largest_fitting(n, budget, [m](std::size_t k) {
+                    return gmres_workspace_bytes<T>(m, k, BasisPrecision::SINGLE);
+                });
+            }
+
+            template<typename MatrixType, typename T>
+            void  solve_impl(
+                    DynamicVector<T> &x,
+                    const MatrixType &A,
+                    const DynamicVector<T> &b,
+                    GMRESTag &tag,
+                    const std::size_t &n)
+            {
+                std::size_t restart = n;
+                BasisPrecision precision;
+                fit_memory_budget<T>(tag, b.size(), restart, precision);
 
+                if (precision == BasisPrecision::SINGLE) {
+                    gmres_impl<float>(x, A, b, tag, restart);
+                } else {
+                    gmres_impl<T>(x, A, b, tag, restart);
                 }
-                H_sub = submatrix(H, 0, 0, n, n);
-                beta_sub = subvector(beta, 0, n);
-                y = inv(H_sub) *  beta_sub;
-                Q_sub = submatrix(Q, 0, 0, n, n);
-                x += Q_sub * y;
+            }
 
+            // Without an explicit restart length the tag's restart() is used
+            template<typename MatrixType, typename T>
+            void  solve_impl(
+                    DynamicVector<T> &x,
+                    const MatrixType &A,
+                    const DynamicVector<T> &b,
+                    GMRESTag &tag,
+                    std::string Preconditioner="")
+            {
+                const std::size_t n = std::min(tag.restart(), b.size());
+                solve_impl(x, A, b, tag, n);
+            }
+
+            template<typename MatrixType>
+            std::size_t workspace_impl(const MatrixType &A, const GMRESTag &tag, const std::size_t &n)
+            {
+                using T = typename MatrixType::ElementType;
 
+                std::size_t restart = n;
+                BasisPrecision precision;
+                fit_memory_budget<T>(tag, A.rows(), restart, precision);
+                return gmres_workspace_bytes<T>(A.rows(), restart, precision);
+            }
 
-            }; // end solve_imple function
+            template<typename MatrixType>
+            std::size_t workspace_impl(const MatrixType &A, const GMRESTag &tag, const std::string &Preconditioner)
+            {
+                return workspace_impl(A, tag, std::min(tag.restart(), A.rows()));
+            }
 
         } //end namespace detail
 
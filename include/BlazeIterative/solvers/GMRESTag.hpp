@@ -9,6 +9,7 @@
 
 #include <BlazeIterative/IterativeCommon.hpp>
 #include <BlazeIterative/IterativeTag.hpp>
+#include <BlazeIterative/BasisPrecision.hpp>
 
 BLAZE_NAMESPACE_OPEN
     ITERATIVE_NAMESPACE_OPEN
@@ -19,6 +20,20 @@ BLAZE_NAMESPACE_OPEN
             GMRESTag() {
                 solverName = "GMRES";
             }
+
+            // Restart length used when solve() is called without one
+            std::size_t &restart() { return restart_length; }
+
+            std::size_t restart() const { return restart_length; }
+
+            // Storage precision of the Krylov basis, see BasisPrecision
+            BasisPrecision &basisPrecision() { return basis_precision; }
+
+            BasisPrecision basisPrecision() const { return basis_precision; }
+
+        protected:
+            std::size_t restart_length{30};
+            BasisPrecision basis_precision{BasisPrecision::FULL};
         };
 
     ITERATIVE_NAMESPACE_CLOSE
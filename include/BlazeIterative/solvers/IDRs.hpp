@@ -0,0 +1,242 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_IDRS_HPP
+#define BLAZE_ITERATIVE_IDRS_HPP
+
+#include "BlazeIterative/IterativeCommon.hpp"
+#include "BlazeIterative/LinearOperator.hpp"
+#include "BlazeIterative/Reduction.hpp"
+#include "BlazeIterative/Trace.hpp"
+#include "BlazeIterative/Workspace.hpp"
+#include "DenseSubspace.hpp"
+#include "IDRsTag.hpp"
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+namespace detail {
+
+/**
+ *  Implementation of IDR(s) with bi-orthogonalization, following
+ *  van Gijzen and Sonneveld, "Algorithm 913: An elegant IDR(s) variant
+ *  that efficiently exploits bi-orthogonality properties" (2011).
+ *  The columns of G = A U are made bi-orthogonal to the shadow vectors P,
+ *  so that M = P^T G is lower triangular. The residual is updated after
+ *  every product, and omega is chosen with the "maintaining the
+ *  convergence" strategy (kappa = 0.7) to avoid small steps.
+ */
+template<typename MatrixType, typename T>
+void solve_impl(
+        DynamicVector<T> &x,
+        const MatrixType &A,
+        const DynamicVector<T> &b,
+        IDRsTag &tag,
+        std::string Preconditioner="")
+{
+    static_assert(std::is_same<T, double>::value, "The IDR(s) preconditioner callback works on double vectors");
+
+    BLAZE_INTERNAL_ASSERT(tag.shadowSpaceDimension() >= 1, "s must be larger than or equal to 1")
+
+    TraceScope trace_solve(tag, "solve", "solve");
+
+    const std::size_t m = b.size();
+    const std::size_t s = std::min(tag.shadowSpaceDimension(), m);
+    const T kappa = T(0.7);
+
+    DynamicVector<T> r(m);
+    residual(r, A, x, b);
+    const T norm_b = vector_norm(tag, b);
+    if(norm_b == T(0)) {
+        reset(x);
+        return;
+    }
+
+    // Shadow vectors: deterministic pseudo-random, orthonormalized
+    DynamicMatrix<T, columnMajor> P;
+    {
+        DynamicMatrix<T, columnMajor> random(m, s);
+        for(std::size_t j = 0; j < s; ++j) {
+            for(std::size_t i = 0; i < m; ++i) {
+                random(i, j) = std::sin(T(1) + T(0.7548776662) * T(i + 1) * T(2 * j + 1));
+            }
+        }
+        DynamicMatrix<T> R;
+        thin_qr(random, P, R);
+    }
+
+    DynamicMatrix<T, columnMajor> G(m, s, T(0));
+    DynamicMatrix<T, columnMajor> U(m, s, T(0));
+    DynamicMatrix<T> M(s, s, T(0));
+    for(std::size_t i = 0; i < s; ++i) {
+        M(i, i) = T(1);
+    }
+    DynamicVector<T> f(s);
+    DynamicVector<T> c(s);
+    DynamicVector<T> v(m);
+    DynamicVector<T> u(m);
+    DynamicVector<T> t(m);
+    T omega = T(1);
+
+    std::size_t iteration{0};
+    tag.reserve_log(tag.maximumIterations() + 2);
+
+    // Logs the residual and asks the tag whether to stop
+    auto check_termination = [&]() {
+        T absolute_residual;
+        {
+            TraceScope trace(tag, "r.r", "reduction", iteration);
+            absolute_residual = vector_norm(tag, r);
+        }
+        const T relative_residual = absolute_residual / norm_b;
+        if(tag.do_log()) {
+            tag.log_residual(relative_residual);
+        }
+        return tag.terminateIteration(iteration, absolute_residual, relative_residual);
+    };
+
+    if(vector_norm(tag, r) == T(0)) {
+        tag.terminateIteration(iteration, T(0), T(0));
+        return;
+    }
+
+    bool terminated = false;
+    while(!terminated) {
+        {
+            TraceScope trace(tag, "P^T r", "reduction", iteration);
+            for(std::size_t i = 0; i < s; ++i) {
+                f[i] = dot_product(tag, column(P, i), r);
+            }
+        }
+
+        // s products, each generating a vector in the current Sonneveld space
+        for(std::size_t k = 0; k < s && !terminated; ++k) {
+            TraceScope trace_iteration(tag, "iteration", "iteration", iteration);
+
+            // Solve the lower triangular system M(k:s, k:s) c = f(k:s)
+            for(std::size_t i = k; i < s; ++i) {
+                T sum = f[i];
+                for(std::size_t j = k; j < i; ++j) {
+                    sum -= M(i, j) * c[j];
+                }
+                c[i] = sum / M(i, i);
+            }
+            v = r - submatrix(G, 0, k, m, s - k) * subvector(c, k, s - k);
+
+            {
+                TraceScope trace(tag, "preconditioner", "preconditioner", iteration);
+                if(tag.preconditioner()) {
+                    tag.preconditioner()(u, v);
+                } else {
+                    u = v;
+                }
+            }
+            u *= omega;
+            u += submatrix(U, 0, k, m, s - k) * subvector(c, k, s - k);
+
+            {
+                TraceScope trace(tag, "spmv", "spmv", iteration);
+                multiply(t, A, u);
+            }
+
+            {
+                TraceScope trace(tag, "bi-orthogonalization", "orthogonalization", iteration);
+                for(std::size_t i = 0; i < k; ++i) {
+                    const T alpha = dot_product(tag, column(P, i), t) / M(i, i);
+                    t -= alpha * column(G, i);
+                    u -= alpha * column(U, i);
+                }
+                column(G, k) = t;
+                column(U, k) = u;
+                for(std::size_t i = k; i < s; ++i) {
+                    M(i, k) = dot_product(tag, column(P, i), t);
+                }
+            }
+
+            // Breakdown: G(:,k) is orthogonal to P(:,k)
+            if(M(k, k) == T(0)) {
+                terminated = true;
+                break;
+            }
+
+            // Make r orthogonal to P(:,0:k+1)
+            const T beta = f[k] / M(k, k);
+            r -= beta * t;
+            x += beta * u;
+            for(std::size_t i = k + 1; i < s; ++i) {
+                f[i] -= beta * M(i, k);
+            }
+
+            terminated = check_termination();
+            ++iteration;
+        }
+
+        if(terminated) {
+            break;
+        }
+
+        // Dimension reduction: r enters the next Sonneveld space
+        TraceScope trace_iteration(tag, "iteration", "iteration", iteration);
+        {
+            TraceScope trace(tag, "preconditioner", "preconditioner", iteration);
+            if(tag.preconditioner()) {
+                tag.preconditioner()(u, r);
+            } else {
+                u = r;
+            }
+        }
+        {
+            TraceScope trace(tag, "spmv", "spmv", iteration);
+            multiply(t, A, u);
+        }
+
+        T norm_t;
+        T norm_r;
+        T t_dot_r;
+        {
+            TraceScope trace(tag, "t.t, r.r, t.r", "reduction", iteration);
+            norm_t = vector_norm(tag, t);
+            norm_r = vector_norm(tag, r);
+            t_dot_r = dot_product(tag, t, r);
+        }
+        if(norm_t == T(0)) {
+            break;
+        }
+        // Minimal residual step, enlarged if t and r are nearly orthogonal
+        omega = t_dot_r / (norm_t * norm_t);
+        if(std::abs(t_dot_r) < kappa * norm_t * norm_r) {
+            omega = (t_dot_r < T(0) ? -kappa : kappa) * norm_r / norm_t;
+        }
+
+        r -= omega * t;
+        x += omega * u;
+
+        terminated = check_termination();
+        ++iteration;
+    }
+
+}
+
+// P (and the random block it is computed from), G, U, the vectors and the s x s system
+template<typename MatrixType>
+std::size_t workspace_impl(const MatrixType &A, const IDRsTag &tag, const std::string &Preconditioner)
+{
+    using T = typename MatrixType::ElementType;
+
+    const std::size_t m = A.rows();
+    const std::size_t s = std::min(tag.shadowSpaceDimension(), m);
+    return dense_bytes(m, 4 * s + 4, sizeof(T)) + dense_bytes(s, 2 * s + 2, sizeof(T));
+}
+
+} //end namespace detail
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_IDRS_HPP
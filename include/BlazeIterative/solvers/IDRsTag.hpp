@@ -0,0 +1,65 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_IDRSTAG_HPP
+#define BLAZE_ITERATIVE_IDRSTAG_HPP
+
+#include <BlazeIterative/IterativeCommon.hpp>
+#include <BlazeIterative/IterativeTag.hpp>
+#include <functional>
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+/**
+ * \class IDRsTag
+ * \brief Tag type to dispatch an IDR(s) solver
+ *
+ * IDR(s) (Sonneveld and van Gijzen 2008) is a short-recurrence solver for
+ * non-symmetric systems. Every cycle takes s + 1 matrix-vector products,
+ * and memory is 3s + 4 vectors regardless of the iteration count. IDR(1)
+ * is mathematically equivalent to BiCGSTAB; larger s (4 or 8) typically
+ * needs far fewer products on convection-dominated problems.
+ *
+ * The preconditioner is an optional callback computing z ~ M^-1 v, used
+ * as a right preconditioner:
+ * \code
+ * IDRsTag tag;
+ * tag.shadowSpaceDimension() = 4;
+ * tag.preconditioner() = [&](DynamicVector<double> &z, const DynamicVector<double> &v) { ... };
+ * auto x = solve(A, b, tag);
+ * \endcode
+ *
+ * Every matrix-vector product counts as one iteration. The residuals
+ * checked by terminateIteration() are ||r|| and ||r|| / ||b||.
+ */
+class IDRsTag : public IterativeTag
+{
+public:
+    using PreconditionerType = std::function<void(DynamicVector<double> &, const DynamicVector<double> &)>;
+
+    IDRsTag() {
+        solverName = "IDR(s)";
+    }
+
+    // s, the number of shadow vectors
+    std::size_t &shadowSpaceDimension() { return shadow_space_dimension; }
+
+    std::size_t shadowSpaceDimension() const { return shadow_space_dimension; }
+
+    PreconditionerType &preconditioner() { return apply_preconditioner; }
+
+    const PreconditionerType &preconditioner() const { return apply_preconditioner; }
+
+protected:
+    std::size_t shadow_space_dimension{4};
+    PreconditionerType apply_preconditioner;
+};
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_IDRSTAG_HPP
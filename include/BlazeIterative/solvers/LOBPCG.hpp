@@ -0,0 +1,231 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_LOBPCG_HPP
+#define BLAZE_ITERATIVE_LOBPCG_HPP
+
+#include "BlazeIterative/IterativeCommon.hpp"
+#include "BlazeIterative/LinearOperator.hpp"
+#include "BlazeIterative/Trace.hpp"
+#include "BlazeIterative/Workspace.hpp"
+#include "DenseSubspace.hpp"
+#include "LOBPCGTag.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+namespace detail {
+
+// Y = A * X with a single matrix-matrix product for Blaze matrices...
+template<typename MatrixType, typename T>
+void block_multiply(DynamicMatrix<T, columnMajor> &Y, const MatrixType &A,
+                    const DynamicMatrix<T, columnMajor> &X, std::true_type)
+{
+    Y = declsym(A) * X;
+}
+
+// ... and column by column for other linear operators
+template<typename MatrixType, typename T>
+void block_multiply(DynamicMatrix<T, columnMajor> &Y, const MatrixType &A,
+                    const DynamicMatrix<T, columnMajor> &X, std::false_type)
+{
+    Y.resize(X.rows(), X.columns(), false);
+    DynamicVector<T> x(X.rows());
+    DynamicVector<T> y(X.rows());
+    for(std::size_t j = 0; j < X.columns(); ++j) {
+        x = column(X, j);
+        symmetric_multiply(y, A, x);
+        column(Y, j) = y;
+    }
+}
+
+// Scales the columns of X, and the same columns of AX, to unit norm; zero columns stay zero
+template<typename T>
+void normalize_columns(DynamicMatrix<T, columnMajor> &X, DynamicMatrix<T, columnMajor> *AX)
+{
+    for(std::size_t j = 0; j < X.columns(); ++j) {
+        const T s = norm(column(X, j));
+        if(s > T(0)) {
+            column(X, j) /= s;
+            if(AX) {
+                column(*AX, j) /= s;
+            }
+        }
+    }
+}
+
+/**
+ *  LOBPCG following Knyazev, "Toward the optimal preconditioned
+ *  eigensolver" (2001). Every iteration performs a Rayleigh-Ritz
+ *  projection on span{X, W, P}: the current Ritz vectors X, the
+ *  preconditioned residuals W and the previous search directions P. All
+ *  work apart from the product A * W is done with dense block operations
+ *  (Gram matrices, basis updates). The Rayleigh-Ritz step works on the
+ *  Gram matrix of the basis and discards nearly dependent directions,
+ *  which appear as the eigenpairs converge, so no explicit
+ *  orthogonalization of the basis is needed. A * X and A * P are updated
+ *  from the projection instead of being recomputed.
+ */
+template<typename MatrixType, typename T>
+void solve_impl(
+        DynamicVector<T> &lambda,
+        const MatrixType &A,
+        const DynamicVector<T> &b,
+        LOBPCGTag &tag,
+        const std::size_t &n)
+{
+    static_assert(std::is_same<T, double>::value, "The LOBPCG blocks and callbacks work on double");
+    BLAZE_INTERNAL_ASSERT(isSymmetric(A), "A must be a symmetric matrix")
+
+    using Block = DynamicMatrix<T, columnMajor>;
+    using IsBlazeMatrix = std::integral_constant<bool, IsMatrix<MatrixType>::value>;
+
+    TraceScope trace_solve(tag, "solve", "solve");
+
+    const std::size_t m = b.size();
+    std::size_t k = std::min(n, m);
+    // The smallest eigenpairs of -A are the largest of A
+    const T sign = tag.largest() ? T(-1) : T(1);
+
+    Block X;
+    if(tag.initialBlock().rows() == m && tag.initialBlock().columns() == k) {
+        X = tag.initialBlock();
+    } else {
+        X.resize(m, k, false);
+        for(std::size_t j = 0; j < k; ++j) {
+            for(std::size_t i = 0; i < m; ++i) {
+                X(i, j) = std::sin(T(1) + T(0.7548776662) * T(i + 1) * T(2 * j + 1));
+            }
+        }
+        if(k > 0 && norm(b) > T(0)) {
+            column(X, 0) = b;
+        }
+    }
+
+    Block AX;
+    block_multiply(AX, A, X, IsBlazeMatrix());
+
+    // Rayleigh-Ritz on the initial block, which also makes it orthonormal
+    Block Y;
+    DynamicMatrix<T> F = trans(X) * AX;
+    DynamicMatrix<T> G = trans(X) * X;
+    F *= sign;
+    smallest_ritz_vectors(F, G, k, Y);
+    k = Y.columns();
+    X = X * Y;
+    AX = AX * Y;
+
+    Block R(m, k);
+    Block W(m, k);
+    Block AW(m, k);
+    Block P;
+    Block AP;
+    Block S;
+    Block AS;
+    lambda.resize(k, false);
+
+    tag.reserve_log(tag.maximumIterations() + 2);
+    std::size_t iteration{0};
+    while(true) {
+        TraceScope trace_iteration(tag, "iteration", "iteration", iteration);
+
+        // Ritz values and residuals of the orthonormal block X
+        T max_residual = T(0);
+        T max_relative_residual = T(0);
+        for(std::size_t j = 0; j < k; ++j) {
+            lambda[j] = trans(column(X, j)) * column(AX, j);
+            column(R, j) = column(AX, j) - lambda[j] * column(X, j);
+            const T residual_norm = norm(column(R, j));
+            max_residual = std::max(max_residual, residual_norm);
+            max_relative_residual = std::max(max_relative_residual,
+                    residual_norm / std::max(std::abs(lambda[j]), std::numeric_limits<T>::min()));
+        }
+
+        if(tag.do_log()) {
+            tag.log_residual(max_relative_residual);
+        }
+
+        if(tag.terminateIteration(iteration, max_residual, max_relative_residual)) {
+            break;
+        }
+
+        {
+            TraceScope trace(tag, "preconditioner", "preconditioner", iteration);
+            if(tag.preconditioner()) {
+                tag.preconditioner()(W, R);
+            } else {
+                W = R;
+            }
+        }
+        {
+            TraceScope trace(tag, "X^T W", "orthogonalization", iteration);
+            W -= X * (trans(X) * W);
+            normalize_columns(W, static_cast<Block *>(nullptr));
+        }
+        {
+            TraceScope trace(tag, "spmv", "spmv", iteration);
+            block_multiply(AW, A, W, IsBlazeMatrix());
+        }
+
+        // Basis [X W P] and its image [AX AW AP]
+        const std::size_t p = P.columns();
+        const std::size_t size = 2 * k + p;
+        S.resize(m, size, false);
+        AS.resize(m, size, false);
+        submatrix(S, 0, 0, m, k) = X;
+        submatrix(S, 0, k, m, k) = W;
+        submatrix(AS, 0, 0, m, k) = AX;
+        submatrix(AS, 0, k, m, k) = AW;
+        if(p > 0) {
+            submatrix(S, 0, 2 * k, m, p) = P;
+            submatrix(AS, 0, 2 * k, m, p) = AP;
+        }
+
+        {
+            TraceScope trace(tag, "rayleigh-ritz", "orthogonalization", iteration);
+            G = trans(S) * S;
+            F = trans(S) * AS;
+            F *= sign;
+            smallest_ritz_vectors(F, G, k, Y);
+        }
+        if(Y.columns() < k) {
+            break;
+        }
+
+        // The new search directions are the parts of the new Ritz vectors in span{W, P}
+        P = submatrix(S, 0, k, m, size - k) * submatrix(Y, k, 0, size - k, k);
+        AP = submatrix(AS, 0, k, m, size - k) * submatrix(Y, k, 0, size - k, k);
+        normalize_columns(P, &AP);
+        X = S * Y;
+        AX = AS * Y;
+
+        ++iteration;
+    }
+
+    tag.eigenvectors() = X;
+}
+
+// X, R, W, P, the basis S = [X W P], their images under A and the Rayleigh-Ritz matrices
+template<typename MatrixType>
+std::size_t workspace_impl(const MatrixType &A, const LOBPCGTag &tag, const std::size_t &n)
+{
+    using T = typename MatrixType::ElementType;
+
+    const std::size_t m = A.rows();
+    const std::size_t k = std::min(n, m);
+    return dense_bytes(m, 13 * k + 2, sizeof(T)) + dense_bytes(3 * k, 9 * k, sizeof(T));
+}
+
+} //end namespace detail
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_LOBPCG_HPP
@@ -0,0 +1,76 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_LOBPCGTAG_HPP
+#define BLAZE_ITERATIVE_LOBPCGTAG_HPP
+
+#include "BlazeIterative/IterativeCommon.hpp"
+#include "BlazeIterative/IterativeTag.hpp"
+#include <functional>
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+/**
+ * \class LOBPCGTag
+ * \brief Tag type to dispatch the LOBPCG block eigensolver
+ *
+ * LOBPCG (Knyazev 2001) computes the n smallest (or largest) eigenpairs of
+ * a symmetric matrix, with n the block size passed to solve():
+ *
+ * \code
+ * LOBPCGTag tag;
+ * tag.maximumIterations() = 200;
+ * DynamicVector<double> lambda = solve(A, b, tag, 10);
+ * const auto &X = tag.eigenvectors();   // A * column(X, j) ~ lambda[j] * column(X, j)
+ * \endcode
+ *
+ * The eigenvectors are stored on the tag. The iteration starts from
+ * initialBlock() if it has the right size, otherwise from b and
+ * deterministic pseudo-random vectors. The preconditioner is an optional
+ * callback computing W ~ T * R for a block of residuals (columns of R),
+ * e.g. an approximate inverse of A. Convergence is reached when
+ * ||A x_j - lambda_j x_j|| < relativeResidualTolerance() * |lambda_j| for all j.
+ */
+class LOBPCGTag : public IterativeTag
+{
+public:
+    using PreconditionerType = std::function<void(DynamicMatrix<double, columnMajor> &,
+                                                  const DynamicMatrix<double, columnMajor> &)>;
+
+    LOBPCGTag() {
+        solverName = "LOBPCG";
+    }
+
+    // Compute the largest instead of the smallest eigenvalues
+    bool &largest() { return compute_largest; }
+
+    bool largest() const { return compute_largest; }
+
+    PreconditionerType &preconditioner() { return apply_preconditioner; }
+
+    const PreconditionerType &preconditioner() const { return apply_preconditioner; }
+
+    DynamicMatrix<double, columnMajor> &initialBlock() { return initial_block; }
+
+    const DynamicMatrix<double, columnMajor> &initialBlock() const { return initial_block; }
+
+    // Eigenvectors of the last solve, one per column in the order of the eigenvalues
+    DynamicMatrix<double, columnMajor> &eigenvectors() { return eigenvector_block; }
+
+    const DynamicMatrix<double, columnMajor> &eigenvectors() const { return eigenvector_block; }
+
+protected:
+    bool compute_largest{false};
+    PreconditionerType apply_preconditioner;
+    DynamicMatrix<double, columnMajor> initial_block;
+    DynamicMatrix<double, columnMajor> eigenvector_block;
+};
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_LOBPCGTAG_HPP
@@ -8,6 +8,8 @@
 #define BLAZE_ITERATIVE_LANCZOS_HPP
 
 #include <BlazeIterative/IterativeCommon.hpp>
+#include <BlazeIterative/LinearOperator.hpp>
+#include <BlazeIterative/Workspace.hpp>
 #include "LanczosTag.hpp"
 
 
@@ -46,6 +48,7 @@ BLAZE_NAMESPACE_OPEN
                 DynamicVector<T> alpha(n);
                 DynamicVector<T> beta(n);
                 DynamicVector<T> Av(m);
+                DynamicVector<T> c(n);
                 DynamicMatrix<T> Q(m, n);
                 DynamicMatrix<T> h(n, n, 0);
                 DynamicVector<complex<double>> x_comp(n);
@@ -55,18 +58,22 @@ BLAZE_NAMESPACE_OPEN
              // http://people.inf.ethz.ch/arbenz/ewp/Lnotes/chapter10.pdf
 
                 column(Q,0) = b / norm(b);
-                Av = A * column(Q,0);
+                symmetric_multiply(Av, A, column(Q,0));
                 alpha[0] = trans(column(Q,0)) * Av;
                 Av -= alpha[0] * column(Q,0);
                 beta[0] = norm(Av);
 
                 for(int j =1 ; j < n; ++j){
                     column(Q,j) = Av / beta[j-1];
-                    Av = A * column(Q,j) - beta[j-1] * column(Q,j-1);
+                    symmetric_multiply(Av, A, column(Q,j));
+                    Av -= beta[j-1] * column(Q,j-1);
                     alpha[j] = trans(column(Q,j)) * Av;
                     Av -= alpha[j] * column(Q,j);
+                    // Full reorthogonalization against the basis so far, c = Q_1^T Av
                     auto Q_1 = submatrix(Q, 0, 0, m, j+1);
-                    Av -= Q_1 * (trans(Q_1) * Av);
+                    auto c_1 = subvector(c, 0, j+1);
+                    c_1 = trans(Q_1) * Av;
+                    Av -= Q_1 * c_1;
                     beta[j] = norm(Av);
                     if(beta[j] == 0){
                         break;
@@ -80,9 +87,19 @@ BLAZE_NAMESPACE_OPEN
 
                 eigen(h, x_comp);
                 x = real(x_comp);
+                recover_eigenvalues(x, A);
 
             }; // end solve_imple function
 
+            // Q, Av, the tridiagonal matrix and its eigenvalues
+            template<typename MatrixType>
+            std::size_t workspace_impl(const MatrixType &A, const LanczosTag &tag, const std::size_t &n)
+            {
+                using T = typename MatrixType::ElementType;
+                return dense_bytes(A.rows(), n + 1, sizeof(T)) + dense_bytes(n, n + 3, sizeof(T))
+                       + n * sizeof(complex<double>);
+            }
+
         } //end namespace detail
 
     ITERATIVE_NAMESPACE_CLOSE
@@ -0,0 +1,171 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_MINRES_HPP
+#define BLAZE_ITERATIVE_MINRES_HPP
+
+#include "BlazeIterative/IterativeCommon.hpp"
+#include "BlazeIterative/LinearOperator.hpp"
+#include "BlazeIterative/Reduction.hpp"
+#include "BlazeIterative/Trace.hpp"
+#include "BlazeIterative/Workspace.hpp"
+#include "MINRESTag.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+namespace detail {
+
+/**
+ *  Implementation of preconditioned MINRES, following Paige and Saunders,
+ *  "Solution of sparse indefinite systems of linear equations" (1975).
+ *  The preconditioned Lanczos recurrence builds the tridiagonal matrix one
+ *  column at a time; Givens rotations reduce it to upper triangular form,
+ *  and x is updated along the search directions w = V R^-1, of which only
+ *  the last two are kept. The residual norm is a by-product of the
+ *  rotations, so no extra product or reduction is needed to monitor it.
+ */
+template<typename MatrixType, typename T>
+void solve_impl(
+        DynamicVector<T> &x,
+        const MatrixType &A,
+        const DynamicVector<T> &b,
+        MINRESTag &tag,
+        std::string Preconditioner="")
+{
+    static_assert(std::is_same<T, double>::value, "The MINRES preconditioner callback works on double vectors");
+
+    BLAZE_INTERNAL_ASSERT(isSymmetric(A), "A must be a symmetric matrix")
+
+    TraceScope trace_solve(tag, "solve", "solve");
+
+    const std::size_t m = b.size();
+
+    // Lanczos vectors r1, r2 (unpreconditioned) and y = M^-1 r2, search directions w, w1, w2
+    DynamicVector<T> r1(m);
+    DynamicVector<T> r2(m);
+    DynamicVector<T> y(m);
+    DynamicVector<T> v(m);
+    DynamicVector<T> w(m, T(0));
+    DynamicVector<T> w1(m, T(0));
+    DynamicVector<T> w2(m, T(0));
+
+    std::size_t iteration{0};
+
+    auto precondition = [&]() {
+        TraceScope trace(tag, "preconditioner", "preconditioner", iteration);
+        if(tag.preconditioner()) {
+            tag.preconditioner()(y, r2);
+        } else {
+            y = r2;
+        }
+    };
+
+    residual(r1, A, x, b);
+    r2 = r1;
+    precondition();
+    const T beta1 = std::sqrt(std::max(T(dot_product(tag, r1, y)), T(0)));
+    if(beta1 == T(0)) {
+        tag.terminateIteration(iteration, T(0), T(0));
+        return;
+    }
+
+    T beta = beta1;
+    T old_beta = T(0);
+    T epsilon = T(0);
+    T d_bar = T(0);
+    T phi_bar = beta1;
+    T cs = T(-1);
+    T sn = T(0);
+
+    tag.reserve_log(tag.maximumIterations() + 2);
+    while(true) {
+        TraceScope trace_iteration(tag, "iteration", "iteration", iteration);
+
+        // Lanczos step: beta_{k+1} v_{k+1} = A v_k - alpha_k v_k - beta_k v_{k-1} (in the M^-1 inner product)
+        v = y / beta;
+        {
+            TraceScope trace(tag, "spmv", "spmv", iteration);
+            symmetric_multiply(y, A, v);
+        }
+        if(iteration > 0) {
+            y -= (beta / old_beta) * r1;
+        }
+        T alpha;
+        {
+            TraceScope trace(tag, "v.y", "reduction", iteration);
+            alpha = dot_product(tag, v, y);
+        }
+        y -= (alpha / beta) * r2;
+        std::swap(r1, r2);
+        std::swap(r2, y);
+
+        precondition();
+        old_beta = beta;
+        {
+            TraceScope trace(tag, "r.y", "reduction", iteration);
+            // M is positive definite, a negative value is rounding error
+            beta = std::sqrt(std::max(T(dot_product(tag, r2, y)), T(0)));
+        }
+
+        // Apply the previous rotation to the new column of the tridiagonal matrix
+        const T old_epsilon = epsilon;
+        const T delta = cs * d_bar + sn * alpha;
+        const T gamma_bar = sn * d_bar - cs * alpha;
+        epsilon = sn * beta;
+        d_bar = -cs * beta;
+
+        // New rotation, annihilating beta
+        const T gamma = std::max(std::sqrt(gamma_bar * gamma_bar + beta * beta), std::numeric_limits<T>::min());
+        cs = gamma_bar / gamma;
+        sn = beta / gamma;
+        const T phi = cs * phi_bar;
+        phi_bar = sn * phi_bar;
+
+        // w_k = (v_k - epsilon_k w_{k-2} - delta_k w_{k-1}) / gamma_k
+        std::swap(w1, w2);
+        std::swap(w2, w);
+        w = (v - old_epsilon * w1 - delta * w2) / gamma;
+        x += phi * w;
+
+        const T absolute_residual = phi_bar;
+        const T relative_residual = phi_bar / beta1;
+        if(tag.do_log()) {
+            tag.log_residual(relative_residual);
+        }
+
+        if(tag.terminateIteration(iteration, absolute_residual, relative_residual)) {
+            break;
+        }
+
+        // The Krylov space is invariant under A: x is exact
+        if(beta == T(0)) {
+            break;
+        }
+
+        ++iteration;
+    }
+
+}
+
+// r1, r2, y, v and the search directions w, w1, w2
+template<typename MatrixType>
+std::size_t workspace_impl(const MatrixType &A, const MINRESTag &tag, const std::string &Preconditioner)
+{
+    return dense_bytes(A.rows(), 7, sizeof(typename MatrixType::ElementType));
+}
+
+} //end namespace detail
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_MINRES_HPP
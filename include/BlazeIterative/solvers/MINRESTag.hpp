@@ -0,0 +1,58 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_MINRESTAG_HPP
+#define BLAZE_ITERATIVE_MINRESTAG_HPP
+
+#include <BlazeIterative/IterativeCommon.hpp>
+#include <BlazeIterative/IterativeTag.hpp>
+#include <functional>
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+/**
+ * \class MINRESTag
+ * \brief Tag type to dispatch a MINRES solver
+ *
+ * MINRES (Paige and Saunders 1975) minimizes the residual over the Krylov
+ * space like GMRES, but for symmetric (possibly indefinite) A it needs
+ * only the Lanczos three-term recurrence: memory is 7 vectors and every
+ * iteration costs one product with A, whatever the iteration count.
+ *
+ * The preconditioner is an optional callback computing z = M^-1 v for a
+ * symmetric positive definite M:
+ * \code
+ * MINRESTag tag;
+ * tag.preconditioner() = [&](DynamicVector<double> &z, const DynamicVector<double> &v) { ... };
+ * auto x = solve(A, b, tag);
+ * \endcode
+ *
+ * The residuals checked by terminateIteration() are the recurrence
+ * estimates of ||r||_M^-1 and ||r||_M^-1 / ||r_0||_M^-1; without a
+ * preconditioner these are the Euclidean norms.
+ */
+class MINRESTag : public IterativeTag
+{
+public:
+    using PreconditionerType = std::function<void(DynamicVector<double> &, const DynamicVector<double> &)>;
+
+    MINRESTag() {
+        solverName = "MINRES";
+    }
+
+    PreconditionerType &preconditioner() { return apply_preconditioner; }
+
+    const PreconditionerType &preconditioner() const { return apply_preconditioner; }
+
+protected:
+    PreconditionerType apply_preconditioner;
+};
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_MINRESTAG_HPP
@@ -6,7 +6,15 @@
 #ifndef BLAZE_ITERATIVE_PRECONDITIONBICGSTAB_HPP
 #define BLAZE_ITERATIVE_PRECONDITIONBICGSTAB_HPP
 
+#include "BlazeIterative/LinearOperator.hpp"
+#include "BlazeIterative/Reduction.hpp"
+#include "BlazeIterative/Trace.hpp"
+#include "BlazeIterative/Workspace.hpp"
+#include "BlazeIterative/preconditioners/IncompleteFactorization.hpp"
+#include "BlazeIterative/preconditioners/TriangularSolve.hpp"
 #include "PreconditionBiCGSTABTag.hpp"
+#include "SolverSetup.hpp"
+#include <algorithm>
 
 BLAZE_NAMESPACE_OPEN
 ITERATIVE_NAMESPACE_OPEN
@@ -14,10 +22,11 @@ ITERATIVE_NAMESPACE_OPEN
 namespace detail {
 
 /**
- *  Implementation of the decompositions provided by blaze
+ *  Implementation of the decompositions provided by blaze: A = K1 * K2 * P,
+ *  where P is a permutation matrix for LU and left empty (identity) otherwise.
  */
 template<typename MatrixType, typename T>
-void decomposition(std::string type, const MatrixType &A, MatrixType &K1, MatrixType &K2){
+void decomposition(std::string type, const MatrixType &A, MatrixType &K1, MatrixType &K2, MatrixType &P){
     
     
     if (type.compare("Cholesky")==0){
@@ -42,15 +51,107 @@ void decomposition(std::string type, const MatrixType &A, MatrixType &K1, Matrix
 
     if (type.compare("LU") == 0 || type.compare("") == 0){
 
-    MatrixType P;
     lu( A, K1, K2, P ); // A is a row-major matrix
-    K2 *= P;
         
     }
     
      
 }    
     
+/**
+ *  Setup phase of the Preconditioned BiCGSTAB method: decomposes A = K1 * K2 * P
+ *  once for all right-hand sides. Triangular factors (LU, Cholesky) are
+ *  applied with level-scheduled sparse triangular solves, whose analysis is
+ *  done here; the factors of QR and RQ are inverted explicitly. The
+ *  incomplete factorizations "ILU" (ILU(0)) and "ILUT" (thresholds from
+ *  the tag) are computed in sparse storage without a dense factor.
+ */
+template<typename MatrixType, typename T>
+class SolverSetup<PreconditionBiCGSTABTag, MatrixType, T>
+{
+public:
+    void setup(const MatrixType &A, const std::string &Preconditioner, const PreconditionBiCGSTABTag &tag)
+    {
+        if(Preconditioner.compare("ILUT") == 0 || Preconditioner.compare("ILU") == 0) {
+            CompressedMatrix<T, rowMajor> L;
+            CompressedMatrix<T, rowMajor> U;
+            if(Preconditioner.compare("ILUT") == 0) {
+                ilut(A, tag.dropTolerance(), tag.maximumFill(), L, U);
+            } else {
+                ilu0(A, L, U);
+            }
+            triangular = true;
+            lower.setup(L, TriangularPart::LOWER);
+            upper.setup(U, TriangularPart::UPPER);
+            permutation.clear();
+            return;
+        }
+
+        MatrixType K1;
+        MatrixType K2;
+        MatrixType P;
+        decomposition<MatrixType,T>(Preconditioner,A,K1,K2,P);
+
+        triangular = isLower(K1) && isUpper(K2);
+        if(triangular) {
+            lower.setup(K1, TriangularPart::LOWER);
+            upper.setup(K2, TriangularPart::UPPER);
+
+            // (K2 * P)^-1 = trans(P) * K2^-1, i.e. z[i] = w[permutation[i]] with P(permutation[i], i) = 1
+            permutation.clear();
+            if(P.rows() == A.rows()) {
+                permutation.resize(A.rows());
+                for(std::size_t i = 0; i < P.rows(); ++i) {
+                    for(std::size_t j = 0; j < P.columns(); ++j) {
+                        if(P(i, j) != T(0)) {
+                            permutation[j] = i;
+                        }
+                    }
+                }
+            }
+        } else {
+            Kinv = P.rows() == A.rows() ? DynamicMatrix<T>(inv(K1*K2*P)) : DynamicMatrix<T>(inv(K1*K2));
+            K1inv = inv(K1);
+        }
+    }
+
+    // z = (K1 * K2 * P)^-1 p; work has the size of p
+    void apply(DynamicVector<T> &z, const DynamicVector<T> &p, DynamicVector<T> &work) const
+    {
+        if(!triangular) {
+            z = Kinv * p;
+            return;
+        }
+        if(permutation.empty()) {
+            lower.solve(z, p);
+            upper.solve(z, z);
+            return;
+        }
+        lower.solve(work, p);
+        upper.solve(work, work);
+        for(std::size_t i = 0; i < permutation.size(); ++i) {
+            z[i] = work[permutation[i]];
+        }
+    }
+
+    // y = K1^-1 t
+    void apply_K1(DynamicVector<T> &y, const DynamicVector<T> &t) const
+    {
+        if(triangular) {
+            lower.solve(y, t);
+        } else {
+            y = K1inv * t;
+        }
+    }
+
+    bool triangular{false};
+    SparseTriangularSolver<T> lower;
+    SparseTriangularSolver<T> upper;
+    std::vector<std::size_t> permutation;
+    DynamicMatrix<T> Kinv;
+    DynamicMatrix<T> K1inv;
+};
+
 /**
  *  Implementation of the Preconditioned BiCGSTAB method, following the
  *  preconditioned version on Wikipedia using various decompositions.
@@ -61,18 +162,11 @@ void solve_impl(
         const MatrixType &A,
         const DynamicVector<T> &b,
         PreconditionBiCGSTABTag &tag,
-        std::string Preconditioner="")
+        const SolverSetup<PreconditionBiCGSTABTag, MatrixType, T> &setup)
 {
 
-    // Decomposition A = K1 * K2
-    MatrixType K1;
-    MatrixType K2;
-    decomposition<MatrixType,T>(Preconditioner,A,K1,K2);
-    
-    // Compute inverse
-    auto Kinv = inv(K1*K2);
-    auto K1inv = inv(K1 ); 
-    
+    TraceScope trace_solve(tag, "solve", "solve");
+
     DynamicVector<T> r = b - A * x;
     DynamicVector<T> p(r);
     DynamicVector<T> v(r);
@@ -81,9 +175,13 @@ void solve_impl(
     DynamicVector<T> s(p.size());
     DynamicVector<T> t(p.size());
     DynamicVector<T> z(p.size());
+    DynamicVector<T> h(p.size());
+    DynamicVector<T> K1inv_t(p.size());
+    DynamicVector<T> K1inv_s(p.size());
+    DynamicVector<T> work(p.size());
     DynamicVector<T> error(r);
 
-    auto absolute_residual_0 = trans(r) * r;
+    auto absolute_residual_0 = dot_product(tag, r, r);
     auto absolute_residual = absolute_residual_0;
 
     auto rho_prev = T(1);
@@ -92,21 +190,29 @@ void solve_impl(
 
 
     std::size_t iteration{0};
+    tag.reserve_log(2 * tag.maximumIterations() + 2);
     while (true) {
+        TraceScope trace_iteration(tag, "iteration", "iteration", iteration);
 
-        auto rho = trans(r0) * r;
+        auto rho = dot_product(tag, r0, r);
         auto beta = (rho * alpha) / (rho_prev * w);
 
         p = r + beta * (p - w * v);
         //v = A * p;
-        y = Kinv * p;
-        v = A * y;
+        {
+            TraceScope trace(tag, "preconditioner", "preconditioner", iteration);
+            setup.apply(y, p, work);
+        }
+        {
+            TraceScope trace(tag, "spmv", "spmv", iteration);
+            multiply(v, A, y);
+        }
         
-        alpha = rho / (trans(r0) * v);
+        alpha = rho / dot_product(tag, r0, v);
         
-        auto h = x + alpha * y;
-        error = b - A*h;
-        absolute_residual = trans(error)*error;
+        h = x + alpha * y;
+        residual(error, A, h, b);
+        absolute_residual = dot_product(tag, error, error);
         auto relative_residual = absolute_residual/absolute_residual_0;
          if(tag.do_log()) {
             tag.log_residual(relative_residual);
@@ -118,23 +224,37 @@ void solve_impl(
         }
         
         s = r - alpha * v;
-        z = Kinv * s;
-        t = A*z;
+        {
+            TraceScope trace(tag, "preconditioner", "preconditioner", iteration);
+            setup.apply(z, s, work);
+        }
+        {
+            TraceScope trace(tag, "spmv", "spmv", iteration);
+            multiply(t, A, z);
+        }
 
         // sometimes, t will be zero, so trans(t)*t is zero.
         // This happens if the solution is exactly correct,
         // So best to set w=0, and loop will terminate below.
-        auto t_dot_t = blaze::dot(K1inv*t,K1inv*t);
-        if(t_dot_t == 0)
-            w = 0;
-        else
-            w = blaze::dot(K1inv*t,K1inv*s)/t_dot_t; // replace with 12
+        {
+            TraceScope trace(tag, "preconditioner", "preconditioner", iteration);
+            setup.apply_K1(K1inv_t, t);
+            setup.apply_K1(K1inv_s, s);
+        }
+        {
+            TraceScope trace(tag, "t.t, t.s", "reduction", iteration);
+            auto t_dot_t = dot_product(tag, K1inv_t, K1inv_t);
+            if(t_dot_t == 0)
+                w = 0;
+            else
+                w = dot_product(tag, K1inv_t, K1inv_s)/t_dot_t; // replace with 12
+        }
 
 
         x += alpha*y + w*z;
 
-        error = b - A*x;
-        absolute_residual = trans(error)*error;
+        residual(error, A, x, b);
+        absolute_residual = dot_product(tag, error, error);
         relative_residual = absolute_residual/absolute_residual_0;
         if(tag.do_log()) {
             tag.log_residual(relative_residual);
@@ -151,6 +271,53 @@ void solve_impl(
     }
 }
 
+template<typename MatrixType, typename T>
+void solve_impl(
+        DynamicVector<T> &x,
+        const MatrixType &A,
+        const DynamicVector<T> &b,
+        PreconditionBiCGSTABTag &tag,
+        std::string Preconditioner="")
+{
+    SolverSetup<PreconditionBiCGSTABTag, MatrixType, T> setup;
+    {
+        TraceScope trace(tag, "factorization", "factorization");
+        setup.setup(A, Preconditioner, tag);
+    }
+
+    solve_impl(x, A, b, tag, setup);
+}
+
+/**
+ * The 13 vectors of the iteration and the preconditioner. "ILU" and
+ * "ILUT" keep sparse factors with the pattern of the triangles of A (plus
+ * maximumFill entries per row for "ILUT"). The dense decompositions keep
+ * K1, K2 and P, and either the triangular solvers of the factors (LU,
+ * Cholesky) or the explicit inverses (QR, RQ).
+ */
+template<typename MatrixType>
+std::size_t workspace_impl(const MatrixType &A, const PreconditionBiCGSTABTag &tag, const std::string &Preconditioner)
+{
+    using T = typename MatrixType::ElementType;
+
+    const std::size_t m = A.rows();
+    const std::size_t vectors = dense_bytes(m, 13, sizeof(T));
+    if(Preconditioner.compare("ILUT") == 0 || Preconditioner.compare("ILU") == 0) {
+        const std::size_t nonzeros = matrix_nonzeros(A);
+        std::size_t factor_nonzeros = (nonzeros + m) / 2;
+        if(Preconditioner.compare("ILUT") == 0) {
+            factor_nonzeros = std::min(factor_nonzeros + m * tag.maximumFill(), m * (m + 1) / 2);
+        }
+        return vectors + sparse_bytes<T>(m, nonzeros) + 2 * factor_bytes<T>(m, factor_nonzeros);
+    }
+
+    const std::size_t factors = dense_bytes(m, 3 * m, sizeof(T));
+    if(Preconditioner.compare("QR") == 0 || Preconditioner.compare("RQ") == 0) {
+        return vectors + factors + dense_bytes(m, 3 * m, sizeof(T));
+    }
+    return vectors + factors + 2 * factor_bytes<T>(m, m * (m + 1) / 2) + m * sizeof(std::size_t);
+}
+
 } //end namespace detail
 
 ITERATIVE_NAMESPACE_CLOSE
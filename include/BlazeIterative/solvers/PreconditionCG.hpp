@@ -8,85 +8,132 @@
 #ifndef BLAZE_ITERATIVE_PRECONDITIONCG_HPP
 #define BLAZE_ITERATIVE_PRECONDITIONCG_HPP
 
+#include "BlazeIterative/LinearOperator.hpp"
+#include "BlazeIterative/Reduction.hpp"
+#include "BlazeIterative/Trace.hpp"
+#include "BlazeIterative/Workspace.hpp"
+#include "BlazeIterative/preconditioners/IncompleteFactorization.hpp"
+#include "BlazeIterative/preconditioners/TriangularSolve.hpp"
 #include "PreconditionCGTag.hpp"
+#include "SolverSetup.hpp"
+#include <algorithm>
+#include <type_traits>
 BLAZE_NAMESPACE_OPEN
 ITERATIVE_NAMESPACE_OPEN
 
     namespace detail {
 
-        template< typename MatrixType>
-        void copyStrictlyLowerPart( const MatrixType& src, MatrixType& dst )
-
-        {
-
-            decltype(auto) target( derestrict( ~dst ) );
-            resize( target, (~src).rows(), (~src).columns() );
-            reset( target );
-
-
-            for(signed long int i=1UL; i<(~src).rows(); ++i ) {
-
-                for(signed long int j=0UL; j<i; ++j ) {
-
-                    (~target)(i,j) = (~src)(i,j);
-
-                }
-
-            }
-
-        }
-
         // Decompose A as A = L + D + U, where L is strictly lower triangular matrix, D is diagonal matrix, and U is
-        // strictly upper triangular matrix.
+        // strictly upper triangular matrix. Every preconditioner is returned in the factored form
+        // M = K * inv(diag(s)) * trans(K) with a lower triangular K, so that M^-1 r = K^-T (s .* (K^-1 r)).
+        // K is sparse whatever the storage of A.
         template<typename MatrixType, typename T>
-        void preconditioner_matrix(std::string type, const MatrixType &A, MatrixType &M){
-
-            if (type.compare("Jacobi")==0){
+        void preconditioner_factor(std::string type, const MatrixType &A, CompressedMatrix<T, rowMajor> &K, DynamicVector<T> &s){
 
-                DiagonalMatrix<MatrixType> D(A.columns());
-                band<0L>(D) = band<0L>(A);
-                M = D;
+            const bool jacobi = type.compare("Jacobi")==0;
+            if (!jacobi && type.compare("Symmetric_Gauss_Seidel")!=0 && type.compare("SSOR")!=0){
+                return;
             }
 
-
-            if (type.compare("Symmetric_Gauss_Seidel")==0){
-
-                MatrixType L(A.rows(),A.columns());
-                copyStrictlyLowerPart<MatrixType>(A, L);
-
-                DiagonalMatrix<MatrixType> D(A.columns());
-                band<0L>(D) = band<0L>(A);
-
-                M = (D + L) * inv(D) * (D + trans(L));
+            // Jacobi:                 M = D = D * inv(D) * D
+            // Symmetric Gauss-Seidel: M = (D + L) * inv(D) * trans(D + L)
+            const CompressedMatrix<T, rowMajor> S(A);
+            const std::size_t n = S.rows();
+            K = CompressedMatrix<T, rowMajor>(n, n);
+            K.reserve(jacobi ? n : (S.nonZeros() + n) / 2);
+            s = DynamicVector<T>(n, T(0));
+
+            for (std::size_t i=0; i<n; ++i){
+                for (auto element = S.begin(i); element != S.end(i) && element->index() <= i; ++element){
+                    if (element->index() == i){
+                        s[i] = element->value();
+                    }
+                    if (element->index() == i || !jacobi){
+                        K.append(i, element->index(), element->value());
+                    }
+                }
+                K.finalize(i);
             }
+        }
 
 
-            if (type.compare("SSOR")==0){
-                DiagonalMatrix<MatrixType> D(A.columns());
-                MatrixType L(A.rows(),A.columns());
-                copyStrictlyLowerPart<MatrixType>(A, L);
-                band<0L>(D) = band<0L>(A);
+        // The SPD check needs a dense Cholesky factorization and is skipped for sparse A
+        template<typename MatrixType>
+        void check_positive_definite(const MatrixType &A, std::true_type)
+        {
+            MatrixType L_pos;
+            llh( A, L_pos);
+            BLAZE_USER_ASSERT(A == L_pos* ctrans(L_pos), "A must be a positive definite matrix")
+        }
 
-                M = (D + L) * inv(D) * trans(D + L);
+        template<typename MatrixType>
+        void check_positive_definite(const MatrixType &, std::false_type)
+        {}
+
+
+        /**
+         * Setup phase of the preconditioned CG method: checks that A is SPD
+         * and factors the preconditioner as M = K * inv(diag(s)) * trans(K).
+         * The incomplete Cholesky factorizations ("incomplete_Cholesky" is
+         * IC(0), "ICT" the threshold variant controlled by the tag) are
+         * computed in sparse storage with K = trans(U) and s = diag(U).
+         * The level schedules of the triangular solves with K and trans(K)
+         * are computed here, so that apply() runs the levels in parallel.
+         * The result only depends on A and the preconditioner type, so it is
+         * shared by all right-hand sides.
+         */
+        template<typename MatrixType, typename T>
+        class SolverSetup<PreconditionCGTag, MatrixType, T>
+        {
+        public:
+            void setup(const MatrixType &A, const std::string &Preconditioner, const PreconditionCGTag &tag)
+            {
+                factor(assembled(A), Preconditioner, tag);
             }
 
-
-            if (type.compare("incomplete_Cholesky") == 0 || type.compare("") == 0){
-                // The Cholesky factorization of A is A = LL*, where L is a lower triangular matrix.
-                // Incomplete Cholesky factorization precondition is M = KK*, where K is a sparse lower triangular matrix and is close to L.
-                // Solution is: finding the exact Cholesky decomposition, except that any entry is set to zero
-                // if the corresponding entry in A is also zero.
-
-                MatrixType L, K;
-                llh( A, L );  // L* LH decomposition of a row-major matrix
-                K = map(A, L, [](T aval, T lval) { return aval == T{0} ? T{0} : lval; });
-                M = K * trans(K);
-
+            // z = M^-1 r
+            void apply(DynamicVector<T> &z, const DynamicVector<T> &r) const
+            {
+                lower.solve(z, r);
+                z *= scaling;
+                upper.solve(z, z);
             }
 
-        }
+            SparseTriangularSolver<T> lower;
+            SparseTriangularSolver<T> upper;
+            DynamicVector<T> scaling;
+
+        private:
+            // M holds the entries of A; operators are assembled for the setup only
+            template<typename MT>
+            void factor(const MT &M, const std::string &Preconditioner, const PreconditionCGTag &tag)
+            {
+                BLAZE_INTERNAL_ASSERT(isSymmetric(M), "A must be a symmetric matrix")
+
+#if BLAZE_USER_ASSERTION
+                check_positive_definite(M, std::integral_constant<bool, IsDenseMatrix<MT>::value>());
+#endif
+
+                if (Preconditioner.compare("ICT") == 0 || Preconditioner.compare("incomplete_Cholesky") == 0
+                    || Preconditioner.compare("") == 0) {
+                    CompressedMatrix<T, rowMajor> U;
+                    if (Preconditioner.compare("ICT") == 0) {
+                        ict(M, tag.dropTolerance(), tag.maximumFill(), U, scaling);
+                    } else {
+                        ic0(M, U, scaling);
+                    }
+                    lower.setup(trans(U), TriangularPart::LOWER);
+                    upper.setup(U, TriangularPart::UPPER);
+                    return;
+                }
 
+                CompressedMatrix<T, rowMajor> K;
+                preconditioner_factor(Preconditioner, M, K, scaling);
 
+                lower.setup(K, TriangularPart::LOWER);
+                upper.setup(trans(K), TriangularPart::UPPER);
+            }
+        };
 
 
         template<typename MatrixType, typename T>
@@ -95,42 +142,48 @@ ITERATIVE_NAMESPACE_OPEN
                 const MatrixType &A,
                 const DynamicVector<T> &b,
                 PreconditionCGTag &tag,
-                std::string Preconditioner="")
+                const SolverSetup<PreconditionCGTag, MatrixType, T> &setup)
         {
-            BLAZE_INTERNAL_ASSERT(isSymmetric(A), "A must be a symmetric matrix")
-
-            MatrixType L_pos;
-            llh( A, L_pos);
-            BLAZE_USER_ASSERT(A == L_pos* ctrans(L_pos), "A must be a positive definite matrix")
-
-            MatrixType M;
-            preconditioner_matrix<MatrixType, T>(Preconditioner,A,M);
+            TraceScope trace_solve(tag, "solve", "solve");
 
-            auto Minv = inv(M);
-
-            DynamicVector<T> r = b - A * x;
-            DynamicVector<T> z = Minv * r;
+            DynamicVector<T> r(b.size());
+            residual(r, A, x, b);
+            DynamicVector<T> z(r.size());
+            setup.apply(z, r);
             DynamicVector<T> p(z);
             DynamicVector<T> Ap(p.size());
 
-            T absolute_residual_0 = trans(r) * r;
+            T absolute_residual_0 = dot_product(tag, r, r);
             T absolute_residual = absolute_residual_0;
 
+            tag.reserve_log(tag.maximumIterations() + 2);
             if(tag.do_log()) {
                 tag.log_residual(absolute_residual/absolute_residual_0);
             }
 
             std::size_t iteration{0};
             while(true) {
-                Ap = declsym(A)*p;
+                TraceScope trace_iteration(tag, "iteration", "iteration", iteration);
+
+                {
+                    TraceScope trace(tag, "spmv", "spmv", iteration);
+                    symmetric_multiply(Ap, A, p);
+                }
 
-                T alpha = trans(r) * z/(trans(p) * Ap);
-                T precondition_residual_prev = trans(z) * r;
+                T alpha, precondition_residual_prev;
+                {
+                    TraceScope trace(tag, "r.z, p.Ap", "reduction", iteration);
+                    precondition_residual_prev = dot_product(tag, z, r);
+                    alpha = precondition_residual_prev/dot_product(tag, p, Ap);
+                }
                 x += alpha * p;
                 r -= alpha * Ap;
 
 
-                absolute_residual = trans(r) * r;
+                {
+                    TraceScope trace(tag, "r.r", "reduction", iteration);
+                    absolute_residual = dot_product(tag, r, r);
+                }
 
                 if(tag.do_log()) {
                     tag.log_residual(absolute_residual/absolute_residual_0);
@@ -140,8 +193,11 @@ ITERATIVE_NAMESPACE_OPEN
                     break;
                 }
 
-                z = Minv * r;
-                T beta = trans(z)*r/precondition_residual_prev;
+                {
+                    TraceScope trace(tag, "preconditioner", "preconditioner", iteration);
+                    setup.apply(z, r);
+                }
+                T beta = dot_product(tag, z, r)/precondition_residual_prev;
                 p = z + beta * p;
 
                 ++iteration;
@@ -151,6 +207,47 @@ ITERATIVE_NAMESPACE_OPEN
         };
 
 
+        template<typename MatrixType, typename T>
+        void solve_impl(
+                DynamicVector<T> &x,
+                const MatrixType &A,
+                const DynamicVector<T> &b,
+                PreconditionCGTag &tag,
+                std::string Preconditioner="")
+        {
+            SolverSetup<PreconditionCGTag, MatrixType, T> setup;
+            {
+                TraceScope trace(tag, "factorization", "factorization");
+                setup.setup(A, Preconditioner, tag);
+            }
+
+            solve_impl(x, A, b, tag, setup);
+        };
+
+
+        /**
+         * r, z, p, Ap and the preconditioner: a copy of A, the factor K and
+         * the triangular solvers with K and trans(K). The incomplete
+         * factorizations have the pattern of the lower triangle of A, plus
+         * maximumFill entries per row for "ICT".
+         */
+        template<typename MatrixType>
+        std::size_t workspace_impl(const MatrixType &A, const PreconditionCGTag &tag, const std::string &Preconditioner)
+        {
+            using T = typename MatrixType::ElementType;
+
+            const std::size_t m = A.rows();
+            const std::size_t nonzeros = matrix_nonzeros(A);
+            std::size_t factor_nonzeros = (nonzeros + m) / 2;
+            if (Preconditioner.compare("Jacobi") == 0) {
+                factor_nonzeros = m;
+            } else if (Preconditioner.compare("ICT") == 0) {
+                factor_nonzeros = std::min(factor_nonzeros + m * tag.maximumFill(), m * (m + 1) / 2);
+            }
+            return dense_bytes(m, 5, sizeof(T)) + sparse_bytes<T>(m, nonzeros) + 2 * factor_bytes<T>(m, factor_nonzeros);
+        }
+
+
     } //end namespace detail        } //end namespace detail
 
 ITERATIVE_NAMESPACE_CLOSE
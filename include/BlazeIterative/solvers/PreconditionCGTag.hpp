@@ -20,6 +20,21 @@ public:
     PreconditionCGTag() {
          solverName = "PreconditionCG";
      }
+
+    // Entries below dropTolerance times the norm of their row of A are
+    // dropped by the threshold factorizations ("ICT")
+    double &dropTolerance() { return drop_tolerance; }
+
+    double dropTolerance() const { return drop_tolerance; }
+
+    // Fill entries kept per row and factor beyond those of A in that row
+    std::size_t &maximumFill() { return maximum_fill; }
+
+    std::size_t maximumFill() const { return maximum_fill; }
+
+protected:
+    double drop_tolerance{1.0e-3};
+    std::size_t maximum_fill{10};
 };
 
 ITERATIVE_NAMESPACE_CLOSE
@@ -0,0 +1,38 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_SOLVERSETUP_HPP
+#define BLAZE_ITERATIVE_SOLVERSETUP_HPP
+
+#include <BlazeIterative/IterativeCommon.hpp>
+#include <string>
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+namespace detail {
+
+/**
+ * \brief Data computed once per operator and reused by every solve.
+ *
+ * The primary template is used by all solvers without a setup phase
+ * and holds nothing. Solvers that build preconditioners or factorizations
+ * specialize it for their tag type; the specialization is what
+ * blaze::iterative::Solver keeps between calls to solve().
+ */
+template<typename TagType, typename MatrixType, typename T>
+class SolverSetup
+{
+public:
+    void setup(const MatrixType &A, const std::string &Preconditioner, const TagType &tag) {}
+};
+
+} //end namespace detail
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_SOLVERSETUP_HPP
@@ -0,0 +1,152 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BLAZE_ITERATIVE_STATICSOLVERS_HPP
+#define BLAZE_ITERATIVE_STATICSOLVERS_HPP
+
+#include "BlazeIterative/IterativeCommon.hpp"
+#include "ConjugateGradientTag.hpp"
+#include "BiCGSTABTag.hpp"
+
+BLAZE_NAMESPACE_OPEN
+ITERATIVE_NAMESPACE_OPEN
+
+/*
+ * Solvers for fixed-size systems given as StaticMatrix/StaticVector.
+ *
+ * The size is a compile-time constant, so all work vectors are
+ * StaticVectors on the stack and every matrix-vector product and dot
+ * product is a fully unrolled Blaze kernel. A solve does not touch the
+ * heap unless the convergence history is recorded. Checkpointing is not
+ * available for these overloads.
+ */
+
+namespace detail {
+
+template<typename T, std::size_t N, bool SO>
+void solve_impl(
+        StaticVector<T, N> &x,
+        const StaticMatrix<T, N, N, SO> &A,
+        const StaticVector<T, N> &b,
+        ConjugateGradientTag &tag)
+{
+
+    BLAZE_INTERNAL_ASSERT(isSymmetric(A), "A must be a symmetric matrix")
+
+    StaticVector<T, N> r(b - A * x);
+    StaticVector<T, N> p(r);
+    StaticVector<T, N> Ap;
+
+    const T absolute_residual_0 = trans(r) * r;
+    T absolute_residual = absolute_residual_0;
+
+    if(absolute_residual_0 == T(0)) {
+        tag.terminateIteration(0, 0.0, 0.0);
+        return;
+    }
+    tag.reserve_log(tag.maximumIterations() + 2);
+    if(tag.do_log()) {
+        tag.log_residual(T(1));
+    }
+
+    std::size_t iteration{0};
+    while(true) {
+        const T absolute_residual_prev = absolute_residual;
+        Ap = declsym(A) * p;
+
+        const T alpha = absolute_residual / (trans(p) * Ap);
+        x += alpha * p;
+        r -= alpha * Ap;
+
+        absolute_residual = trans(r) * r;
+
+        if(tag.do_log()) {
+            tag.log_residual(absolute_residual / absolute_residual_0);
+        }
+
+        if(tag.terminateIteration(iteration, absolute_residual, absolute_residual / absolute_residual_0)) {
+            break;
+        }
+
+        const T beta = absolute_residual / absolute_residual_prev;
+        p = r + beta * p;
+
+        ++iteration;
+    }
+}
+
+template<typename T, std::size_t N, bool SO>
+void solve_impl(
+        StaticVector<T, N> &x,
+        const StaticMatrix<T, N, N, SO> &A,
+        const StaticVector<T, N> &b,
+        BiCGSTABTag &tag)
+{
+
+    StaticVector<T, N> r(b - A * x);
+    StaticVector<T, N> p(r);
+    StaticVector<T, N> v(r);
+    const StaticVector<T, N> r0(r);
+    StaticVector<T, N> s;
+    StaticVector<T, N> t;
+    StaticVector<T, N> error;
+
+    const T absolute_residual_0 = trans(r) * r;
+    T absolute_residual = absolute_residual_0;
+
+    if(absolute_residual_0 == T(0)) {
+        tag.terminateIteration(0, 0.0, 0.0);
+        return;
+    }
+
+    T rho_prev = T(1);
+    T w = T(1);
+    T alpha = T(1);
+
+    std::size_t iteration{0};
+    tag.reserve_log(tag.maximumIterations() + 2);
+    while(true) {
+
+        const T rho = trans(r0) * r;
+        const T beta = (rho * alpha) / (rho_prev * w);
+
+        p = r + beta * (p - w * v);
+        v = A * p;
+        alpha = rho / (trans(r0) * v);
+
+        s = r - alpha * v;
+        t = A * s;
+
+        // t is zero if s is, i.e. if the solution is exact
+        const T t_dot_t = trans(t) * t;
+        w = t_dot_t == T(0) ? T(0) : T(trans(t) * s) / t_dot_t;
+
+        x += alpha * p + w * s;
+
+        error = b - A * x;
+        absolute_residual = trans(error) * error;
+        const T relative_residual = absolute_residual / absolute_residual_0;
+        if(tag.do_log()) {
+            tag.log_residual(relative_residual);
+        }
+
+        if(tag.terminateIteration(iteration, absolute_residual, relative_residual)) {
+            break;
+        }
+
+        r = s - w * t;
+        rho_prev = rho;
+
+        ++iteration;
+    }
+}
+
+} //end namespace detail
+
+ITERATIVE_NAMESPACE_CLOSE
+BLAZE_NAMESPACE_CLOSE
+
+#endif //BLAZE_ITERATIVE_STATICSOLVERS_HPP
@@ -7,10 +7,15 @@
 #ifndef BLAZE_ITERATIVE_SOLVERS_HPP
 #define BLAZE_ITERATIVE_SOLVERS_HPP
 
+#include "SolverSetup.hpp"
 #include "ConjugateGradientTag.hpp"
 #include "ConjugateGradient.hpp"
 #include "BiCGSTABTag.hpp"
 #include "BiCGSTAB.hpp"
+#include "BiCGSTABlTag.hpp"
+#include "BiCGSTABl.hpp"
+#include "IDRsTag.hpp"
+#include "IDRs.hpp"
 #include "PreconditionBiCGSTABTag.hpp"
 #include "PreconditionBiCGSTAB.hpp"
 #include "Arnoldi.hpp"
@@ -19,7 +24,20 @@
 #include "PreconditionCGTag.hpp"
 #include "LanczosTag.hpp"
 #include "Lanczos.hpp"
+#include "LOBPCGTag.hpp"
+#include "LOBPCG.hpp"
 #include "GMRES.hpp"
 #include "GMRESTag.hpp"
+#include "MINRESTag.hpp"
+#include "MINRES.hpp"
+#include "DeflatedCGTag.hpp"
+#include "DeflatedCG.hpp"
+#include "GCRODRTag.hpp"
+#include "GCRODR.hpp"
+#include "FGMRESTag.hpp"
+#include "FGMRES.hpp"
+#include "AutoTag.hpp"
+#include "Auto.hpp"
+#include "StaticSolvers.hpp"
 
 #endif //BLAZE_ITERATIVE_SOLVERS_HPP
@@ -0,0 +1,241 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Checks that the iteration loops of the solvers do not allocate. Every
+// solver runs twice with the same setup, once with few and once with many
+// iterations; all heap allocations are counted, and the counts of both
+// runs must agree, i.e. the extra iterations allocated nothing.
+
+#include "BlazeIterative.hpp"
+#include <dlfcn.h>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+using namespace blaze;
+using namespace blaze::iterative;
+
+namespace {
+
+bool counting = false;
+std::size_t allocations = 0;
+std::size_t allocated_bytes = 0;
+
+void count(std::size_t size)
+{
+    if(counting) {
+        ++allocations;
+        allocated_bytes += size;
+    }
+}
+
+void *allocate(std::size_t size)
+{
+    count(size);
+    void *p = std::malloc(size ? size : 1);
+    if(!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void *allocate_aligned(std::size_t size, std::size_t alignment)
+{
+    void *p = nullptr;
+    if(posix_memalign(&p, alignment < sizeof(void *) ? sizeof(void *) : alignment, size ? size : 1) != 0) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+} // namespace
+
+// Blaze allocates its vectors and matrices with posix_memalign or aligned_alloc
+extern "C" int posix_memalign(void **p, std::size_t alignment, std::size_t size)
+{
+    using function = int (*)(void **, std::size_t, std::size_t);
+    static function next = reinterpret_cast<function>(dlsym(RTLD_NEXT, "posix_memalign"));
+    count(size);
+    return next(p, alignment, size);
+}
+
+extern "C" void *aligned_alloc(std::size_t alignment, std::size_t size)
+{
+    using function = void *(*)(std::size_t, std::size_t);
+    static function next = reinterpret_cast<function>(dlsym(RTLD_NEXT, "aligned_alloc"));
+    count(size);
+    return next(alignment, size);
+}
+
+void *operator new(std::size_t size) { return allocate(size); }
+void *operator new[](std::size_t size) { return allocate(size); }
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept { return std::malloc(size ? size : 1); }
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept { return std::malloc(size ? size : 1); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+#if __cpp_aligned_new
+void *operator new(std::size_t size, std::align_val_t alignment) { return allocate_aligned(size, std::size_t(alignment)); }
+void *operator new[](std::size_t size, std::align_val_t alignment) { return allocate_aligned(size, std::size_t(alignment)); }
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+#endif
+
+struct AllocationCount
+{
+    std::size_t allocations;
+    std::size_t bytes;
+};
+
+// Allocations of one call to solve, which sets the iteration budget itself
+template<typename Solve>
+AllocationCount measure(Solve solve, std::size_t iterations)
+{
+    allocations = 0;
+    allocated_bytes = 0;
+    counting = true;
+    solve(iterations);
+    counting = false;
+    return {allocations, allocated_bytes};
+}
+
+template<typename Solve>
+bool check(const std::string &name, Solve solve)
+{
+    // Warm up lazily initialized libraries (BLAS, OpenMP) and size the outputs
+    solve(3);
+    solve(12);
+
+    const AllocationCount few = measure(solve, 3);
+    const AllocationCount many = measure(solve, 12);
+
+    std::cout << "  " << name << ": " << few.allocations << " allocations, " << few.bytes
+              << " bytes per solve, " << long(many.allocations) - long(few.allocations)
+              << " allocations in 9 more iterations" << std::endl;
+
+    return many.allocations == few.allocations;
+}
+
+template<typename TagType>
+void configure(TagType &tag, std::size_t iterations)
+{
+    tag.maximumIterations() = iterations;
+    tag.relativeResidualTolerance() = 0.0;   // never converge, run all iterations
+    tag.do_log() = true;
+}
+
+int main() {
+
+    const std::size_t N = 60;
+
+    CompressedMatrix<double,rowMajor> S(N, N);
+    DynamicMatrix<double,rowMajor> D(N, N, 0.0);
+    DynamicMatrix<double,rowMajor> U(N, N, 0.0);
+    S.reserve(3*N);
+    for(std::size_t i=0; i<N; ++i) {
+        if(i > 0) { S.append(i, i-1, -1.0); D(i,i-1) = -1.0; U(i,i-1) = -1.2; }
+        S.append(i, i, 2.5); D(i,i) = 2.5; U(i,i) = 3.0;
+        if(i+1 < N) { S.append(i, i+1, -1.0); D(i,i+1) = -1.0; U(i,i+1) = -0.6; }
+        S.finalize(i);
+    }
+    DynamicVector<double> b(N);
+    for(std::size_t i=0; i<N; ++i) {
+        b[i] = 1.0 + std::sin(0.7*i);
+    }
+    DynamicVector<double> x(N);
+    DynamicVector<double> eigenvalues;
+
+    bool pass = true;
+
+    pass &= check("CG", [&](std::size_t iterations) {
+        ConjugateGradientTag tag;
+        configure(tag, iterations);
+        reset(x);
+        solve_inplace(x, S, b, tag);
+    });
+
+    pass &= check("BiCGSTAB", [&](std::size_t iterations) {
+        BiCGSTABTag tag;
+        configure(tag, iterations);
+        reset(x);
+        solve_inplace(x, S, b, tag);
+    });
+
+    pass &= check("GMRES", [&](std::size_t iterations) {
+        GMRESTag tag;
+        configure(tag, iterations);
+        tag.restart() = 5;
+        reset(x);
+        solve_inplace(x, S, b, tag);
+    });
+
+    pass &= check("FGMRES", [&](std::size_t iterations) {
+        FGMRESTag tag;
+        configure(tag, iterations);
+        tag.restart() = 5;
+        reset(x);
+        solve_inplace(x, S, b, tag);
+    });
+
+    pass &= check("Deflated CG", [&](std::size_t iterations) {
+        DeflatedCGTag tag;
+        configure(tag, iterations);
+        reset(x);
+        solve_inplace(x, S, b, tag);   // the second solve deflates with the recycled space
+        reset(x);
+        solve_inplace(x, S, b, tag);
+    });
+
+    pass &= check("GCRO-DR", [&](std::size_t iterations) {
+        GCRODRTag tag;
+        configure(tag, iterations);
+        tag.restart() = 5;
+        tag.recycleSize() = 2;
+        reset(x);
+        solve_inplace(x, S, b, tag);   // every cycle after the first recycles the harmonic Ritz vectors
+    });
+
+    pass &= check("Preconditioned CG", [&](std::size_t iterations) {
+        PreconditionCGTag tag;
+        configure(tag, iterations);
+        reset(x);
+        solve_inplace(x, D, b, tag, "incomplete_Cholesky");
+    });
+
+    pass &= check("Preconditioned BiCGSTAB", [&](std::size_t iterations) {
+        PreconditionBiCGSTABTag tag;
+        configure(tag, iterations);
+        reset(x);
+        solve_inplace(x, U, b, tag, "LU");
+    });
+
+    pass &= check("Lanczos", [&](std::size_t iterations) {
+        LanczosTag tag;
+        eigenvalues.resize(iterations);
+        solve_inplace(eigenvalues, S, b, tag, iterations);
+    });
+
+    pass &= check("Arnoldi", [&](std::size_t iterations) {
+        ArnoldiTag tag;
+        eigenvalues.resize(iterations);
+        solve_inplace(eigenvalues, D, b, tag, iterations);
+    });
+
+
+    if (pass){
+        std::cout << " Pass test of Allocations" << std::endl;
+        return EXIT_SUCCESS;
+    } else{
+        std::cout << "Fail test of Allocations" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+}
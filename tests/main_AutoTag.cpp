@@ -0,0 +1,117 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "BlazeIterative.hpp"
+#include <iostream>
+#include <cstdlib>
+
+using namespace blaze;
+using namespace blaze::iterative;
+
+int main() {
+
+    const std::size_t N = 40;
+
+    // Symmetric positive definite, diagonally dominant: CG
+    DynamicMatrix<double> A(N, N, 0.0);
+    for(std::size_t i=0; i<N; ++i) {
+        A(i,i) = 4.0;
+        if(i > 0) A(i,i-1) = -1.0;
+        if(i+1 < N) A(i,i+1) = -1.0;
+    }
+
+    // Nonsymmetric (convection-diffusion like): BiCGSTAB
+    DynamicMatrix<double> B(N, N, 0.0);
+    for(std::size_t i=0; i<N; ++i) {
+        B(i,i) = 4.0;
+        if(i > 0) B(i,i-1) = -1.5;
+        if(i+1 < N) B(i,i+1) = -0.5;
+    }
+
+    DynamicVector<double> b(N);
+    for(std::size_t i=0; i<N; ++i) {
+        b[i] = 1.0 + 0.01*i;
+    }
+
+    AutoTag tag;
+    tag.relativeResidualTolerance() = 1e-12;
+    tag.maximumIterations() = 500;
+
+    auto x1 = solve(A, b, tag);
+    bool pass = tag.decision().solver == AutoSolver::CG && tag.decision().symmetric
+                && !tag.decision().from_cache;
+    double error = norm(A*x1 - b);
+
+    auto x2 = solve(B, b, tag);
+    pass = pass && tag.decision().solver == AutoSolver::BICGSTAB && !tag.decision().symmetric;
+    error += norm(B*x2 - b);
+
+    // Same matrix again: the decision comes from the cache
+    auto x3 = solve(A, b, tag);
+    pass = pass && tag.decision().from_cache && tag.cacheSize() == 2;
+    error += norm(x3 - x1);
+
+    // A slightly changed A (the next step of a time integration) reuses the decision
+    DynamicMatrix<double> A2(A);
+    for(std::size_t i=0; i<N; ++i) {
+        A2(i,i) = 4.001;
+    }
+    auto x6 = solve(A2, b, tag);
+    pass = pass && tag.decision().from_cache && tag.decision().solver == AutoSolver::CG && tag.cacheSize() == 2;
+    error += norm(A2*x6 - b);
+
+    // ... unless only identical matrices may share a decision
+    AutoTag exact;
+    exact.exactFingerprint() = true;
+    exact.relativeResidualTolerance() = 1e-12;
+    exact.maximumIterations() = 500;
+    solve(A, b, exact);
+    solve(A2, b, exact);
+    pass = pass && !exact.decision().from_cache && exact.cacheSize() == 2;
+
+    // The cache keeps the most recently used decisions only
+    AutoTag bounded;
+    bounded.cacheCapacity() = 3;
+    bounded.relativeResidualTolerance() = 1e-12;
+    bounded.maximumIterations() = 500;
+    for(std::size_t k=0; k<6; ++k) {
+        DynamicMatrix<double> Ak(A);
+        for(std::size_t i=0; i<N; ++i) {
+            Ak(i,i) = 2.5*(k + 1);
+        }
+        auto xk = solve(Ak, b, bounded);
+        pass = pass && !bounded.decision().from_cache && bounded.cacheSize() == std::min<std::size_t>(k + 1, 3);
+        error += norm(Ak*xk - b);
+    }
+
+    // Symmetric indefinite (A shifted into its spectrum): MINRES
+    DynamicMatrix<double> C(A);
+    for(std::size_t i=0; i<N; ++i) {
+        C(i,i) = 0.5;
+    }
+    auto x5 = solve(C, b, tag);
+    pass = pass && tag.decision().solver == AutoSolver::MINRES && tag.decision().symmetric;
+    error += norm(C*x5 - b);
+
+    // The trial race has to pick a solver that converges as well
+    AutoTag race;
+    race.trialRace() = true;
+    race.relativeResidualTolerance() = 1e-12;
+    race.maximumIterations() = 500;
+    auto x4 = solve(B, b, race);
+    pass = pass && race.decision().from_trial;
+    error += norm(B*x4 - b);
+
+
+    if (pass && error < EPSILON){
+        std::cout << " Pass test of AutoTag" << std::endl;
+        return EXIT_SUCCESS;
+    } else{
+        std::cout << "Fail test of AutoTag" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+}
@@ -0,0 +1,77 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "BlazeIterative.hpp"
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+
+using namespace blaze;
+using namespace blaze::iterative;
+
+int main() {
+
+    // Test the batched solve: systems of different size and conditioning
+    // converge after different numbers of iterations
+
+    std::size_t batch = 24;
+    std::vector<DynamicMatrix<double,false>> A(batch);
+    std::vector<DynamicVector<double>> b(batch);
+    std::vector<DynamicVector<double>> x1(batch);
+
+    for(std::size_t k=0; k<batch; ++k) {
+        std::size_t N = 10 + 3*k;
+        A[k].resize(N, N);
+        reset(A[k]);
+        x1[k].resize(N);
+        for(std::size_t i=0; i<N; ++i) {
+            A[k](i,i) = 2.0 + 1.0/(1+k);
+            if(i > 0) {
+                A[k](i,i-1) = -1.0;
+            }
+            if(i+1 < N) {
+                A[k](i,i+1) = -1.0;
+            }
+            x1[k][i] = 0.1*i - 0.05*k;
+        }
+        b[k] = A[k]*x1[k];
+    }
+
+    GMRESTag tag;
+    tag.do_log() = true;
+    tag.relativeResidualTolerance() = 1e-12;
+    tag.maximumIterations() = 1000;
+
+    std::vector<SolveJob<DynamicMatrix<double,false>, GMRESTag>> jobs;
+    for(std::size_t k=0; k<batch; ++k) {
+        jobs.emplace_back(A[k], b[k], tag);
+    }
+
+    ThreadPool pool(4, 1);
+    auto futures = solve_batch(pool, jobs);
+
+    double error = 0.0;
+    bool pass = true;
+    for(std::size_t k=0; k<batch; ++k) {
+        auto result = futures[k].get();
+        error += norm(result.x - x1[k]);
+        pass = pass && result.status == TerminationStatus::CONVERGED_RELATIVE_RESIDUAL
+               && !result.convergence_history.empty();
+    }
+
+    // The shared tag is only copied, never modified
+    pass = pass && tag.convergence_history().empty();
+
+
+    if (pass && error < EPSILON){
+        std::cout << " Pass test of BatchSolve" << std::endl;
+        return EXIT_SUCCESS;
+    } else{
+        std::cout << "Fail test of BatchSolve" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+}
@@ -0,0 +1,86 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "BlazeIterative.hpp"
+#include <iostream>
+#include <cstdlib>
+
+using namespace blaze;
+using namespace blaze::iterative;
+
+template<typename TagType>
+double batched_error(const BatchedMatrix<double> &A, const BatchedVector<double> &b,
+                     const BatchedVector<double> &x1, TagType &tag, bool &pass)
+{
+    BatchedSolveStatus result;
+    BatchedVector<double> x2 = solve_batched(A, b, tag, result);
+
+    double error = 0.0;
+    for(std::size_t k=0; k<A.size(); ++k) {
+        error = std::max(error, norm(x2.system(k) - x1.system(k)));
+        pass = pass && result.status[k] == TerminationStatus::CONVERGED_RELATIVE_RESIDUAL
+               && result.iterations[k] > 0;
+    }
+    return error;
+}
+
+int main() {
+
+    // Test the SIMD-across-systems solvers on a batch whose size is not a
+    // multiple of the lane width, with differently conditioned systems
+
+    std::size_t count = 1003;
+    std::size_t N = 6;
+    BatchedMatrix<double> A(count, N);
+    BatchedVector<double> b(count, N);
+    BatchedVector<double> x1(count, N);
+
+    for(std::size_t k=0; k<count; ++k) {
+        DynamicMatrix<double> Ak(N, N, 0.0);
+        DynamicVector<double> xk(N);
+        for(std::size_t i=0; i<N; ++i) {
+            Ak(i,i) = 2.0 + (k % 17)*0.5;
+            if(i > 0) {
+                Ak(i,i-1) = -1.0;
+            }
+            if(i+1 < N) {
+                Ak(i,i+1) = -1.0;
+            }
+            xk[i] = 0.1*i + 0.001*k;
+        }
+        A.setSystem(k, Ak);
+        x1.setSystem(k, xk);
+        b.setSystem(k, DynamicVector<double>(Ak*xk));
+    }
+
+    bool pass = true;
+
+    ConjugateGradientTag cg_tag;
+    cg_tag.relativeResidualTolerance() = 1e-26;
+    cg_tag.maximumIterations() = 50;
+    double error = batched_error(A, b, x1, cg_tag, pass);
+
+    BiCGSTABTag bicgstab_tag;
+    bicgstab_tag.relativeResidualTolerance() = 1e-26;
+    bicgstab_tag.maximumIterations() = 50;
+    error += batched_error(A, b, x1, bicgstab_tag, pass);
+
+    GMRESTag gmres_tag;
+    gmres_tag.relativeResidualTolerance() = 1e-13;
+    gmres_tag.maximumIterations() = 200;
+    gmres_tag.restart() = 4;
+    error += batched_error(A, b, x1, gmres_tag, pass);
+
+
+    if (pass && error < EPSILON){
+        std::cout << " Pass test of BatchedSolve" << std::endl;
+        return EXIT_SUCCESS;
+    } else{
+        std::cout << "Fail test of BatchedSolve" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+}
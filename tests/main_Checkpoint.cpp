@@ -0,0 +1,104 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "BlazeIterative.hpp"
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace blaze;
+using namespace blaze::iterative;
+
+int main() {
+
+    // Test checkpoint/restart: a solve resumed from the last checkpoint
+    // of a complete solve has to reproduce its result bit by bit
+
+    std::size_t N = 40;
+    DynamicMatrix<double,false> A(N,N, 0.0);
+    DynamicMatrix<double,false> B(N,N, 0.0);
+    DynamicVector<double> b(N, 0.0);
+    for(std::size_t i=0; i<N; ++i) {
+        A(i,i) = 2.5;
+        B(i,i) = 4.0;
+        if(i > 0) {
+            A(i,i-1) = -1.0;
+            B(i,i-1) = -1.5;
+        }
+        if(i+1 < N) {
+            A(i,i+1) = -1.0;
+            B(i,i+1) = 0.7;
+        }
+        b[i] = 1.0 + 0.1*i;
+    }
+
+    bool pass = true;
+
+    // CG
+    {
+        ConjugateGradientTag tag;
+        tag.do_log() = true;
+        tag.checkpointFile() = "checkpoint_cg.bin";
+        tag.checkpointInterval() = 3;
+        tag.maximumIterations() = 100;
+        tag.relativeResidualTolerance() = 1e-24;
+        DynamicVector<double> x_full(N, 0.0);
+        solve_inplace(x_full, A, b, tag);
+
+        ConjugateGradientTag resumed;
+        resumed.do_log() = true;
+        resumed.checkpointFile() = "checkpoint_cg.bin";
+        resumed.checkpointInterval() = 3;
+        resumed.maximumIterations() = 100;
+        resumed.relativeResidualTolerance() = 1e-24;
+        resumed.resumeFromCheckpoint() = true;
+        DynamicVector<double> x_resumed(N, 0.0);
+        solve_inplace(x_resumed, A, b, resumed);
+
+        pass = pass && norm(x_full - x_resumed) == 0.0
+               && tag.convergence_history() == resumed.convergence_history()
+               && norm(A*x_full - b) < EPSILON*norm(b);
+        std::remove("checkpoint_cg.bin");
+    }
+
+    // Restarted GMRES, checkpointed in the middle of the restart cycles
+    {
+        GMRESTag tag;
+        tag.do_log() = true;
+        tag.checkpointFile() = "checkpoint_gmres.bin";
+        tag.checkpointInterval() = 4;
+        tag.maximumIterations() = 200;
+        tag.relativeResidualTolerance() = 1e-12;
+        std::size_t n = 6;
+        DynamicVector<double> x_full(N, 0.0);
+        solve_inplace(x_full, B, b, tag, n);
+
+        GMRESTag resumed;
+        resumed.do_log() = true;
+        resumed.checkpointFile() = "checkpoint_gmres.bin";
+        resumed.checkpointInterval() = 4;
+        resumed.maximumIterations() = 200;
+        resumed.relativeResidualTolerance() = 1e-12;
+        resumed.resumeFromCheckpoint() = true;
+        DynamicVector<double> x_resumed(N, 0.0);
+        solve_inplace(x_resumed, B, b, resumed, n);
+
+        pass = pass && norm(x_full - x_resumed) == 0.0
+               && tag.convergence_history() == resumed.convergence_history()
+               && norm(B*x_full - b) < EPSILON*norm(b);
+        std::remove("checkpoint_gmres.bin");
+    }
+
+
+    if (pass){
+        std::cout << " Pass test of Checkpoint" << std::endl;
+        return EXIT_SUCCESS;
+    } else{
+        std::cout << "Fail test of Checkpoint" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+}
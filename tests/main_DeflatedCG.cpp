@@ -0,0 +1,65 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "BlazeIterative.hpp"
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+
+using namespace blaze;
+using namespace blaze::iterative;
+
+int main() {
+
+    // Test deflated CG on a sequence of slowly changing SPD systems
+
+    std::size_t N = 100;
+    DeflatedCGTag tag;
+    tag.do_log() = true;
+    tag.maximumIterations() = 1000;
+    tag.relativeResidualTolerance() = 1e-28;
+
+    double error = 0.0;
+    bool converged = true;
+    std::size_t first_iterations = 0;
+    std::size_t last_iterations = 0;
+
+    for(int step=0; step<4; ++step) {
+        DynamicMatrix<double,false> A(N,N, 0.0);
+        for(int i=0; i<N; ++i) {
+            A(i,i) = 2.0 + 0.001*step;
+            if(i > 0) {
+                A(i,i-1) = -1.0;
+                A(i-1,i) = -1.0;
+            }
+        }
+        DynamicVector<double> x1(N);
+        for(int i=0; i<N; ++i) {
+            x1[i] = std::sin(0.1*i + step);
+        }
+        DynamicVector<double> b = A * x1;
+
+        std::size_t before = tag.convergence_history().size();
+        auto x2 = solve(A,b,tag);
+        std::size_t iterations = tag.convergence_history().size() - before;
+
+        if(step == 0) {
+            first_iterations = iterations;
+        }
+        last_iterations = iterations;
+        error += norm(x1 - x2) / norm(x1);
+        converged &= tag.status() == TerminationStatus::CONVERGED_RELATIVE_RESIDUAL;
+    }
+
+    // The recycled space must save iterations, not merely cost none
+    if (error < EPSILON && converged && last_iterations < first_iterations){
+        std::cout << " Pass test of Deflated CG" << std::endl;
+        return EXIT_SUCCESS;
+    } else{
+        std::cout << "Fail test of Deflated CG" << std::endl;
+        return EXIT_FAILURE;
+    }
+}
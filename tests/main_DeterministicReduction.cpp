@@ -0,0 +1,92 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "BlazeIterative.hpp"
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace blaze;
+using namespace blaze::iterative;
+
+void set_threads(int threads) {
+#ifdef _OPENMP
+    omp_set_num_threads(threads);
+#else
+    (void)threads;
+#endif
+}
+
+int main() {
+
+    // Long enough for the reductions to run in parallel: the 1D Laplacian plus a shift
+    const std::size_t N = 100000;
+    CompressedMatrix<double,rowMajor> A(N, N);
+    A.reserve(3*N);
+    for(std::size_t i=0; i<N; ++i) {
+        if(i > 0) A.append(i, i-1, -1.0);
+        A.append(i, i, 2.01);
+        if(i+1 < N) A.append(i, i+1, -1.0);
+        A.finalize(i);
+    }
+    DynamicVector<double> b(N);
+    for(std::size_t i=0; i<N; ++i) {
+        b[i] = 1.0 + std::sin(0.001*i) + 1e-3*std::cos(17.0*i);
+    }
+
+    bool pass = true;
+
+    // The deterministic kernel agrees with Blaze up to rounding
+    const double blaze_dot = trans(b)*b;
+    const double deterministic = detail::deterministic_dot(b, b);
+    pass &= std::abs(deterministic - blaze_dot) <= 1e-12*blaze_dot;
+
+    // Identical solutions and convergence histories for any number of threads
+    DynamicVector<double> x_cg, x_bicgstab;
+    std::vector<double> history_cg, history_bicgstab;
+    for(int threads : {1, 2, 3, 4}) {
+        set_threads(threads);
+
+        ConjugateGradientTag cg;
+        cg.reductionMode() = ReductionMode::DETERMINISTIC;
+        cg.do_log() = true;
+        cg.maximumIterations() = 1000;
+        auto x = solve(A, b, cg);
+
+        BiCGSTABTag bicgstab;
+        bicgstab.reductionMode() = ReductionMode::DETERMINISTIC;
+        bicgstab.do_log() = true;
+        bicgstab.maximumIterations() = 1000;
+        auto y = solve(A, b, bicgstab);
+
+        if(threads == 1) {
+            x_cg = x;
+            x_bicgstab = y;
+            history_cg = cg.convergence_history();
+            history_bicgstab = bicgstab.convergence_history();
+            pass &= cg.status() == TerminationStatus::CONVERGED_RELATIVE_RESIDUAL;
+            pass &= bicgstab.status() == TerminationStatus::CONVERGED_RELATIVE_RESIDUAL;
+        } else {
+            pass &= x == x_cg && y == x_bicgstab;
+            pass &= cg.convergence_history() == history_cg;
+            pass &= bicgstab.convergence_history() == history_bicgstab;
+        }
+    }
+
+    if (pass){
+        std::cout << " Pass test of DeterministicReduction" << std::endl;
+        return EXIT_SUCCESS;
+    } else{
+        std::cout << "Fail test of DeterministicReduction" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+}
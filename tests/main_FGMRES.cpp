@@ -0,0 +1,58 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "BlazeIterative.hpp"
+#include <iostream>
+#include <cstdlib>
+
+using namespace blaze;
+using namespace blaze::iterative;
+
+int main() {
+
+    // Test FGMRES with an inexact inner BiCGSTAB solve as preconditioner
+
+    std::size_t N = 50;
+    DynamicMatrix<double,false> A(N,N, 0.0);
+    for(int i=0; i<N; ++i) {
+        A(i,i) = 3.0;
+        if(i > 0) {
+            A(i,i-1) = -1.5;
+            A(i-1,i) = -0.5;
+        }
+    }
+    DynamicVector<double> x1(N);
+    for(int i=0; i<N; ++i) {
+        x1[i] = 0.1*(i%7);
+    }
+    DynamicVector<double> b = A * x1;
+
+    BiCGSTABTag inner_tag;
+    inner_tag.maximumIterations() = 2;
+
+    FGMRESTag tag;
+    tag.do_log() = true;
+    tag.restart() = 10;
+    tag.maximumIterations() = 200;
+    tag.relativeResidualTolerance() = 1e-12;
+    tag.preconditioner() = [&](DynamicVector<double> &z, const DynamicVector<double> &v) {
+        reset(z);
+        solve_inplace(z, A, v, inner_tag);
+    };
+
+    auto x2 = solve(A,b,tag);
+
+    auto error = norm(x1 - x2);
+
+    if (error < EPSILON){
+        std::cout << " Pass test of FGMRES" << std::endl;
+        return EXIT_SUCCESS;
+    } else{
+        std::cout << "Fail test of FGMRES" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+}
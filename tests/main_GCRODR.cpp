@@ -0,0 +1,67 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "BlazeIterative.hpp"
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+
+using namespace blaze;
+using namespace blaze::iterative;
+
+int main() {
+
+    // Test GCRO-DR on a sequence of slowly changing non-symmetric systems
+
+    std::size_t N = 100;
+    GCRODRTag tag;
+    tag.do_log() = true;
+    tag.maximumIterations() = 1000;
+    tag.relativeResidualTolerance() = 1e-10;
+    tag.restart() = 20;
+    tag.recycleSize() = 5;
+
+    double error = 0.0;
+    bool converged = true;
+    std::size_t first_iterations = 0;
+    std::size_t last_iterations = 0;
+
+    for(int step=0; step<4; ++step) {
+        DynamicMatrix<double,false> A(N,N, 0.0);
+        for(int i=0; i<N; ++i) {
+            A(i,i) = 2.0 + 0.001*step;
+            if(i > 0) {
+                A(i,i-1) = -1.2;
+                A(i-1,i) = -0.8;
+            }
+        }
+        DynamicVector<double> b(N);
+        for(int i=0; i<N; ++i) {
+            b[i] = std::cos(0.1*i + step);
+        }
+
+        std::size_t before = tag.convergence_history().size();
+        auto x = solve(A,b,tag);
+        std::size_t iterations = tag.convergence_history().size() - before;
+
+        if(step == 0) {
+            first_iterations = iterations;
+        }
+        last_iterations = iterations;
+        error += norm(b - A*x) / norm(b);
+        converged &= tag.status() == TerminationStatus::CONVERGED_RELATIVE_RESIDUAL;
+    }
+
+    // The recycled space must save iterations, not merely cost none
+    if (error < EPSILON && converged && last_iterations < first_iterations){
+        std::cout << " Pass test of GCRO-DR" << std::endl;
+        return EXIT_SUCCESS;
+    } else{
+        std::cout << "Fail test of GCRO-DR" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+}
@@ -0,0 +1,78 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "BlazeIterative.hpp"
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+
+using namespace blaze;
+using namespace blaze::iterative;
+
+int main() {
+
+    // Convection-diffusion on a 14 x 14 grid, upwind differences
+    const std::size_t G = 14;
+    const std::size_t N = G*G;
+    CompressedMatrix<double,rowMajor> A(N, N);
+    for(std::size_t i=0; i<N; ++i) {
+        A(i,i) = 4.0;
+        if(i%G != 0) { A(i,i-1) = -1.6; A(i-1,i) = -0.4; }
+        if(i >= G) { A(i,i-G) = -1.3; A(i-G,i) = -0.7; }
+    }
+    DynamicVector<double> b(N);
+    for(std::size_t i=0; i<N; ++i) {
+        b[i] = 1.0 + std::sin(0.1*i);
+    }
+
+    // Jacobi preconditioner
+    auto jacobi = [](DynamicVector<double> &z, const DynamicVector<double> &v) {
+        z = v / 4.0;
+    };
+
+    double error = 0.0;
+    bool pass = true;
+
+    for(const std::size_t s : {1, 4}) {
+        for(const bool preconditioned : {false, true}) {
+            IDRsTag tag;
+            tag.shadowSpaceDimension() = s;
+            tag.relativeResidualTolerance() = 1e-12;
+            tag.maximumIterations() = 400;
+            if(preconditioned) {
+                tag.preconditioner() = jacobi;
+            }
+            auto x = solve(A, b, tag);
+            error += norm(A*x - b);
+            pass &= tag.status() == TerminationStatus::CONVERGED_RELATIVE_RESIDUAL;
+        }
+    }
+
+    for(const std::size_t l : {1, 2, 4}) {
+        for(const bool preconditioned : {false, true}) {
+            BiCGSTABlTag tag;
+            tag.polynomialDegree() = l;
+            tag.relativeResidualTolerance() = 1e-12;
+            tag.maximumIterations() = 400;
+            if(preconditioned) {
+                tag.preconditioner() = jacobi;
+            }
+            auto x = solve(A, b, tag);
+            error += norm(A*x - b);
+            pass &= tag.status() == TerminationStatus::CONVERGED_RELATIVE_RESIDUAL;
+        }
+    }
+
+
+    if (pass && error < EPSILON){
+        std::cout << " Pass test of IDRs" << std::endl;
+        return EXIT_SUCCESS;
+    } else{
+        std::cout << "Fail test of IDRs" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+}
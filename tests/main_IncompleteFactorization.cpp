@@ -0,0 +1,89 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "BlazeIterative.hpp"
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+
+using namespace blaze;
+using namespace blaze::iterative;
+
+int main() {
+
+    // 2D Poisson problem, 5-point stencil on a 12 x 12 grid
+    const std::size_t G = 12;
+    const std::size_t N = G*G;
+    DynamicMatrix<double,rowMajor> A(N, N, 0.0);
+    for(std::size_t i=0; i<N; ++i) {
+        A(i,i) = 4.0;
+        if(i%G != 0) { A(i,i-1) = -1.0; A(i-1,i) = -1.0; }
+        if(i >= G) { A(i,i-G) = -1.0; A(i-G,i) = -1.0; }
+    }
+    DynamicVector<double> b(N);
+    for(std::size_t i=0; i<N; ++i) {
+        b[i] = 1.0 + std::sin(0.1*i);
+    }
+
+    // Without dropping ICT and ILUT are the complete factorizations
+    CompressedMatrix<double,rowMajor> U, L;
+    DynamicVector<double> d;
+    ict(A, 0.0, N, U, d);
+    DynamicMatrix<double,rowMajor> Dinv(N, N, 0.0);
+    for(std::size_t i=0; i<N; ++i) {
+        Dinv(i,i) = 1.0/d[i];
+    }
+    double error = maxNorm(DynamicMatrix<double,rowMajor>(trans(U)*Dinv*U) - A);
+
+    ilut(A, 0.0, N, L, U);
+    error += maxNorm(DynamicMatrix<double,rowMajor>(L*U) - A);
+
+    // The fill per row is bounded, and level 0 keeps the pattern of A
+    const std::size_t upper_A = (nonZeros(A) + N)/2;
+    ict(A, 0.0, 2, U, d);
+    bool pass = nonZeros(U) <= upper_A + 2*N;
+    ic0(A, U, d);
+    pass &= nonZeros(U) == upper_A;
+
+    // More fill, fewer iterations
+    std::size_t iterations_ic0 = 0;
+    std::size_t iterations_ict = 0;
+    for(const std::string preconditioner : {"incomplete_Cholesky", "ICT"}) {
+        PreconditionCGTag tag;
+        tag.relativeResidualTolerance() = 1e-20;
+        tag.maximumIterations() = 200;
+        tag.dropTolerance() = 1e-4;
+        tag.maximumFill() = 20;
+        tag.do_log() = true;
+        auto x = solve(A, b, tag, preconditioner);
+        error += norm(A*x - b);
+        (preconditioner == "ICT" ? iterations_ict : iterations_ic0) = tag.convergence_history().size();
+    }
+    pass &= iterations_ict < iterations_ic0;
+
+    // Convection-diffusion: nonsymmetric, solved with ILU(0) and ILUT
+    DynamicMatrix<double,rowMajor> C(A);
+    for(std::size_t i=0; i<N; ++i) {
+        if(i%G != 0) { C(i,i-1) = -1.4; C(i-1,i) = -0.6; }
+    }
+    for(const std::string preconditioner : {"ILU", "ILUT"}) {
+        PreconditionBiCGSTABTag tag;
+        tag.relativeResidualTolerance() = 1e-24;
+        tag.maximumIterations() = 200;
+        auto x = solve(C, b, tag, preconditioner);
+        error += norm(C*x - b);
+    }
+
+
+    if (pass && error < EPSILON){
+        std::cout << " Pass test of IncompleteFactorization" << std::endl;
+        return EXIT_SUCCESS;
+    } else{
+        std::cout << "Fail test of IncompleteFactorization" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+}
@@ -0,0 +1,90 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "BlazeIterative.hpp"
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+
+using namespace blaze;
+using namespace blaze::iterative;
+
+// Implicit Euler for the 1D heat equation with a time-dependent source: returns the total number of CG iterations
+std::size_t heat_equation(const CompressedMatrix<double,rowMajor> &A, InitialGuessProvider<double> *provider,
+                          double &error) {
+    const std::size_t N = A.rows();
+    const double dt = 0.002;
+
+    DynamicVector<double> u(N), b(N), x(N);
+    for(std::size_t i=0; i<N; ++i) {
+        u[i] = std::sin(M_PI*(i+1)/(N+1));
+    }
+
+    std::size_t iterations = 0;
+    for(std::size_t step=0; step<20; ++step) {
+        for(std::size_t i=0; i<N; ++i) {
+            b[i] = u[i] + dt*(1.0 + std::sin(0.5*step))*(1.0 + 3.0*i/N);
+        }
+
+        // CG measures its relative residual against the initial one, so converge on the absolute residual
+        ConjugateGradientTag tag;
+        tag.relativeResidualTolerance() = 0.0;
+        tag.absoluteResidualTolerance() = 1e-24;
+        tag.maximumIterations() = 1000;
+        tag.do_log() = true;
+        x = provider ? solve(A, b, tag, *provider) : solve(A, b, tag);
+
+        iterations += tag.convergence_history().size() - 1;
+        error += norm(A*x - b);
+        u = x;
+    }
+    return iterations;
+}
+
+int main() {
+
+    const std::size_t N = 100;
+    const double dt = 0.002;
+    CompressedMatrix<double,rowMajor> A(N, N);
+    for(std::size_t i=0; i<N; ++i) {
+        A(i,i) = 1.0 + 2.0*dt*N*N;
+        if(i > 0) { A(i,i-1) = -dt*N*N; A(i-1,i) = -dt*N*N; }
+    }
+
+    double error = 0.0;
+    bool pass = true;
+
+    const std::size_t zero_guess = heat_equation(A, nullptr, error);
+
+    for(InitialGuessMode mode : {InitialGuessMode::PROJECTION, InitialGuessMode::RIGHT_HAND_SIDES,
+                                 InitialGuessMode::EXTRAPOLATION}) {
+        InitialGuessProvider<double> provider(4, mode);
+        const std::size_t iterations = heat_equation(A, &provider, error);
+        pass &= iterations < zero_guess;
+        pass &= provider.size() == 4;
+    }
+
+    // The projection reproduces a solution of the span exactly
+    InitialGuessProvider<double> provider(2);
+    DynamicVector<double> x1(N, 1.0), x2(N), guess;
+    for(std::size_t i=0; i<N; ++i) {
+        x2[i] = std::cos(0.1*i);
+    }
+    const DynamicVector<double> b1 = A*x1, b2 = A*x2, x3 = 2.0*x1 - x2, b3 = A*x3;
+    provider.record(x1, b1);
+    provider.record(x2, b2);
+    provider.guess(guess, A, b3);
+    error += norm(guess - x3);
+
+    if (pass && error < EPSILON){
+        std::cout << " Pass test of InitialGuess" << std::endl;
+        return EXIT_SUCCESS;
+    } else{
+        std::cout << "Fail test of InitialGuess" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+}
@@ -0,0 +1,58 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "BlazeIterative.hpp"
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+
+using namespace blaze;
+using namespace blaze::iterative;
+
+int main() {
+
+    // 1D Laplacian, eigenvalues 2 - 2 cos(pi j / (N+1))
+    const std::size_t N = 40;
+    const std::size_t k = 4;
+    const double pi = std::acos(-1.0);
+    CompressedMatrix<double,rowMajor> A(N, N);
+    for(std::size_t i=0; i<N; ++i) {
+        A(i,i) = 2.0;
+        if(i > 0) { A(i,i-1) = -1.0; A(i-1,i) = -1.0; }
+    }
+    DynamicVector<double> b(N, 1.0);
+
+    double error = 0.0;
+    for(const bool largest : {false, true}) {
+        LOBPCGTag tag;
+        tag.largest() = largest;
+        tag.relativeResidualTolerance() = 1e-10;
+        tag.maximumIterations() = 500;
+        // Jacobi preconditioner
+        tag.preconditioner() = [](DynamicMatrix<double,columnMajor> &W, const DynamicMatrix<double,columnMajor> &R) {
+            W = 0.5 * R;
+        };
+        DynamicVector<double> lambda = solve(A, b, tag, k);
+
+        const auto &X = tag.eigenvectors();
+        for(std::size_t j=0; j<k; ++j) {
+            const double index = largest ? double(N - j) : double(j + 1);
+            error += std::abs(lambda[j] - (2.0 - 2.0*std::cos(pi*index/(N + 1))));
+            error += norm(A*column(X,j) - lambda[j]*column(X,j));
+        }
+        error += maxNorm(DynamicMatrix<double>(trans(X)*X) - IdentityMatrix<double>(k));
+    }
+
+
+    if (error < EPSILON){
+        std::cout << " Pass test of LOBPCG" << std::endl;
+        return EXIT_SUCCESS;
+    } else{
+        std::cout << "Fail test of LOBPCG" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+}
@@ -0,0 +1,66 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "BlazeIterative.hpp"
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+
+using namespace blaze;
+using namespace blaze::iterative;
+
+int main() {
+
+    // Saddle-point system [K B^T; B 0] with K the 1D Laplacian and B averaging pairs of unknowns
+    const std::size_t N = 40;
+    const std::size_t C = N/2;
+    CompressedMatrix<double,rowMajor> A(N + C, N + C);
+    for(std::size_t i=0; i<N; ++i) {
+        A(i,i) = 2.0;
+        if(i > 0) { A(i,i-1) = -1.0; A(i-1,i) = -1.0; }
+    }
+    for(std::size_t k=0; k<C; ++k) {
+        A(N+k, 2*k) = 0.5;   A(2*k, N+k) = 0.5;
+        A(N+k, 2*k+1) = 0.5; A(2*k+1, N+k) = 0.5;
+    }
+    DynamicVector<double> b(N + C);
+    for(std::size_t i=0; i<N+C; ++i) {
+        b[i] = 1.0 + std::sin(0.3*i);
+    }
+
+    double error = 0.0;
+    bool pass = true;
+
+    MINRESTag tag;
+    tag.relativeResidualTolerance() = 1e-12;
+    tag.maximumIterations() = 400;
+    auto x = solve(A, b, tag);
+    error += norm(A*x - b);
+    pass &= tag.status() == TerminationStatus::CONVERGED_RELATIVE_RESIDUAL;
+
+    // Block diagonal SPD preconditioner: diag(K) and the diagonal of the Schur complement B diag(K)^-1 B^T
+    MINRESTag preconditioned;
+    preconditioned.relativeResidualTolerance() = 1e-12;
+    preconditioned.maximumIterations() = 400;
+    preconditioned.preconditioner() = [N](DynamicVector<double> &z, const DynamicVector<double> &v) {
+        z = v;
+        subvector(z, 0, N) /= 2.0;
+        subvector(z, N, v.size() - N) *= 4.0;
+    };
+    auto y = solve(A, b, preconditioned);
+    error += norm(A*y - b);
+    pass &= preconditioned.status() == TerminationStatus::CONVERGED_RELATIVE_RESIDUAL;
+
+
+    if (pass && error < EPSILON){
+        std::cout << " Pass test of MINRES" << std::endl;
+        return EXIT_SUCCESS;
+    } else{
+        std::cout << "Fail test of MINRES" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+}
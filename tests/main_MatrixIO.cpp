@@ -0,0 +1,73 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "BlazeIterative.hpp"
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace blaze;
+using namespace blaze::iterative;
+
+int main() {
+
+    // Test Matrix Market input, binary CSR output and the memory-mapped operator
+
+    std::size_t N = 30;
+    {
+        // Symmetric tridiagonal matrix, only the lower triangle is stored
+        std::ofstream out("matrixio_test.mtx");
+        out << "%%MatrixMarket matrix coordinate real symmetric\n";
+        out << "% 1D Laplacian with a shift\n";
+        out << N << " " << N << " " << 2*N-1 << "\n";
+        for(std::size_t i=1; i<=N; ++i) {
+            out << i << " " << i << " 2.5\n";
+            if(i < N) {
+                out << i+1 << " " << i << " -1.0\n";
+            }
+        }
+    }
+
+    CompressedMatrix<double,rowMajor> A = read_matrix_market<double>("matrixio_test.mtx");
+    write_binary_csr("matrixio_test.csr", A);
+    MappedCSRMatrix<double> M("matrixio_test.csr");
+
+    DynamicVector<double> b(N, 0.0);
+    for(std::size_t i=0; i<N; ++i) {
+        b[i] = 1.0 + 0.1*i;
+    }
+
+    bool pass = A.nonZeros() == 3*N-2 && A(1,0) == -1.0 && A(0,1) == -1.0
+                && M.rows() == N && M.nonZeros() == A.nonZeros() && isSymmetric(M);
+
+    ConjugateGradientTag cg_tag;
+    cg_tag.relativeResidualTolerance() = 1e-24;
+    cg_tag.maximumIterations() = 100;
+    auto x_cg = solve(M, b, cg_tag);
+
+    GMRESTag gmres_tag;
+    gmres_tag.relativeResidualTolerance() = 1e-12;
+    gmres_tag.maximumIterations() = 200;
+    auto x_gmres = solve(M, b, gmres_tag);
+
+    auto x_ref = solve(A, b, gmres_tag);
+
+    auto error = norm(x_cg - x_ref) + norm(x_gmres - x_ref) + norm(A*x_ref - b);
+
+    std::remove("matrixio_test.mtx");
+    std::remove("matrixio_test.csr");
+
+
+    if (pass && error < EPSILON){
+        std::cout << " Pass test of MatrixIO" << std::endl;
+        return EXIT_SUCCESS;
+    } else{
+        std::cout << "Fail test of MatrixIO" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+}
@@ -0,0 +1,79 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "BlazeIterative.hpp"
+#include <iostream>
+#include <cstdlib>
+#include <limits>
+
+using namespace blaze;
+using namespace blaze::iterative;
+
+int main() {
+
+    // Test GMRES and Arnoldi with a single precision Krylov basis against
+    // the full precision basis. The basis is rounded to float, so the
+    // results agree to single precision only (see docs/GMRES.md).
+    const double tolerance = 1e-5;
+
+    std::size_t N = 30;
+    DynamicMatrix<double,false> A(N,N, 0.0);
+    for(int i=0; i<N; ++i) {
+        A(i,i) = 4.0 + 0.1*i;
+        if(i > 0) {
+            A(i,i-1) = -1.0;
+            A(i-1,i) = -0.5;
+        }
+    }
+    DynamicVector<double> b(N);
+    for(int i=0; i<N; ++i) {
+        b[i] = 1.0 + 0.01*i;
+    }
+
+    GMRESTag tag_full;
+    tag_full.maximumIterations() = 100;
+    auto x_full = solve(A,b,tag_full,N);
+
+    GMRESTag tag_single;
+    tag_single.maximumIterations() = 100;
+    tag_single.basisPrecision() = BasisPrecision::SINGLE;
+    auto x_single = solve(A,b,tag_single,N);
+
+    auto error_gmres = norm(x_full - x_single) / norm(x_full);
+
+    // The single precision run must converge on its own, not just agree with the full one.
+    // Rounding the basis adds about float epsilon to the residual GMRES estimates.
+    bool pass = tag_full.status() == TerminationStatus::CONVERGED_RELATIVE_RESIDUAL
+                && tag_single.status() == TerminationStatus::CONVERGED_RELATIVE_RESIDUAL;
+    const double residual_single = norm(A*x_single - b) / norm(b);
+    pass &= residual_single < tag_single.relativeResidualTolerance() + 2.0*std::numeric_limits<float>::epsilon();
+
+    // Arnoldi: compare the largest Ritz value of an 8-dimensional Krylov space
+    DynamicMatrix<double,false> S(N,N, 0.0);
+    for(int i=0; i<N; ++i) {
+        S(i,i) = 1.0 + i;
+    }
+    DynamicVector<double> v(N, 1.0);
+    std::size_t n = 8;
+
+    ArnoldiTag arnoldi_full;
+    DynamicVector<double> w_full = solve(S,v,arnoldi_full,n);
+
+    ArnoldiTag arnoldi_single;
+    arnoldi_single.basisPrecision() = BasisPrecision::SINGLE;
+    DynamicVector<double> w_single = solve(S,v,arnoldi_single,n);
+
+    auto error_arnoldi = std::abs(max(w_full) - max(w_single)) / max(w_full);
+
+    if (pass && error_gmres < tolerance && error_arnoldi < tolerance){
+        std::cout << " Pass test of reduced precision Krylov basis" << std::endl;
+        return EXIT_SUCCESS;
+    } else{
+        std::cout << "Fail test of reduced precision Krylov basis" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+}
@@ -0,0 +1,97 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "BlazeIterative.hpp"
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+
+using namespace blaze;
+using namespace blaze::iterative;
+
+// Distance from the eigenvalue closest to the shift to the nearest computed value
+double distance(const DynamicVector<double> &lambda, double exact) {
+    double d = std::abs(lambda[0] - exact);
+    for(std::size_t i=1; i<lambda.size(); ++i) {
+        d = std::min(d, std::abs(lambda[i] - exact));
+    }
+    return d;
+}
+
+int main() {
+
+    // 1D Laplacian, eigenvalues 2 - 2 cos(pi j / (N+1)); sigma lies inside the spectrum
+    const std::size_t N = 60;
+    const double sigma = 0.7;
+    const double pi = std::acos(-1.0);
+    CompressedMatrix<double,rowMajor> A(N, N);
+    for(std::size_t i=0; i<N; ++i) {
+        A(i,i) = 2.0;
+        if(i > 0) { A(i,i-1) = -1.0; A(i-1,i) = -1.0; }
+    }
+    DynamicVector<double> b(N, 1.0);
+
+    double closest = 2.0;
+    for(std::size_t j=1; j<=N; ++j) {
+        const double lambda = 2.0 - 2.0*std::cos(pi*j/(N + 1));
+        if(std::abs(lambda - sigma) < std::abs(closest - sigma)) {
+            closest = lambda;
+        }
+    }
+
+    double error = 0.0;
+
+    // Sparse factorization, Lanczos and Arnoldi
+    ShiftInvertOperator<double> S(A, sigma);
+    LanczosTag lanczos;
+    error += distance(solve(S, b, lanczos, 12), closest);
+    ArnoldiTag arnoldi;
+    error += distance(solve(S, b, arnoldi, 12), closest);
+
+    // Dense factorization
+    DynamicMatrix<double,rowMajor> D(A);
+    ShiftInvertOperator<double> SD(D, sigma);
+    error += distance(solve(SD, b, lanczos, 12), closest);
+
+    // Inner GMRES solves of the indefinite shifted system
+    GMRESTag inner;
+    inner.restart() = N;
+    inner.relativeResidualTolerance() = 1e-13;
+    ShiftInvertOperator<double> SK(A, sigma, inner);
+    error += distance(solve(SK, b, lanczos, 12), closest);
+
+    // sigma = A(0,0): the first pivot of the unpivoted factorization vanishes, so the band LU pivots
+    const double diagonal = 2.0;
+    double closest_to_diagonal = 0.0;
+    for(std::size_t j=1; j<=N; ++j) {
+        const double lambda = 2.0 - 2.0*std::cos(pi*j/(N + 1));
+        if(std::abs(lambda - diagonal) < std::abs(closest_to_diagonal - diagonal)) {
+            closest_to_diagonal = lambda;
+        }
+    }
+    ShiftInvertOperator<double> SP(A, diagonal);
+    bool pass = SP.pivoted() && !S.pivoted();
+    error += distance(solve(SP, b, lanczos, 12), closest_to_diagonal);
+    ArnoldiTag arnoldi_pivoted;
+    error += distance(solve(SP, b, arnoldi_pivoted, 12), closest_to_diagonal);
+
+    // The pivoted operator applies the same inverse as the dense one
+    ShiftInvertOperator<double> SPD(D, diagonal);
+    DynamicVector<double> y1, y2;
+    multiply(y1, SP, b);
+    multiply(y2, SPD, b);
+    error += norm(y1 - y2)/norm(y2);
+
+
+    if (pass && error < EPSILON){
+        std::cout << " Pass test of ShiftInvert" << std::endl;
+        return EXIT_SUCCESS;
+    } else{
+        std::cout << "Fail test of ShiftInvert" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+}
@@ -0,0 +1,108 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "BlazeIterative.hpp"
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+
+using namespace blaze;
+using namespace blaze::iterative;
+
+int main() {
+
+    // Symmetric matrix with irregular row lengths: 1D Laplacian plus long-range couplings
+    const std::size_t N = 203;
+    DynamicMatrix<double,rowMajor> D(N, N, 0.0);
+    for(std::size_t i=0; i<N; ++i) {
+        D(i,i) = 4.0;
+        if(i > 0) { D(i,i-1) = -1.0; D(i-1,i) = -1.0; }
+        for(std::size_t k=1; k<=i%7; ++k) {
+            const std::size_t j = (i*k*31) % N;
+            if(j != i) { D(i,j) = -0.1; D(j,i) = -0.1; }
+        }
+    }
+    for(std::size_t i=0; i<N; ++i) {
+        D(i,i) = 1.0 + sum(abs(row(D,i)));
+    }
+    CompressedMatrix<double,rowMajor> A(D);
+
+    DynamicVector<double> x(N);
+    for(std::size_t i=0; i<N; ++i) {
+        x[i] = std::sin(0.3*i);
+    }
+
+    // The product agrees with CSR for every chunk height and sorting window
+    DynamicVector<double> y;
+    double error = 0.0;
+    for(std::size_t sigma : {1, 16, 1024}) {
+        SlicedEllpackOperator<double, 8> S8(A, sigma);
+        SlicedEllpackOperator<double, 4> S4(A, sigma);
+        multiply(y, S8, x);
+        error += norm(y - A*x);
+        multiply(y, S4, x);
+        error += norm(y - A*x);
+    }
+
+    // Padding of an empty row
+    CompressedMatrix<double,rowMajor> E(A);
+    E.reset(5);
+    SlicedEllpackOperator<double> SE(E);
+    multiply(y, SE, x);
+    error += norm(y - E*x);
+
+    SlicedEllpackOperator<double> S(A);
+    bool pass = S.nonZeros() == nonZeros(A) && S.storedEntries() >= S.nonZeros()
+                && S.matrix() == A && isSymmetric(S) && S.indexBytes() == 4;
+
+    // Solve with the operator and with the matrix
+    DynamicVector<double> b(N, 1.0);
+    ConjugateGradientTag cg_tag;
+    cg_tag.relativeResidualTolerance() = 1e-24;
+    cg_tag.maximumIterations() = 200;
+    auto x1 = solve(S, b, cg_tag);
+    auto x2 = solve(A, b, cg_tag);
+    error += norm(x1 - x2);
+
+    BiCGSTABTag bicgstab_tag;
+    bicgstab_tag.relativeResidualTolerance() = 1e-24;
+    bicgstab_tag.maximumIterations() = 200;
+    auto x3 = solve(S, b, bicgstab_tag);
+    error += norm(x3 - x2);
+
+    GMRESTag gmres_tag;
+    gmres_tag.relativeResidualTolerance() = 1e-12;
+    gmres_tag.maximumIterations() = 500;
+    auto x4 = solve(S, b, gmres_tag);
+    error += norm(x4 - x2);
+
+    // The recycling solvers apply the operator to their recycled spaces as well: solve twice
+    GCRODRTag gcrodr_tag;
+    gcrodr_tag.relativeResidualTolerance() = 1e-12;
+    gcrodr_tag.maximumIterations() = 500;
+    gcrodr_tag.restart() = 20;
+    gcrodr_tag.recycleSize() = 5;
+    DeflatedCGTag deflated_tag;
+    deflated_tag.relativeResidualTolerance() = 1e-24;
+    deflated_tag.maximumIterations() = 200;
+    for(int solve_count=0; solve_count<2; ++solve_count) {
+        auto x5 = solve(S, b, gcrodr_tag);
+        error += norm(x5 - x2);
+        auto x6 = solve(S, b, deflated_tag);
+        error += norm(x6 - x2);
+    }
+    pass &= gcrodr_tag.recycledSpace().columns() > 0 && deflated_tag.recycledSpace().columns() > 0;
+
+
+    if (pass && error < EPSILON){
+        std::cout << " Pass test of SlicedEllpackOperator" << std::endl;
+        return EXIT_SUCCESS;
+    } else{
+        std::cout << "Fail test of SlicedEllpackOperator" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+}
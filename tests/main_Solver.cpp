@@ -0,0 +1,71 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "BlazeIterative.hpp"
+#include <iostream>
+#include <cstdlib>
+
+using namespace blaze;
+using namespace blaze::iterative;
+
+int main() {
+
+    // Test reusable Solver objects with several right-hand sides
+
+    std::size_t N = 10;
+    DynamicMatrix<double,false> A(N,N, 0.0);
+    for(int i=0; i<N; ++i) {
+        A(i,i) = 4.0;
+        if(i > 0) {
+            A(i,i-1) = -1.0;
+            A(i-1,i) = -1.0;
+        }
+    }
+
+    PreconditionCGTag tag;
+    tag.maximumIterations() = 100;
+    tag.relativeResidualTolerance() = 1e-24;
+    auto solver = make_solver(A, tag, "SSOR");
+    solver.setup();
+
+    double error = 0.0;
+    for(int k=1; k<=3; ++k) {
+        DynamicVector<double> x1(N);
+        for(int i=0; i<N; ++i) {
+            x1[i] = k + 0.1*i;
+        }
+        DynamicVector<double> b = A * x1;
+
+        auto x2 = solver.solve(b);
+        error += norm(x1 - x2);
+    }
+
+    // New values on the same pattern
+    DynamicMatrix<double,false> A2 = 2.0 * A;
+    solver.update_values(A2);
+    DynamicVector<double> x1(N, 1.0);
+    DynamicVector<double> b = A2 * x1;
+    auto x2 = solver.solve(b);
+    error += norm(x1 - x2);
+
+    // Solvers without a setup phase
+    BiCGSTABTag tag2;
+    tag2.maximumIterations() = 100;
+    tag2.relativeResidualTolerance() = 1e-24;
+    Solver<DynamicMatrix<double,false>, BiCGSTABTag> solver2(A, tag2);
+    b = A * x1;
+    x2 = solver2.solve(b);
+    error += norm(x1 - x2);
+
+    if (error < EPSILON){
+        std::cout << " Pass test of Solver" << std::endl;
+        return EXIT_SUCCESS;
+    } else{
+        std::cout << "Fail test of Solver" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+}
@@ -0,0 +1,61 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "BlazeIterative.hpp"
+#include <iostream>
+#include <cstdlib>
+
+using namespace blaze;
+using namespace blaze::iterative;
+
+int main() {
+
+    // Fixed-size 6x6 systems solved with static types and, for reference, dynamic ones
+    StaticMatrix<double,6,6> A(0.0);
+    StaticMatrix<double,6,6> B(0.0);
+    StaticVector<double,6> b;
+    for(std::size_t i=0; i<6; ++i) {
+        A(i,i) = 4.0;
+        B(i,i) = 5.0;
+        if(i > 0) { A(i,i-1) = -1.0; B(i,i-1) = -2.0; }
+        if(i+1 < 6) { A(i,i+1) = -1.0; B(i,i+1) = 0.5; }
+        b[i] = 1.0 + 0.5*i;
+    }
+
+    ConjugateGradientTag cg_tag;
+    cg_tag.relativeResidualTolerance() = 1e-24;
+    StaticVector<double,6> x1 = solve(A, b, cg_tag);
+    double error = norm(A*x1 - b);
+
+    ConjugateGradientTag cg_reference;
+    cg_reference.relativeResidualTolerance() = 1e-24;
+    DynamicVector<double> y1 = solve(DynamicMatrix<double>(A), DynamicVector<double>(b), cg_reference);
+    error += norm(DynamicVector<double>(x1) - y1);
+
+    BiCGSTABTag bicgstab_tag;
+    bicgstab_tag.relativeResidualTolerance() = 1e-24;
+    StaticVector<double,6> x2 = solve(B, b, bicgstab_tag);
+    error += norm(B*x2 - b);
+
+    // Zero right-hand side converges immediately to zero
+    BiCGSTABTag zero_tag;
+    StaticVector<double,6> x3 = solve(B, StaticVector<double,6>(0.0), zero_tag);
+    error += norm(x3);
+
+    bool pass = cg_tag.status() == TerminationStatus::CONVERGED_RELATIVE_RESIDUAL
+                && bicgstab_tag.status() == TerminationStatus::CONVERGED_RELATIVE_RESIDUAL
+                && zero_tag.status() == TerminationStatus::CONVERGED_RELATIVE_RESIDUAL;
+
+
+    if (pass && error < EPSILON){
+        std::cout << " Pass test of StaticSolve" << std::endl;
+        return EXIT_SUCCESS;
+    } else{
+        std::cout << "Fail test of StaticSolve" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+}
@@ -0,0 +1,102 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "BlazeIterative.hpp"
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+
+using namespace blaze;
+using namespace blaze::iterative;
+
+// Assembles the matrix of a stencil operator
+template<typename Stencil, std::size_t NX, std::size_t NY, std::size_t NZ>
+CompressedMatrix<double,rowMajor> assemble()
+{
+    const std::size_t n = NX*NY*NZ;
+    CompressedMatrix<double,rowMajor> A(n, n);
+    A.reserve(27*n);
+    for(std::size_t k=0; k<NZ; ++k) {
+        for(std::size_t j=0; j<NY; ++j) {
+            for(std::size_t i=0; i<NX; ++i) {
+                const std::size_t row = i + NX*(j + NY*k);
+                for(int dz=-1; dz<=1; ++dz) {
+                    for(int dy=-1; dy<=1; ++dy) {
+                        for(int dx=-1; dx<=1; ++dx) {
+                            const long ii = long(i)+dx, jj = long(j)+dy, kk = long(k)+dz;
+                            if(ii < 0 || jj < 0 || kk < 0 || ii >= long(NX) || jj >= long(NY) || kk >= long(NZ)) {
+                                continue;
+                            }
+                            const double c = Stencil::coefficient(dx, dy, dz);
+                            if(c != 0.0) {
+                                A.append(row, std::size_t(ii + NX*(jj + NY*kk)), c);
+                            }
+                        }
+                    }
+                }
+                A.finalize(row);
+            }
+        }
+    }
+    return A;
+}
+
+template<typename Stencil, std::size_t NX, std::size_t NY, std::size_t NZ>
+double product_error()
+{
+    StencilOperator<Stencil, NX, NY, NZ> S;
+    CompressedMatrix<double,rowMajor> A = assemble<Stencil, NX, NY, NZ>();
+
+    DynamicVector<double> x(S.rows());
+    for(std::size_t i=0; i<x.size(); ++i) {
+        x[i] = std::sin(0.3*i);
+    }
+    DynamicVector<double> y;
+    multiply(y, S, x);
+
+    return norm(y - A*x);
+}
+
+int main() {
+
+    // Test the matrix-free stencil operators against their assembled matrices
+
+    double error = product_error<Poisson5Point, 9, 7, 1>()
+                   + product_error<Poisson7Point, 6, 5, 4>()
+                   + product_error<Poisson27Point, 5, 4, 3>();
+
+    // Solve with the operator and with its matrix
+    StencilOperator<Poisson7Point, 8, 6, 5> S;
+    CompressedMatrix<double,rowMajor> A = assemble<Poisson7Point, 8, 6, 5>();
+    DynamicVector<double> b(S.rows(), 1.0);
+
+    ConjugateGradientTag cg_tag;
+    cg_tag.relativeResidualTolerance() = 1e-24;
+    cg_tag.maximumIterations() = 200;
+    auto x1 = solve(S, b, cg_tag);
+    auto x2 = solve(A, b, cg_tag);
+    error += norm(x1 - x2);
+
+    GMRESTag gmres_tag;
+    gmres_tag.relativeResidualTolerance() = 1e-12;
+    gmres_tag.maximumIterations() = 500;
+    auto x3 = solve(S, b, gmres_tag);
+    error += norm(x3 - x2);
+
+    bool pass = isSymmetric(S);
+    pass &= S.nonZeros() == nonZeros(A);
+    pass &= StencilOperator<Poisson27Point, 5, 4, 3>::nonZeros() == nonZeros(assemble<Poisson27Point, 5, 4, 3>());
+
+
+    if (pass && error < EPSILON){
+        std::cout << " Pass test of StencilOperator" << std::endl;
+        return EXIT_SUCCESS;
+    } else{
+        std::cout << "Fail test of StencilOperator" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+}
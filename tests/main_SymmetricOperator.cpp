@@ -0,0 +1,103 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "BlazeIterative.hpp"
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace blaze;
+using namespace blaze::iterative;
+
+int main() {
+
+    // SPD matrix with a band and a few long-range couplings
+    const std::size_t N = 150;
+    DynamicMatrix<double,rowMajor> D(N, N, 0.0);
+    for(std::size_t i=0; i<N; ++i) {
+        D(i,i) = 6.0;
+        if(i > 0) { D(i,i-1) = -1.0; D(i-1,i) = -1.0; }
+        if(i > 9) { D(i,i-10) = -1.0; D(i-10,i) = -1.0; }
+        if(i%17 == 0 && i > 60) { D(i,i-60) = -0.5; D(i-60,i) = -0.5; }
+    }
+    CompressedMatrix<double,rowMajor> A(D);
+
+    DynamicVector<double> x(N);
+    for(std::size_t i=0; i<N; ++i) {
+        x[i] = std::sin(0.3*i);
+    }
+
+    // Products with one and with several accumulation blocks
+    DynamicVector<double> y;
+    double error = 0.0;
+    for(std::size_t threads : {1, 3, 8}) {
+        SymmetricOperator<double> S(A, threads);
+        multiply(y, S, x);
+        error += norm(y - A*x);
+        y = x;
+        multiply(y, S, y);   // in place
+        error += norm(y - A*x);
+    }
+
+    SymmetricOperator<double> S(A);
+    bool pass = S.storedEntries() == (nonZeros(A) + N)/2 && S.matrix() == A && isSymmetric(S);
+    pass &= S.nonZeros() == nonZeros(A);
+
+    // CG, preconditioned CG, Lanczos and Arnoldi with the operator and with the matrix
+    DynamicVector<double> b(N, 1.0);
+    ConjugateGradientTag cg_tag;
+    cg_tag.relativeResidualTolerance() = 1e-24;
+    cg_tag.maximumIterations() = 200;
+    auto x1 = solve(S, b, cg_tag);
+    auto x2 = solve(A, b, cg_tag);
+    error += norm(x1 - x2);
+
+    for(const std::string preconditioner : {"Jacobi", "SSOR", "incomplete_Cholesky"}) {
+        PreconditionCGTag tag;
+        tag.relativeResidualTolerance() = 1e-24;
+        tag.maximumIterations() = 200;
+        auto x3 = solve(S, b, tag, preconditioner);
+        error += norm(x3 - x2);
+    }
+
+    // One operator shared by solves running concurrently on a pool
+    SymmetricOperator<double> shared(A, 3);
+    ThreadPool pool(4);
+    std::vector<DynamicVector<double>> rhs;
+    for(std::size_t k=0; k<8; ++k) {
+        rhs.emplace_back(N, 1.0 + 0.1*k);
+    }
+    std::vector<SolveJob<SymmetricOperator<double>, ConjugateGradientTag>> jobs;
+    for(std::size_t k=0; k<rhs.size(); ++k) {
+        jobs.emplace_back(shared, rhs[k], cg_tag);
+    }
+    auto results = solve_batch(pool, jobs);
+    for(std::size_t k=0; k<rhs.size(); ++k) {
+        error += norm(results[k].get().x - (1.0 + 0.1*k)*x2);
+    }
+
+    const std::size_t n = 8;
+    LanczosTag lanczos_tag;
+    DynamicVector<double> e1 = solve(S, b, lanczos_tag, n);
+    DynamicVector<double> e2 = solve(D, b, lanczos_tag, n);
+    error += norm(e1 - e2);
+
+    ArnoldiTag arnoldi_tag;
+    DynamicVector<double> e3 = solve(S, b, arnoldi_tag, n);
+    DynamicVector<double> e4 = solve(D, b, arnoldi_tag, n);
+    error += norm(e3 - e4);
+
+
+    if (pass && error < EPSILON){
+        std::cout << " Pass test of SymmetricOperator" << std::endl;
+        return EXIT_SUCCESS;
+    } else{
+        std::cout << "Fail test of SymmetricOperator" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+}
@@ -0,0 +1,109 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "BlazeIterative.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace blaze;
+using namespace blaze::iterative;
+
+// Number of events of one solver and category
+std::size_t count(const Tracer &tracer, const std::string &solver, const std::string &category)
+{
+    std::size_t n = 0;
+    const std::vector<std::string> solvers = tracer.solvers();
+    for(const auto &event : tracer.events()) {
+        if(solvers[event.solver] == solver && category == event.category) {
+            ++n;
+        }
+    }
+    return n;
+}
+
+int main() {
+
+    const std::size_t N = 50;
+    CompressedMatrix<double,rowMajor> A(N, N);
+    A.reserve(3*N);
+    for(std::size_t i=0; i<N; ++i) {
+        if(i > 0) A.append(i, i-1, -1.0);
+        A.append(i, i, 3.0);
+        if(i+1 < N) A.append(i, i+1, -1.0);
+        A.finalize(i);
+    }
+    DynamicVector<double> b(N, 1.0);
+
+    Tracer tracer;
+
+    ConjugateGradientTag cg_tag;
+    cg_tag.tracer() = &tracer;
+    cg_tag.do_log() = true;
+    cg_tag.relativeResidualTolerance() = 1e-20;
+    cg_tag.maximumIterations() = 100;
+    auto x1 = solve(A, b, cg_tag);
+
+    GMRESTag gmres_tag;
+    gmres_tag.tracer() = &tracer;
+    gmres_tag.do_log() = true;
+    gmres_tag.restart() = 8;
+    gmres_tag.relativeResidualTolerance() = 1e-10;
+    gmres_tag.maximumIterations() = 100;
+    auto x2 = solve(A, b, gmres_tag);
+
+    // Without a tracer nothing is recorded
+    const std::size_t recorded = tracer.events().size();
+    ConjugateGradientTag untraced;
+    solve(A, b, untraced);
+
+    // CG logs the initial residual and one per iteration; GMRES one per iteration
+    const std::size_t cg_iterations = cg_tag.convergence_history().size() - 1;
+    const std::size_t gmres_iterations = gmres_tag.convergence_history().size();
+
+    bool pass = tracer.events().size() == recorded
+                && count(tracer, cg_tag.name(), "solve") == 1
+                && count(tracer, cg_tag.name(), "iteration") == cg_iterations
+                && count(tracer, cg_tag.name(), "spmv") == cg_iterations
+                && count(tracer, cg_tag.name(), "reduction") == 2*cg_iterations
+                && count(tracer, gmres_tag.name(), "solve") == 1
+                && count(tracer, gmres_tag.name(), "iteration") == gmres_iterations
+                && count(tracer, gmres_tag.name(), "orthogonalization") == gmres_iterations
+                && count(tracer, gmres_tag.name(), "restart") >= 1;
+
+    // All solves ran on the calling thread
+    for(const auto &event : tracer.events()) {
+        pass = pass && event.duration >= 0.0 && event.thread == 0;
+    }
+
+    // The written file is a Chrome trace with one line per event
+    const std::string path = "trace_test.json";
+    pass = pass && tracer.write(path);
+    std::ifstream in(path);
+    std::stringstream content;
+    content << in.rdbuf();
+    const std::string json = content.str();
+    pass = pass && json.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[") == 0
+                && json.find("\"solver\":\"Conjugate Gradient\"") != std::string::npos
+                && json.rfind("]}") != std::string::npos;
+    std::remove(path.c_str());
+
+    double error = norm(A*x1 - b) + norm(A*x2 - b);
+
+
+    if (pass && error < 1e-6){
+        std::cout << " Pass test of Trace" << std::endl;
+        return EXIT_SUCCESS;
+    } else{
+        std::cout << "Fail test of Trace" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+}
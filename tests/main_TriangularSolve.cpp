@@ -0,0 +1,136 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "BlazeIterative.hpp"
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+
+using namespace blaze;
+using namespace blaze::iterative;
+
+int main() {
+
+    // Level-scheduled triangular solves against dense triangular systems
+    const std::size_t N = 200;
+    DynamicMatrix<double,rowMajor> L(N, N, 0.0);
+    for(std::size_t i=0; i<N; ++i) {
+        L(i,i) = 3.0 + std::sin(1.0*i);
+        if(i >= 1) L(i,i-1) = -0.5;
+        if(i >= 7) L(i,i-7) = 0.25;
+        if(i >= 50) L(i,(i*37)%(i-10)) = 0.1;
+    }
+    DynamicMatrix<double,rowMajor> U = trans(L);
+
+    DynamicVector<double> b(N);
+    for(std::size_t i=0; i<N; ++i) {
+        b[i] = std::cos(0.3*i);
+    }
+
+    SparseTriangularSolver<double> lower(L, TriangularPart::LOWER);
+    SparseTriangularSolver<double> upper(U, TriangularPart::UPPER);
+    DynamicVector<double> x, y(b);
+    lower.solve(x, b);
+    upper.solve(y, y);   // in place
+
+    double error = norm(L*x - b) + norm(U*y - b);
+
+    // A diagonal matrix has a single level, a bidiagonal one a level per row
+    DynamicMatrix<double,rowMajor> B(N, N, 0.0);
+    for(std::size_t i=0; i<N; ++i) {
+        B(i,i) = 2.0;
+    }
+    SparseTriangularSolver<double> diagonal(B, TriangularPart::LOWER);
+    for(std::size_t i=1; i<N; ++i) {
+        B(i,i-1) = 1.0;
+    }
+    SparseTriangularSolver<double> bidiagonal(B, TriangularPart::LOWER);
+    bool pass = diagonal.levels() == 1 && bidiagonal.levels() == N && lower.levels() < N;
+
+    // IC(0) pattern of a 2D Laplacian: wide anti-diagonal levels, solved in parallel.
+    // Compared with plain forward and backward substitution.
+    const std::size_t nx = 200, K = nx*nx;
+    CompressedMatrix<double,rowMajor> F(K, K);
+    F.reserve(3*K);
+    for(std::size_t i=0; i<K; ++i) {
+        if(i >= nx) F.append(i, i-nx, -1.0 + 0.1*std::sin(0.1*i));
+        if(i % nx != 0) F.append(i, i-1, -1.0 + 0.1*std::cos(0.1*i));
+        F.append(i, i, 4.0 + std::sin(1.0*i));
+        F.finalize(i);
+    }
+    const CompressedMatrix<double,rowMajor> G = trans(F);
+
+    DynamicVector<double> f(K);
+    for(std::size_t i=0; i<K; ++i) {
+        f[i] = std::cos(0.01*i);
+    }
+
+    SparseTriangularSolver<double> wide_lower(F, TriangularPart::LOWER);
+    SparseTriangularSolver<double> wide_upper(G, TriangularPart::UPPER);
+    pass = pass && wide_lower.parallel() && wide_upper.parallel() && wide_lower.levels() == 2*nx - 1;
+
+    DynamicVector<double> forward, backward;
+    wide_lower.solve(forward, f);
+    wide_upper.solve(backward, f);
+
+    DynamicVector<double> forward_serial(K), backward_serial(K);
+    for(std::size_t i=0; i<K; ++i) {
+        double sum = f[i], diagonal = 1.0;
+        for(auto element = F.begin(i); element != F.end(i); ++element) {
+            if(element->index() < i) sum -= element->value() * forward_serial[element->index()];
+            else diagonal = element->value();
+        }
+        forward_serial[i] = sum / diagonal;
+    }
+    for(std::size_t i=K; i-- > 0; ) {
+        double sum = f[i], diagonal = 1.0;
+        for(auto element = G.begin(i); element != G.end(i); ++element) {
+            if(element->index() > i) sum -= element->value() * backward_serial[element->index()];
+            else diagonal = element->value();
+        }
+        backward_serial[i] = sum / diagonal;
+    }
+    error += norm(forward - forward_serial)/norm(forward_serial) + norm(backward - backward_serial)/norm(backward_serial);
+
+    // Preconditioned CG applies every preconditioner through the triangular solves
+    const std::size_t M = 40;
+    DynamicMatrix<double,rowMajor> A(M, M, 0.0);
+    for(std::size_t i=0; i<M; ++i) {
+        A(i,i) = 4.0;
+        if(i > 0) { A(i,i-1) = -1.0; A(i-1,i) = -1.0; }
+        if(i > 5) { A(i,i-6) = -0.5; A(i-6,i) = -0.5; }
+    }
+    DynamicVector<double> c(M, 1.0);
+    for(const std::string preconditioner : {"Jacobi", "Symmetric_Gauss_Seidel", "SSOR", "incomplete_Cholesky"}) {
+        PreconditionCGTag tag;
+        tag.relativeResidualTolerance() = 1e-24;
+        tag.maximumIterations() = 100;
+        auto z = solve(A, c, tag, preconditioner);
+        error += norm(A*z - c);
+    }
+
+    // LU with row exchanges: the permutation is applied after the triangular solves
+    DynamicMatrix<double,rowMajor> P(M, M, 0.0);
+    for(std::size_t i=0; i<M; ++i) {
+        P(i,i) = 0.01*(i%3);
+        P(i,(i+1)%M) = 2.0;
+        P(i,(i+5)%M) = -0.7;
+    }
+    PreconditionBiCGSTABTag bicgstab_tag;
+    bicgstab_tag.relativeResidualTolerance() = 1e-24;
+    auto w = solve(P, c, bicgstab_tag, "LU");
+    error += norm(P*w - c);
+
+
+    if (pass && error < EPSILON){
+        std::cout << " Pass test of TriangularSolve" << std::endl;
+        return EXIT_SUCCESS;
+    } else{
+        std::cout << "Fail test of TriangularSolve" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+}
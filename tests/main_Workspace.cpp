@@ -0,0 +1,117 @@
+// Copyright (c)   2017 Tyler Olsen
+//                 2018 Patrick Diehl
+//                 2019 Nanmiao Wu
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "BlazeIterative.hpp"
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+
+using namespace blaze;
+using namespace blaze::iterative;
+
+int main() {
+
+    const std::size_t N = 200;
+    CompressedMatrix<double,rowMajor> A(N, N);
+    A.reserve(3*N);
+    for(std::size_t i=0; i<N; ++i) {
+        if(i > 0) A.append(i, i-1, -1.0);
+        A.append(i, i, 3.0);
+        if(i+1 < N) A.append(i, i+1, -0.5);
+        A.finalize(i);
+    }
+    DynamicVector<double> b(N);
+    for(std::size_t i=0; i<N; ++i) {
+        b[i] = 1.0 + std::sin(0.3*i);
+    }
+
+    // The basis is rounded to float under a tight budget, so the residual is only accurate to single precision
+    const double tolerance = 1e-5;
+    double error = 0.0;
+    bool pass = true;
+
+    ConjugateGradientTag cg;
+    pass &= workspace_size(A, cg) == 3*N*sizeof(double);
+
+    PreconditionCGTag pcg;
+    pass &= workspace_size(A, pcg, "incomplete_Cholesky") > workspace_size(A, cg);
+
+    // Without a budget GMRES keeps the restart length and precision of the tag
+    GMRESTag unlimited;
+    unlimited.restart() = 30;
+    const std::size_t full = workspace_size(A, unlimited);
+    pass &= full == workspace_size(A, unlimited, 30);
+
+    // A budget the full precision basis exceeds: single precision basis, same restart length
+    GMRESTag single;
+    single.restart() = 30;
+    single.relativeResidualTolerance() = 1e-8;
+    single.maximumIterations() = 500;
+    single.memoryBudget() = full - 1;
+    GMRESTag single_precision(single);
+    single_precision.memoryBudget() = 0;
+    single_precision.basisPrecision() = BasisPrecision::SINGLE;
+    pass &= workspace_size(A, single) == workspace_size(A, single_precision);
+    auto x = solve(A, b, single);
+    error += norm(A*x - b)/norm(b);
+    pass &= single.status() == TerminationStatus::CONVERGED_RELATIVE_RESIDUAL;
+
+    // A tighter budget shortens the restart length as well
+    GMRESTag tight(single);
+    tight.memoryBudget() = full/3;
+    const std::size_t fitted = workspace_size(A, tight);
+    pass &= fitted <= tight.memoryBudget() && fitted < workspace_size(A, single);
+    auto y = solve(A, b, tight);
+    error += norm(A*y - b)/norm(b);
+    pass &= tight.status() == TerminationStatus::CONVERGED_RELATIVE_RESIDUAL;
+
+    // FGMRES only shortens the restart length
+    FGMRESTag flexible;
+    flexible.restart() = 30;
+    flexible.relativeResidualTolerance() = 1e-8;
+    flexible.maximumIterations() = 500;
+    const std::size_t flexible_full = workspace_size(A, flexible);
+    flexible.memoryBudget() = flexible_full/2;
+    pass &= workspace_size(A, flexible) <= flexible.memoryBudget();
+    auto z = solve(A, b, flexible);
+    error += norm(A*z - b)/norm(b);
+    pass &= flexible.status() == TerminationStatus::CONVERGED_RELATIVE_RESIDUAL;
+
+    // A budget not even the restart length 1 fits: no solve, x stays the initial guess
+    GMRESTag infeasible(single);
+    infeasible.memoryBudget() = 16;
+    pass &= workspace_size(A, infeasible) > infeasible.memoryBudget();
+    DynamicVector<double> guess(N, 1.0);
+    solve_inplace(guess, A, b, infeasible);
+    pass &= infeasible.status() == TerminationStatus::MEMORY_BUDGET_EXCEEDED;
+    pass &= guess == DynamicVector<double>(N, 1.0);
+
+    FGMRESTag flexible_infeasible(flexible);
+    flexible_infeasible.memoryBudget() = 16;
+    auto unsolved = solve(A, b, flexible_infeasible);
+    pass &= flexible_infeasible.status() == TerminationStatus::MEMORY_BUDGET_EXCEEDED;
+    pass &= isZero(unsolved);
+
+    // Solvers that do not adapt to the budget are checked before they allocate, e.g. the factors of PCG
+    PreconditionCGTag pcg_infeasible;
+    pcg_infeasible.memoryBudget() = workspace_size(A, pcg, "incomplete_Cholesky") - 1;
+    auto unfactorized = solve(A, b, pcg_infeasible, "incomplete_Cholesky");
+    pass &= pcg_infeasible.status() == TerminationStatus::MEMORY_BUDGET_EXCEEDED;
+    pass &= isZero(unfactorized);
+    pcg_infeasible.memoryBudget() = workspace_size(A, pcg, "incomplete_Cholesky");
+    unfactorized = solve(A, b, pcg_infeasible, "incomplete_Cholesky");
+    pass &= pcg_infeasible.status() != TerminationStatus::MEMORY_BUDGET_EXCEEDED;
+
+
+    if (pass && error < tolerance){
+        std::cout << " Pass test of Workspace" << std::endl;
+        return EXIT_SUCCESS;
+    } else{
+        std::cout << "Fail test of Workspace" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+}